@@ -27,6 +27,8 @@
 
 namespace grf {
 
+const double Data::UNIT_WEIGHT = 1.0;
+
 Data::Data(const double* data_ptr, size_t num_rows, size_t num_cols) {
   if (data_ptr == nullptr) {
     throw std::runtime_error("Invalid data storage: nullptr");
@@ -34,11 +36,31 @@ Data::Data(const double* data_ptr, size_t num_rows, size_t num_cols) {
   this->data_ptr = data_ptr;
   this->num_rows = num_rows;
   this->num_cols = num_cols;
+  this->weight = get_unit_weight_layout();
+  this->max_bins = 0;
+}
+
+Data::Data(const float* data_ptr, size_t num_rows, size_t num_cols) {
+  if (data_ptr == nullptr) {
+    throw std::runtime_error("Invalid data storage: nullptr");
+  }
+  this->data_ptr = nullptr;
+  this->float_columns.resize(num_cols);
+  for (size_t col = 0; col < num_cols; col++) {
+    float_columns[col] = data_ptr + col * num_rows;
+  }
+  this->num_rows = num_rows;
+  this->num_cols = num_cols;
+  this->weight = get_unit_weight_layout();
+  this->max_bins = 0;
 }
 
 Data::Data(const std::vector<double>& data, size_t num_rows, size_t num_cols) :
   Data(data.data(), num_rows, num_cols) {}
 
+Data::Data(const std::vector<float>& data, size_t num_rows, size_t num_cols) :
+  Data(data.data(), num_rows, num_cols) {}
+
 Data::Data(const std::pair<std::vector<double>, std::vector<size_t>>& data) :
   Data(data.first.data(), data.second.at(0), data.second.at(1)) {}
 
@@ -49,6 +71,7 @@ void Data::set_outcome_index(size_t index) {
 void Data::set_outcome_index(const std::vector<size_t>& index) {
   this->outcome_index = index;
   disallowed_split_variables.insert(index.begin(), index.end());
+  outcomes = get_row_layout(index);
 }
 
 void Data::set_treatment_index(size_t index) {
@@ -58,46 +81,213 @@ void Data::set_treatment_index(size_t index) {
 void Data::set_treatment_index(const std::vector<size_t>& index) {
   this->treatment_index = index;
   disallowed_split_variables.insert(index.begin(), index.end());
+  treatments = get_row_layout(index);
 }
 
 void Data::set_instrument_index(size_t index) {
-  this->instrument_index = index;
   disallowed_split_variables.insert(index);
+  instrument = get_row_layout({index});
 }
 
 void Data::set_weight_index(size_t index) {
   this->weight_index = index;
   disallowed_split_variables.insert(index);
+  weight = get_row_layout({index});
 }
 
 void Data::set_causal_survival_numerator_index(size_t index) {
-  this->causal_survival_numerator_index = index;
   disallowed_split_variables.insert(index);
+  causal_survival_numerator = get_row_layout({index});
 }
 
 void Data::set_causal_survival_denominator_index(size_t index) {
-  this->causal_survival_denominator_index = index;
   disallowed_split_variables.insert(index);
+  causal_survival_denominator = get_row_layout({index});
 }
 
 void Data::set_censor_index(size_t index) {
-  this->censor_index = index;
   disallowed_split_variables.insert(index);
+  censor = get_row_layout({index});
+}
+
+void Data::set_single_precision(bool single_precision) {
+  if (data_ptr == nullptr) {
+    if (!single_precision) {
+      throw std::runtime_error("Data wrapping a single precision array can not be made double precision.");
+    }
+    return;
+  }
+
+  float_data.reset();
+  float_columns.clear();
+  if (!single_precision) {
+    return;
+  }
+
+  std::vector<size_t> covariates;
+  for (size_t col = 0; col < num_cols; col++) {
+    if (disallowed_split_variables.count(col) == 0) {
+      covariates.push_back(col);
+    }
+  }
+
+  auto storage = std::make_shared<std::vector<float>>(num_rows * covariates.size());
+  float_columns.assign(num_cols, nullptr);
+  for (size_t i = 0; i < covariates.size(); i++) {
+    const double* column = data_ptr + covariates[i] * num_rows;
+    float* float_column = storage->data() + i * num_rows;
+    std::copy(column, column + num_rows, float_column);
+    float_columns[covariates[i]] = float_column;
+  }
+  float_data = std::move(storage);
+}
+
+bool Data::is_single_precision() const {
+  return !float_columns.empty();
+}
+
+void Data::set_max_bins(size_t max_bins) {
+  if (max_bins > UINT16_MAX) {
+    throw std::runtime_error("The maximum number of bins must be at most 65535.");
+  }
+  this->max_bins = max_bins;
+  bins_uint8.assign(num_cols, std::vector<uint8_t>());
+  bins_uint16.assign(num_cols, std::vector<uint16_t>());
+  bin_values.assign(num_cols, std::vector<double>());
+  if (max_bins == 0) {
+    return;
+  }
+
+  for (size_t var = 0; var < num_cols; var++) {
+    if (disallowed_split_variables.count(var) > 0) {
+      continue;
+    }
+
+    std::vector<double> values;
+    values.reserve(num_rows);
+    for (size_t row = 0; row < num_rows; row++) {
+      double value = get(row, var);
+      if (!std::isnan(value)) {
+        values.push_back(value);
+      }
+    }
+    std::sort(values.begin(), values.end());
+
+    // The upper value of each bin: every unique value if there are few enough of them,
+    // and otherwise the values at (roughly) equally spaced quantiles.
+    std::vector<double> upper_values(values);
+    upper_values.erase(std::unique(upper_values.begin(), upper_values.end()), upper_values.end());
+    if (upper_values.size() > max_bins) {
+      upper_values.clear();
+      for (size_t bin = 1; bin <= max_bins; bin++) {
+        double value = values[(bin * values.size() + max_bins - 1) / max_bins - 1];
+        if (upper_values.empty() || value > upper_values.back()) {
+          upper_values.push_back(value);
+        }
+      }
+    }
+
+    std::vector<double>& var_bin_values = bin_values[var];
+    var_bin_values.push_back(NAN);
+    var_bin_values.insert(var_bin_values.end(), upper_values.begin(), upper_values.end());
+
+    if (max_bins <= UINT8_MAX) {
+      bins_uint8[var].resize(num_rows);
+    } else {
+      bins_uint16[var].resize(num_rows);
+    }
+    for (size_t row = 0; row < num_rows; row++) {
+      double value = get(row, var);
+      size_t bin = 0;
+      if (!std::isnan(value)) {
+        bin = std::lower_bound(upper_values.begin(), upper_values.end(), value) - upper_values.begin() + 1;
+      }
+      if (max_bins <= UINT8_MAX) {
+        bins_uint8[var][row] = static_cast<uint8_t>(bin);
+      } else {
+        bins_uint16[var][row] = static_cast<uint16_t>(bin);
+      }
+    }
+  }
 }
 
 std::vector<size_t> Data::get_all_values(std::vector<double>& all_values,
                                          std::vector<size_t>& sorted_samples,
-                                         const std::vector<size_t>& samples,
+                                         SampleSpan samples,
                                          size_t var) const {
+  std::vector<size_t> index;
+  get_all_values(all_values, sorted_samples, index, samples, var);
+  return index;
+}
+
+void Data::get_all_values(std::vector<double>& all_values,
+                          std::vector<size_t>& sorted_samples,
+                          std::vector<size_t>& index,
+                          SampleSpan samples,
+                          size_t var) const {
+  sorted_samples.resize(samples.size());
+
+  if (max_bins > 0 && !bin_values[var].empty() && samples.size() < bin_values[var].size()) {
+    // Nodes with fewer samples than bins are cheaper to sort by bin than to count.
+    index.resize(samples.size());
+    std::iota(index.begin(), index.end(), 0);
+    std::stable_sort(index.begin(), index.end(), [&](const size_t& lhs, const size_t& rhs) {
+      return get_bin(samples[lhs], var) < get_bin(samples[rhs], var);
+    });
+
+    all_values.clear();
+    for (size_t i = 0; i < samples.size(); i++) {
+      sorted_samples[i] = samples[index[i]];
+      size_t bin = get_bin(sorted_samples[i], var);
+      if (i == 0 || bin != get_bin(sorted_samples[i - 1], var)) {
+        all_values.push_back(bin_values[var][bin]);
+      }
+    }
+    return;
+  }
+
+  if (max_bins > 0 && !bin_values[var].empty()) {
+    // Counting sort by bin, which keeps samples in the same bin in their original order.
+    // `index` first holds the start of each bin and `sorted_samples` the position of each
+    // sample, so the sort needs no buffer of its own.
+    const std::vector<double>& var_bin_values = bin_values[var];
+    std::vector<size_t>& bin_start = index;
+    bin_start.assign(var_bin_values.size() + 1, 0);
+    for (auto& sample : samples) {
+      ++bin_start[get_bin(sample, var) + 1];
+    }
+
+    all_values.clear();
+    for (size_t bin = 0; bin < var_bin_values.size(); bin++) {
+      if (bin_start[bin + 1] > 0) {
+        all_values.push_back(var_bin_values[bin]);
+      }
+      bin_start[bin + 1] += bin_start[bin];
+    }
+
+    std::vector<size_t>& position = sorted_samples;
+    for (size_t i = 0; i < samples.size(); i++) {
+      position[i] = bin_start[get_bin(samples[i], var)]++;
+    }
+    // There are at least as many samples as bins, so this only drops the end of bin_start.
+    index.resize(samples.size());
+    for (size_t i = 0; i < samples.size(); i++) {
+      index[position[i]] = i;
+    }
+    for (size_t i = 0; i < samples.size(); i++) {
+      sorted_samples[i] = samples[index[i]];
+    }
+    return;
+  }
+
   all_values.resize(samples.size());
   for (size_t i = 0; i < samples.size(); i++) {
     size_t sample = samples[i];
     all_values[i] = get(sample, var);
   }
 
-  sorted_samples.resize(samples.size());
-  std::vector<size_t> index(samples.size());
    // fill with [0, 1,..., samples.size() - 1]
+  index.resize(samples.size());
   std::iota(index.begin(), index.end(), 0);
   // sort index based on the split values (argsort)
   // the NaN comparison places all NaNs at the beginning
@@ -116,14 +306,46 @@ std::vector<size_t> Data::get_all_values(std::vector<double>& all_values,
   all_values.erase(unique(all_values.begin(), all_values.end(), [&](const double& lhs, const double& rhs) {
     return lhs == rhs || (std::isnan(lhs) && std::isnan(rhs));
   }), all_values.end());
-
-  return index;
 }
 
 size_t Data::get_num_cols() const {
   return num_cols;
 }
 
+Data::RowLayout Data::get_row_layout(const std::vector<size_t>& index) const {
+  RowLayout layout;
+  // A single double precision column is read in place. Several columns are copied so
+  // that the values of a row are adjacent, instead of one cache line per column apart.
+  if (index.size() == 1 && data_ptr != nullptr) {
+    layout.base = data_ptr + index[0] * num_rows;
+    layout.row_step = 1;
+    return layout;
+  }
+
+  auto copy = std::make_shared<std::vector<double>>(num_rows * index.size());
+  for (size_t row = 0; row < num_rows; row++) {
+    for (size_t j = 0; j < index.size(); j++) {
+      size_t col = index[j];
+      (*copy)[row * index.size() + j] = data_ptr != nullptr ? get_double(row, col) : get_single(row, col);
+    }
+  }
+  layout.base = copy->data();
+  layout.row_step = index.size();
+  layout.copy = std::move(copy);
+  return layout;
+}
+
+Data::RowLayout Data::get_unit_weight_layout() {
+  RowLayout layout;
+  layout.base = &UNIT_WEIGHT;
+  layout.row_step = 0;
+  return layout;
+}
+
+size_t Data::get_max_bins() const {
+  return max_bins;
+}
+
 size_t Data::get_num_rows() const {
   return num_rows;
 }
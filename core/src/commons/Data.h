@@ -20,12 +20,16 @@
 #ifndef GRF_DATA_H_
 #define GRF_DATA_H_
 
+#include <cassert>
+#include <cstdint>
+#include <memory>
 #include <set>
 #include <vector>
 
 #include "Eigen/Dense"
 #include "globals.h"
 #include "optional/optional.hpp"
+#include "SampleSpan.h"
 
 namespace grf {
 
@@ -33,16 +37,40 @@ namespace grf {
  * Data wrapper for GRF.
  * Serves as a read-only (immutable) wrapper of a column major (Fortran order)
  * array accessed through its pointer (data_ptr). This class does not own
- * data.
+ * data. The array can be double or single precision (float32); `get` always
+ * returns a double, so all accumulation is done in double precision.
  *
  * The GRF data model is a contiguous array [X, Y, z, ...] of covariates X,
  * outcomes Y, and other optional variables z.
  *
+ * `get_outcomes` and `get_treatments` return views of the outcome and treatment values
+ * of a row without allocating. If there are several outcomes (or treatments), their columns
+ * are copied once into a contiguous row major block when the index is set, and the views
+ * read the copy, so later changes to those columns of the array are not seen. A single
+ * outcome or treatment column, like the columns read by `get_instrument`, `get_weight`, etc.,
+ * is read in place, unless the data wraps a single precision array: then all of these
+ * columns are copied into double precision. The accessors do not check that the index
+ * of their variable is set, as they are called for every sample of every node: reading a
+ * variable whose index is not set is a programming error, caught by an assertion in
+ * debug builds. Without a weight index, `get_weight` reads a weight of 1 for every row.
+ *
  */
 class Data {
 public:
+  /**
+   * The values of several columns in one row.
+   */
+  typedef Eigen::Map<const Eigen::VectorXd> RowView;
+
   Data(const double* data_ptr, size_t num_rows, size_t num_cols);
 
+  /**
+   * Wraps a single precision array, so that float32 data needs no double precision
+   * copy. The covariates are read from the array directly; the outcome, treatment,
+   * weight, etc. columns are copied into double precision when their indices are set.
+   */
+  Data(const float* data_ptr, size_t num_rows, size_t num_cols);
+
   /**
    * Convenience constructors for unit test.
    * The intended use case is with storage (data vector) mananaged
@@ -52,6 +80,8 @@ public:
    */
   Data(const std::vector<double>& data, size_t num_rows, size_t num_cols);
 
+  Data(const std::vector<float>& data, size_t num_rows, size_t num_cols);
+
   Data(const std::pair<std::vector<double>, std::vector<size_t>>& data);
 
   void set_outcome_index(size_t index);
@@ -72,6 +102,35 @@ public:
 
   void set_censor_index(size_t index);
 
+  /**
+   * If true, copies the covariates into single precision (float32) storage shared by this
+   * object and its copies, and `get` reads them from there, which halves the memory traffic
+   * of split search and tree traversal. Covariate values are rounded to the nearest float.
+   * The outcomes, treatments, weights and other variables are always read in double precision.
+   *
+   * The copy sits next to the double array, so this only saves memory bandwidth, not memory.
+   * It is meant for callers that can only provide double precision data, such as the R bindings;
+   * float32 data should be wrapped with the single precision constructor instead. Data wrapping
+   * a single precision array is always single precision, and turning it off throws.
+   *
+   * Must be called after the outcome, treatment, etc. indices are set, and before `set_max_bins`.
+   */
+  void set_single_precision(bool single_precision);
+
+  bool is_single_precision() const;
+
+  /**
+   * Quantizes each covariate that can be split on into at most `max_bins` bins, stored
+   * as uint8 codes if max_bins < 256, and uint16 codes otherwise. Bin 0 holds the
+   * missing values. Every bin is represented by the largest covariate value it contains,
+   * so a split at a bin sends the same training samples left as a split at that value.
+   *
+   * Once binned, `get_all_values` sorts by bin (a linear time counting sort) and split
+   * search only considers the bin boundaries. Must be called after the outcome, treatment,
+   * etc. indices are set. A value of 0 turns binning off.
+   */
+  void set_max_bins(size_t max_bins);
+
   /**
    * Sorts and gets the unique values in `samples` at variable `var`.
    *
@@ -85,13 +144,27 @@ public:
    * have the same length.
    *
    * If any of the covariates are NaN, they will be placed first in the returned sort order.
+   *
+   * If the covariates are binned, the values are the bin values (see `get_bin_value`), and
+   * samples in the same bin keep their order in `samples`.
    */
   std::vector<size_t> get_all_values(std::vector<double>& all_values,
                                      std::vector<size_t>& sorted_samples,
-                                     const std::vector<size_t>& samples, size_t var) const;
+                                     SampleSpan samples, size_t var) const;
+
+  /**
+   * Same as above, but writes the index to `index`, so that the caller can reuse its
+   * buffers across calls.
+   */
+  void get_all_values(std::vector<double>& all_values,
+                      std::vector<size_t>& sorted_samples,
+                      std::vector<size_t>& index,
+                      SampleSpan samples, size_t var) const;
 
   size_t get_num_cols() const;
 
+  size_t get_max_bins() const;
+
   size_t get_num_rows() const;
 
   size_t get_num_outcomes() const;
@@ -102,91 +175,203 @@ public:
 
   double get_outcome(size_t row) const;
 
-  Eigen::VectorXd get_outcomes(size_t row) const;
+  RowView get_outcomes(size_t row) const;
 
   double get_treatment(size_t row) const;
 
-  Eigen::VectorXd get_treatments(size_t row) const;
+  RowView get_treatments(size_t row) const;
 
   double get_instrument(size_t row) const;
 
   double get_weight(size_t row) const;
 
+  /**
+   * Whether the data has sample weights. If not, `get_weight` is always 1.
+   */
+  bool has_weights() const;
+
   double get_causal_survival_numerator(size_t row) const;
 
   double get_causal_survival_denominator(size_t row) const;
 
   bool is_failure(size_t row) const;
 
+  /**
+   * The value of a covariate. If the data is single precision, the other variables are read
+   * in double precision, but should be read through their own accessors.
+   */
   double get(size_t row, size_t col) const;
 
+  /**
+   * The value of a covariate as seen by split search: if the covariates are binned,
+   * the value of the bin the sample falls in, and otherwise the covariate itself.
+   */
+  double get_bin_value(size_t row, size_t col) const;
+
+  /**
+   * The bin a sample falls in for a binned covariate, with 0 for missing values.
+   */
+  size_t get_bin(size_t row, size_t col) const;
+
+  /**
+   * The number of bins of a covariate (including the missing value bin), or 0 if it is not binned.
+   */
+  size_t get_num_bins(size_t col) const;
+
+  /**
+   * The value representing a bin of a binned covariate: the largest value in it, or NaN for bin 0.
+   */
+  double get_bin_upper_value(size_t col, size_t bin) const;
+
 private:
+  /**
+   * Where the values of `index` are found for each row: `base[row * row_step + j]` holds
+   * column index[j].
+   */
+  struct RowLayout {
+    const double* base = nullptr;
+    size_t row_step = 0;
+    // The row major copy of the columns, unless a single column is read in place.
+    std::shared_ptr<const std::vector<double>> copy;
+  };
+
+  RowLayout get_row_layout(const std::vector<size_t>& index) const;
+
+  /**
+   * The layout of the weights of data without a weight index: every row reads UNIT_WEIGHT.
+   */
+  static RowLayout get_unit_weight_layout();
+
+  static const double UNIT_WEIGHT;
+
+  double get_double(size_t row, size_t col) const;
+
+  double get_single(size_t row, size_t col) const;
+
+  // The double precision array, or nullptr if the data wraps a single precision array.
   const double* data_ptr;
+  // The copy of the covariates made by `set_single_precision` (nullptr otherwise), and where
+  // each column starts in the single precision array or copy (nullptr for columns without one,
+  // which are read from the double precision array). Empty if the data is double precision.
+  std::shared_ptr<const std::vector<float>> float_data;
+  std::vector<const float*> float_columns;
   size_t num_rows;
   size_t num_cols;
 
   std::set<size_t> disallowed_split_variables;
   nonstd::optional<std::vector<size_t>> outcome_index;
   nonstd::optional<std::vector<size_t>> treatment_index;
-  nonstd::optional<size_t> instrument_index;
   nonstd::optional<size_t> weight_index;
-  nonstd::optional<size_t> causal_survival_numerator_index;
-  nonstd::optional<size_t> causal_survival_denominator_index;
-  nonstd::optional<size_t> censor_index;
+
+  RowLayout outcomes;
+  RowLayout treatments;
+  RowLayout instrument;
+  RowLayout weight;
+  RowLayout causal_survival_numerator;
+  RowLayout causal_survival_denominator;
+  RowLayout censor;
+
+  size_t max_bins;
+  // The bin codes of each binned covariate (column major, empty for other columns).
+  std::vector<std::vector<uint8_t>> bins_uint8;
+  std::vector<std::vector<uint16_t>> bins_uint16;
+  // The value of each bin, with NaN for the missing value bin 0.
+  std::vector<std::vector<double>> bin_values;
 };
 
 // inline appropriate getters
 inline double Data::get_outcome(size_t row) const {
-  return get(row, outcome_index.value()[0]);
+  assert(outcomes.base != nullptr && "The outcome index of the data is not set.");
+  return outcomes.base[row * outcomes.row_step];
 }
 
-inline Eigen::VectorXd Data::get_outcomes(size_t row) const {
-  Eigen::VectorXd out(outcome_index.value().size());
-  for (size_t i = 0; i < outcome_index.value().size(); i++) {
-    out(i) = get(row, outcome_index.value()[i]);
-  }
-  return out;
+inline Data::RowView Data::get_outcomes(size_t row) const {
+  assert(outcomes.base != nullptr && "The outcome index of the data is not set.");
+  return RowView(outcomes.base + row * outcomes.row_step, outcome_index.value().size());
 }
 
 inline double Data::get_treatment(size_t row) const {
-  return get(row, treatment_index.value()[0]);
+  assert(treatments.base != nullptr && "The treatment index of the data is not set.");
+  return treatments.base[row * treatments.row_step];
 }
 
-inline Eigen::VectorXd Data::get_treatments(size_t row) const {
-  Eigen::VectorXd out(treatment_index.value().size());
-  for (size_t i = 0; i < treatment_index.value().size(); i++) {
-    out(i) = get(row, treatment_index.value()[i]);
-  }
-  return out;
+inline Data::RowView Data::get_treatments(size_t row) const {
+  assert(treatments.base != nullptr && "The treatment index of the data is not set.");
+  return RowView(treatments.base + row * treatments.row_step, treatment_index.value().size());
 }
 
 inline double Data::get_instrument(size_t row) const {
-  return get(row, instrument_index.value());
+  assert(instrument.base != nullptr && "The instrument index of the data is not set.");
+  return instrument.base[row * instrument.row_step];
 }
 
 inline double Data::get_weight(size_t row) const {
-  if (weight_index.has_value()) {
-    return get(row, weight_index.value());
-  } else {
-    return 1.0;
-  }
+  return weight.base[row * weight.row_step];
+}
+
+inline bool Data::has_weights() const {
+  return weight_index.has_value();
 }
 
 inline double Data::get_causal_survival_numerator(size_t row) const {
-  return get(row, causal_survival_numerator_index.value());
+  assert(causal_survival_numerator.base != nullptr && "The causal survival numerator index of the data is not set.");
+  return causal_survival_numerator.base[row * causal_survival_numerator.row_step];
 }
 
 inline double Data::get_causal_survival_denominator(size_t row) const {
-  return get(row, causal_survival_denominator_index.value());
+  assert(causal_survival_denominator.base != nullptr && "The causal survival denominator index of the data is not set.");
+  return causal_survival_denominator.base[row * causal_survival_denominator.row_step];
 }
 
 inline bool Data::is_failure(size_t row) const {
-  return get(row, censor_index.value()) > 0.0;
+  assert(censor.base != nullptr && "The censor index of the data is not set.");
+  return censor.base[row * censor.row_step] > 0.0;
 }
 
 inline double Data::get(size_t row, size_t col) const {
+  if (float_columns.empty()) {
+    return data_ptr[col * num_rows + row];
+  }
+  return get_single(row, col);
+}
+
+inline double Data::get_double(size_t row, size_t col) const {
   return data_ptr[col * num_rows + row];
 }
 
+inline double Data::get_single(size_t row, size_t col) const {
+  const float* column = float_columns[col];
+  if (column == nullptr) {
+    return get_double(row, col);
+  }
+  return column[row];
+}
+
+inline double Data::get_bin_value(size_t row, size_t col) const {
+  if (max_bins == 0 || bin_values[col].empty()) {
+    return get(row, col);
+  }
+  return bin_values[col][get_bin(row, col)];
+}
+
+inline size_t Data::get_bin(size_t row, size_t col) const {
+  if (max_bins <= UINT8_MAX) {
+    return bins_uint8[col][row];
+  } else {
+    return bins_uint16[col][row];
+  }
+}
+
+inline size_t Data::get_num_bins(size_t col) const {
+  if (max_bins == 0) {
+    return 0;
+  }
+  return bin_values[col].size();
+}
+
+inline double Data::get_bin_upper_value(size_t col, size_t bin) const {
+  return bin_values[col][bin];
+}
+
 } // namespace grf
 #endif /* GRF_DATA_H_ */
@@ -0,0 +1,57 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include "NodeSamples.h"
+
+namespace grf {
+
+NodeSamples::NodeSamples() {}
+
+NodeSamples::NodeSamples(const std::vector<std::vector<size_t>>& samples_by_node) {
+  for (auto& node_samples : samples_by_node) {
+    node_begin.push_back(samples.size());
+    samples.insert(samples.end(), node_samples.begin(), node_samples.end());
+    node_end.push_back(samples.size());
+  }
+  buffer.resize(samples.size());
+}
+
+void NodeSamples::set_root_samples(const std::vector<size_t>& samples) {
+  this->samples = samples;
+  node_begin.assign(1, 0);
+  node_end.assign(1, samples.size());
+  buffer.resize(samples.size());
+}
+
+size_t NodeSamples::add_node() {
+  node_begin.push_back(0);
+  node_end.push_back(0);
+  return node_begin.size() - 1;
+}
+
+std::vector<std::vector<size_t>> NodeSamples::get_samples_by_node() const {
+  std::vector<std::vector<size_t>> samples_by_node(size());
+  for (size_t node = 0; node < size(); node++) {
+    SampleSpan node_samples = (*this)[node];
+    samples_by_node[node].assign(node_samples.begin(), node_samples.end());
+  }
+  return samples_by_node;
+}
+
+} // namespace grf
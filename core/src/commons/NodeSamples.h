@@ -0,0 +1,134 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_NODESAMPLES_H_
+#define GRF_NODESAMPLES_H_
+
+#include <algorithm>
+#include <vector>
+
+#include "globals.h"
+#include "SampleSpan.h"
+
+namespace grf {
+
+/**
+ * The samples of every node of a tree being grown, stored in one buffer per tree.
+ *
+ * Each node holds a [begin, end) range of the buffer. Splitting a node partitions its
+ * range in place into the ranges of its two children, so growing a tree does not
+ * allocate per node and the samples of a node are contiguous in memory. The partition
+ * is stable: each child keeps the relative order its samples had in the parent.
+ */
+class NodeSamples {
+public:
+  NodeSamples();
+
+  /**
+   * The samples of every node given as one vector per node, for unit tests.
+   */
+  NodeSamples(const std::vector<std::vector<size_t>>& samples_by_node);
+
+  /**
+   * Sets the samples of the root node (node 0), and removes all other nodes.
+   */
+  void set_root_samples(const std::vector<size_t>& samples);
+
+  /**
+   * Adds a node without samples and returns its ID.
+   */
+  size_t add_node();
+
+  /**
+   * Moves the samples of `node` into its children, the ones for which `goes_left`
+   * returns true to `left_child` and the others to `right_child`. Afterwards `node`
+   * has no samples.
+   */
+  template <typename F>
+  void split_node(size_t node,
+                  size_t left_child,
+                  size_t right_child,
+                  F goes_left);
+
+  /**
+   * Removes the samples of a node.
+   */
+  void clear(size_t node);
+
+  SampleSpan operator[](size_t node) const;
+
+  /**
+   * The number of nodes.
+   */
+  size_t size() const;
+
+  /**
+   * The samples of every node as one vector per node.
+   */
+  std::vector<std::vector<size_t>> get_samples_by_node() const;
+
+private:
+  std::vector<size_t> samples;
+  std::vector<size_t> node_begin;
+  std::vector<size_t> node_end;
+  // Holds the samples of a right child while a node is partitioned.
+  std::vector<size_t> buffer;
+};
+
+template <typename F>
+void NodeSamples::split_node(size_t node,
+                             size_t left_child,
+                             size_t right_child,
+                             F goes_left) {
+  size_t begin = node_begin[node];
+  size_t end = node_end[node];
+  size_t num_left = begin;
+  size_t num_right = 0;
+  for (size_t i = begin; i < end; i++) {
+    size_t sample = samples[i];
+    if (goes_left(sample)) {
+      samples[num_left++] = sample;
+    } else {
+      buffer[num_right++] = sample;
+    }
+  }
+  std::copy(buffer.begin(), buffer.begin() + num_right, samples.begin() + num_left);
+
+  node_begin[left_child] = begin;
+  node_end[left_child] = num_left;
+  node_begin[right_child] = num_left;
+  node_end[right_child] = end;
+  clear(node);
+}
+
+inline void NodeSamples::clear(size_t node) {
+  node_end[node] = node_begin[node];
+}
+
+inline SampleSpan NodeSamples::operator[](size_t node) const {
+  return SampleSpan(samples.data() + node_begin[node], samples.data() + node_end[node]);
+}
+
+inline size_t NodeSamples::size() const {
+  return node_begin.size();
+}
+
+} // namespace grf
+
+#endif /* GRF_NODESAMPLES_H_ */
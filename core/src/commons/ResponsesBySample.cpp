@@ -0,0 +1,49 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <numeric>
+
+#include "ResponsesBySample.h"
+
+namespace grf {
+
+ResponsesBySample::ResponsesBySample(size_t num_rows, size_t response_length) :
+    values(num_rows, response_length),
+    position(num_rows) {
+  std::iota(position.begin(), position.end(), 0);
+}
+
+ResponsesBySample::ResponsesBySample(const std::vector<size_t>& samples,
+                                     size_t num_rows,
+                                     size_t response_length) :
+    values(samples.size(), response_length),
+    position(num_rows) {
+  reset(samples);
+}
+
+void ResponsesBySample::reset(const std::vector<size_t>& samples) {
+  if (static_cast<size_t>(values.rows()) < samples.size()) {
+    values.resize(samples.size(), values.cols());
+  }
+  for (size_t i = 0; i < samples.size(); i++) {
+    position[samples[i]] = static_cast<uint32_t>(i);
+  }
+}
+
+} // namespace grf
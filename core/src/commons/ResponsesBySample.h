@@ -0,0 +1,93 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_RESPONSESBYSAMPLE_H_
+#define GRF_RESPONSESBYSAMPLE_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "Eigen/Dense"
+#include "globals.h"
+
+namespace grf {
+
+/**
+ * The relabeled responses of the samples a tree is grown on, `response_length`
+ * values per sample, read and written by sample ID.
+ *
+ * Only the rows of the tree's samples are stored, in one row major array, and a
+ * sample ID is mapped to its row through a 32-bit index over the data, which holds
+ * fewer than 2^32 samples (see ForestTrainer::train). A tree is grown on a fraction
+ * of the data, so this takes much less memory than an array with a row for every
+ * sample when the responses are vectors.
+ */
+class ResponsesBySample {
+public:
+  typedef Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> Values;
+
+  /**
+   * Responses for every sample of the data, for unit tests.
+   */
+  ResponsesBySample(size_t num_rows, size_t response_length);
+
+  /**
+   * Responses for the given samples only.
+   */
+  ResponsesBySample(const std::vector<size_t>& samples, size_t num_rows, size_t response_length);
+
+  /**
+   * Reuses this object for another set of samples of the same data. The storage only
+   * grows if there are more samples than it has rows.
+   */
+  void reset(const std::vector<size_t>& samples);
+
+  double& operator()(size_t sample, size_t j);
+
+  double operator()(size_t sample, size_t j) const;
+
+  Values::RowXpr row(size_t sample);
+
+  Values::ConstRowXpr row(size_t sample) const;
+
+private:
+  Values values;
+  // The row in `values` of each sample ID.
+  std::vector<uint32_t> position;
+};
+
+inline double& ResponsesBySample::operator()(size_t sample, size_t j) {
+  return values(position[sample], j);
+}
+
+inline double ResponsesBySample::operator()(size_t sample, size_t j) const {
+  return values(position[sample], j);
+}
+
+inline ResponsesBySample::Values::RowXpr ResponsesBySample::row(size_t sample) {
+  return values.row(position[sample]);
+}
+
+inline ResponsesBySample::Values::ConstRowXpr ResponsesBySample::row(size_t sample) const {
+  return values.row(position[sample]);
+}
+
+} // namespace grf
+
+#endif /* GRF_RESPONSESBYSAMPLE_H_ */
@@ -0,0 +1,66 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_SAMPLESPAN_H_
+#define GRF_SAMPLESPAN_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace grf {
+
+/**
+ * A read-only view of a contiguous range of sample IDs, such as the samples of a
+ * node in {@link NodeSamples}. It can also be created from a vector of samples.
+ */
+template <typename T>
+class BasicSampleSpan {
+public:
+  BasicSampleSpan(const T* first, const T* last) :
+    first(first), last(last) {}
+
+  BasicSampleSpan(const std::vector<T>& samples) :
+    first(samples.data()), last(samples.data() + samples.size()) {}
+
+  size_t size() const { return last - first; }
+
+  bool empty() const { return first == last; }
+
+  size_t operator[](size_t i) const { return first[i]; }
+
+  const T* begin() const { return first; }
+
+  const T* end() const { return last; }
+
+private:
+  const T* first;
+  const T* last;
+};
+
+typedef BasicSampleSpan<size_t> SampleSpan;
+
+/**
+ * The samples of a node of a trained tree, which are stored as 32-bit IDs (see {@link LeafSamples}).
+ */
+typedef BasicSampleSpan<uint32_t> LeafSampleSpan;
+
+} // namespace grf
+
+#endif /* GRF_SAMPLESPAN_H_ */
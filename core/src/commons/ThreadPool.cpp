@@ -0,0 +1,165 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+#include "ThreadPool.h"
+
+namespace grf {
+
+namespace {
+
+// The progress of one parallel_for call. It is shared with the jobs that call posted to
+// the pool, which may only start after the call has returned.
+struct ParallelForState {
+  ParallelForState(size_t num_tasks):
+      num_tasks(num_tasks),
+      next_task(0),
+      num_done(0),
+      failed(false) {}
+
+  // Claims and runs tasks until there are none left. `run_task` is only used once a
+  // task was claimed, as it may no longer exist otherwise.
+  void run(const std::function<void(size_t, size_t)>* run_task, size_t worker) {
+    while (true) {
+      size_t task = next_task++;
+      if (task >= num_tasks) {
+        return;
+      }
+      if (!failed) {
+        try {
+          (*run_task)(task, worker);
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(mutex);
+          if (!failed) {
+            error = std::current_exception();
+            failed = true;
+          }
+        }
+      }
+      if (++num_done == num_tasks) {
+        std::lock_guard<std::mutex> lock(mutex);
+        all_done.notify_all();
+      }
+    }
+  }
+
+  size_t num_tasks;
+  std::atomic<size_t> next_task;
+  std::atomic<size_t> num_done;
+  std::atomic<bool> failed;
+  std::exception_ptr error;
+  std::mutex mutex;
+  std::condition_variable all_done;
+};
+
+} // namespace
+
+ThreadPool& ThreadPool::get_instance() {
+  static ThreadPool* instance = new ThreadPool();
+  return *instance;
+}
+
+uint ThreadPool::get_num_chunks(size_t num_items,
+                               uint num_threads) {
+  const size_t chunks_per_thread = 4;
+  size_t num_chunks = std::max<uint>(num_threads, 1) * chunks_per_thread;
+  return static_cast<uint>(std::max<size_t>(std::min(num_items, num_chunks), 1));
+}
+
+ThreadPool::ThreadPool():
+    stop(false) {}
+
+ThreadPool::~ThreadPool() {
+  shutdown();
+}
+
+void ThreadPool::parallel_for(size_t num_tasks,
+                              uint num_threads,
+                              const std::function<void(size_t task, size_t worker)>& run_task) {
+  if (num_tasks == 0) {
+    return;
+  }
+  size_t num_workers = std::min<size_t>(std::max<uint>(num_threads, 1), num_tasks);
+  std::shared_ptr<ParallelForState> state = std::make_shared<ParallelForState>(num_tasks);
+
+  if (num_workers > 1) {
+    std::lock_guard<std::mutex> lock(mutex);
+    add_threads(num_workers - 1);
+    const std::function<void(size_t, size_t)>* task_function = &run_task;
+    for (size_t worker = 1; worker < num_workers; worker++) {
+      jobs.emplace_back([state, task_function, worker] {
+        state->run(task_function, worker);
+      });
+    }
+  }
+  job_available.notify_all();
+
+  state->run(&run_task, 0);
+  {
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->all_done.wait(lock, [&] { return state->num_done == num_tasks; });
+  }
+
+  if (state->error) {
+    std::rethrow_exception(state->error);
+  }
+}
+
+void ThreadPool::shutdown() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stop = true;
+  }
+  job_available.notify_all();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+  threads.clear();
+  stop = false;
+}
+
+void ThreadPool::add_threads(size_t num_threads) {
+  while (threads.size() < num_threads) {
+    threads.emplace_back(&ThreadPool::work, this);
+  }
+}
+
+void ThreadPool::work() {
+  while (true) {
+    std::function<void()> job;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      job_available.wait(lock, [this] { return stop || !jobs.empty(); });
+      if (jobs.empty()) {
+        return;
+      }
+      job = std::move(jobs.front());
+      jobs.pop_front();
+    }
+    job();
+  }
+}
+
+} // namespace grf
@@ -0,0 +1,103 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_THREADPOOL_H_
+#define GRF_THREADPOOL_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "globals.h"
+
+namespace grf {
+
+/**
+ * A set of threads shared by forest training and prediction, started on first use
+ * and kept alive until shutdown() or program exit, so that repeated calls do not pay
+ * for creating threads.
+ *
+ * Work is submitted as a number of independent tasks. Every participating thread
+ * claims the next unclaimed task as soon as it is done with its previous one, so
+ * the threads that get cheap tasks take over the remaining work instead of idling.
+ */
+class ThreadPool {
+public:
+  /**
+   * The pool used by the forest trainers and predictors.
+   *
+   * It is deliberately never destroyed: joining threads from a static destructor can
+   * hang when the library is unloaded. A host that unloads the library should call
+   * shutdown() first.
+   */
+  static ThreadPool& get_instance();
+
+  /**
+   * The number of chunks to split `num_items` similar work items into: a few per thread,
+   * so that a thread whose chunks turn out slow is helped by the others.
+   */
+  static uint get_num_chunks(size_t num_items,
+                             uint num_threads);
+
+  ~ThreadPool();
+
+  /**
+   * Runs `run_task(task, worker)` for every task in [0, num_tasks) on up to
+   * `num_threads` threads, and returns once all tasks are done.
+   *
+   * The calling thread takes part in the work, so this also completes if all pool
+   * threads are busy. `worker` is an ID in [0, num_threads) that no two threads use
+   * at the same time during a call, and can index per-thread scratch state.
+   *
+   * If a task throws, the tasks that were not started yet are skipped and the first
+   * exception is rethrown to the caller.
+   */
+  void parallel_for(size_t num_tasks,
+                    uint num_threads,
+                    const std::function<void(size_t task, size_t worker)>& run_task);
+
+  /**
+   * Stops and joins all threads of the pool. The pool can still be used afterwards,
+   * and starts new threads when needed. Must not be called while a parallel_for call
+   * is running.
+   */
+  void shutdown();
+
+private:
+  ThreadPool();
+
+  void add_threads(size_t num_threads);
+
+  void work();
+
+  std::vector<std::thread> threads;
+  std::deque<std::function<void()>> jobs;
+  std::mutex mutex;
+  std::condition_variable job_available;
+  bool stop;
+
+  DISALLOW_COPY_AND_ASSIGN(ThreadPool);
+};
+
+} // namespace grf
+
+#endif /* GRF_THREADPOOL_H_ */
@@ -0,0 +1,168 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <functional>
+
+#include "commons/ThreadPool.h"
+#include "commons/utility.h"
+#include "forest/CausalSurvivalNuisance.h"
+#include "forest/ForestPredictors.h"
+
+namespace grf {
+
+// The most survival curve values predicted at once, per forest: 32MB.
+static const size_t MAX_VALUES_PER_RANGE = 1 << 22;
+
+// The smallest range of samples predicted at once, so that the predictions of a range
+// still keep every thread busy.
+static const size_t MIN_RANGE_SIZE = 4096;
+
+static size_t get_range_size(size_t num_failures) {
+  return std::max(MIN_RANGE_SIZE, MAX_VALUES_PER_RANGE / std::max<size_t>(num_failures, 1));
+}
+
+/**
+ * Runs `process(sample, worker)` for the samples start, ..., start + num_samples - 1,
+ * split into chunks over the thread pool. `worker` is in [0, num_threads) and can
+ * index per-thread scratch space.
+ */
+static void for_each_sample(size_t start,
+                            size_t num_samples,
+                            uint num_threads,
+                            const std::function<void(size_t, size_t)>& process) {
+  std::vector<uint> chunk_ranges;
+  split_sequence(chunk_ranges, static_cast<uint>(start), static_cast<uint>(start + num_samples - 1),
+                 ThreadPool::get_num_chunks(num_samples, num_threads));
+  size_t num_chunks = chunk_ranges.size() - 1;
+  ThreadPool::get_instance().parallel_for(num_chunks, num_threads, [&](size_t chunk, size_t worker) {
+    for (size_t sample = chunk_ranges[chunk]; sample < chunk_ranges[chunk + 1]; ++sample) {
+      process(sample, worker);
+    }
+  });
+}
+
+/**
+ * The survival curve of a prediction evaluated on the grid.
+ */
+static void curve_on_grid(const std::vector<double>& curve,
+                          const std::vector<size_t>& grid_indices,
+                          std::vector<double>& curve_on_grid) {
+  curve_on_grid.resize(grid_indices.size());
+  for (size_t t = 0; t < grid_indices.size(); ++t) {
+    curve_on_grid[t] = grid_indices[t] == 0 ? 1 : curve[grid_indices[t] - 1];
+  }
+}
+
+/**
+ * Forests that store the event counts of each leaf predict their survival curves from them;
+ * the estimates agree with the default predictor's up to floating point rounding.
+ */
+static ForestPredictor nuisance_predictor(const Forest& forest,
+                                          uint num_threads,
+                                          size_t num_failures,
+                                          int prediction_type) {
+  if (forest.has_sparse_prediction_values()) {
+    return optimized_survival_predictor(num_threads, num_failures, prediction_type);
+  }
+  return survival_predictor(num_threads, num_failures, prediction_type);
+}
+
+std::vector<double> causal_survival_expected_outcomes_oob(const Forest& forest,
+                                                          const Data& data,
+                                                          const std::vector<double>& failure_times,
+                                                          int prediction_type,
+                                                          const CausalSurvivalScores& scores,
+                                                          uint num_threads) {
+  num_threads = ForestOptions::validate_num_threads(num_threads);
+  ForestPredictor predictor = nuisance_predictor(forest, num_threads, failure_times.size(), prediction_type);
+
+  size_t num_samples = data.get_num_rows();
+  std::vector<double> expected_outcomes(num_samples);
+  size_t range_size = get_range_size(failure_times.size());
+  for (size_t start = 0; start < num_samples; start += range_size) {
+    size_t num_range_samples = std::min(range_size, num_samples - start);
+    std::vector<Prediction> predictions = predictor.predict_oob(forest, data, start, num_range_samples, false);
+    for_each_sample(start, num_range_samples, num_threads, [&](size_t sample, size_t) {
+      expected_outcomes[sample] = scores.expected_outcome(
+          predictions[sample - start].get_predictions(), failure_times);
+    });
+  }
+
+  return expected_outcomes;
+}
+
+void causal_survival_numerators_oob(const Forest& survival_forest,
+                                    const Data& survival_data,
+                                    const std::vector<double>& survival_failure_times,
+                                    const Forest& censor_forest,
+                                    const Data& censor_data,
+                                    const std::vector<double>& censor_failure_times,
+                                    int prediction_type,
+                                    const CausalSurvivalScores& scores,
+                                    const std::vector<double>& Y_hat,
+                                    const std::vector<double>& W_centered,
+                                    const std::vector<double>& censor,
+                                    const std::vector<double>& f_Y,
+                                    const std::vector<size_t>& Y_index,
+                                    uint num_threads,
+                                    std::vector<double>& numerators,
+                                    std::vector<double>& C_Y_hat) {
+  num_threads = ForestOptions::validate_num_threads(num_threads);
+  ForestPredictor survival_forest_predictor = nuisance_predictor(
+      survival_forest, num_threads, survival_failure_times.size(), prediction_type);
+  ForestPredictor censor_forest_predictor = nuisance_predictor(
+      censor_forest, num_threads, censor_failure_times.size(), prediction_type);
+  std::vector<size_t> survival_grid_indices = scores.get_grid_indices(survival_failure_times);
+  std::vector<size_t> censor_grid_indices = scores.get_grid_indices(censor_failure_times);
+
+  size_t num_samples = survival_data.get_num_rows();
+  numerators.resize(num_samples);
+  C_Y_hat.resize(num_samples);
+  size_t range_size = get_range_size(std::max(survival_failure_times.size(), censor_failure_times.size()));
+
+  // The curves of a sample on the grid and its conditional outcomes, per worker thread.
+  struct Workspace {
+    std::vector<double> survival;
+    std::vector<double> censoring;
+    std::vector<double> Q;
+  };
+  std::vector<Workspace> workspaces(num_threads);
+
+  for (size_t start = 0; start < num_samples; start += range_size) {
+    size_t num_range_samples = std::min(range_size, num_samples - start);
+    std::vector<Prediction> survival_predictions = survival_forest_predictor.predict_oob(
+        survival_forest, survival_data, start, num_range_samples, false);
+    std::vector<Prediction> censor_predictions = censor_forest_predictor.predict_oob(
+        censor_forest, censor_data, start, num_range_samples, false);
+
+    for_each_sample(start, num_range_samples, num_threads, [&](size_t sample, size_t worker) {
+      Workspace& workspace = workspaces[worker];
+      curve_on_grid(survival_predictions[sample - start].get_predictions(), survival_grid_indices, workspace.survival);
+      curve_on_grid(censor_predictions[sample - start].get_predictions(), censor_grid_indices, workspace.censoring);
+
+      numerators[sample] = scores.compute_numerator(workspace.survival, workspace.censoring, Y_hat[sample],
+                                                    W_centered[sample], censor[sample], f_Y[sample],
+                                                    Y_index[sample], workspace.Q);
+      C_Y_hat[sample] = workspace.censoring[Y_index[sample]];
+    });
+  }
+}
+
+} // namespace grf
@@ -0,0 +1,81 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_CAUSALSURVIVALNUISANCE_H
+#define GRF_CAUSALSURVIVALNUISANCE_H
+
+#include <cstddef>
+#include <vector>
+
+#include "commons/Data.h"
+#include "commons/globals.h"
+#include "forest/Forest.h"
+#include "relabeling/CausalSurvivalScores.h"
+
+namespace grf {
+
+/**
+ * The nuisance estimates of a causal survival forest, computed from the out-of-bag
+ * survival curves of the training samples. The curves are predicted a range of
+ * samples at a time and reduced to a few numbers per sample right away, so that the
+ * curves of all samples, num_samples x num_failures values, are never held in memory
+ * at once.
+ *
+ * The survival forests were trained on `data` with the event times given as indices
+ * into their `failure_times`, and are predicted with SurvivalPredictionStrategy's
+ * `prediction_type`.
+ */
+
+/**
+ * The out-of-bag estimates of E[f(T) | X] from a survival forest.
+ */
+std::vector<double> causal_survival_expected_outcomes_oob(const Forest& forest,
+                                                          const Data& data,
+                                                          const std::vector<double>& failure_times,
+                                                          int prediction_type,
+                                                          const CausalSurvivalScores& scores,
+                                                          uint num_threads);
+
+/**
+ * The score numerators of the training samples, from the out-of-bag curves of a
+ * survival forest for the event and of one for the censoring, and the censoring
+ * survival probability C(Y | X, W) of each sample at its event time.
+ *
+ * Y_index: the index in the grid of the event time of each sample.
+ */
+void causal_survival_numerators_oob(const Forest& survival_forest,
+                                    const Data& survival_data,
+                                    const std::vector<double>& survival_failure_times,
+                                    const Forest& censor_forest,
+                                    const Data& censor_data,
+                                    const std::vector<double>& censor_failure_times,
+                                    int prediction_type,
+                                    const CausalSurvivalScores& scores,
+                                    const std::vector<double>& Y_hat,
+                                    const std::vector<double>& W_centered,
+                                    const std::vector<double>& censor,
+                                    const std::vector<double>& f_Y,
+                                    const std::vector<size_t>& Y_index,
+                                    uint num_threads,
+                                    std::vector<double>& numerators,
+                                    std::vector<double>& C_Y_hat);
+
+} // namespace grf
+
+#endif //GRF_CAUSALSURVIVALNUISANCE_H
@@ -26,12 +26,14 @@ namespace grf {
 
 Forest::Forest(std::vector<std::unique_ptr<Tree>>& trees,
                size_t num_variables,
-               size_t ci_group_size) {
+               size_t ci_group_size,
+               bool single_precision) {
   this->trees.insert(this->trees.end(),
                      std::make_move_iterator(trees.begin()),
                      std::make_move_iterator(trees.end()));
   this->num_variables = num_variables;
   this->ci_group_size = ci_group_size;
+  this->single_precision = single_precision;
 }
 
 Forest::Forest(Forest&& forest) {
@@ -40,12 +42,14 @@ Forest::Forest(Forest&& forest) {
                      std::make_move_iterator(forest.trees.end()));
   this->num_variables = forest.num_variables;
   this->ci_group_size = forest.ci_group_size;
+  this->single_precision = forest.single_precision;
 }
 
 Forest Forest::merge(std::vector<Forest>& forests) {
   std::vector<std::unique_ptr<Tree>> all_trees;
   const size_t num_variables = forests.at(0).get_num_variables();
   const size_t ci_group_size = forests.at(0).get_ci_group_size();
+  const bool single_precision = forests.at(0).is_single_precision();
 
   for (auto& forest : forests) {
     auto& trees = forest.get_trees_();
@@ -56,9 +60,12 @@ Forest Forest::merge(std::vector<Forest>& forests) {
     if (forest.get_ci_group_size() != ci_group_size) {
       throw std::runtime_error("All forests being merged must have the same ci_group_size.");
     }
+    if (forest.is_single_precision() != single_precision) {
+      throw std::runtime_error("All forests being merged must have the same precision.");
+    }
   }
 
-  return Forest(all_trees, num_variables, ci_group_size);
+  return Forest(all_trees, num_variables, ci_group_size, single_precision);
 }
 
 const std::vector<std::unique_ptr<Tree>>& Forest::get_trees() const {
@@ -77,4 +84,17 @@ const size_t Forest::get_ci_group_size() const {
   return ci_group_size;
 }
 
+bool Forest::is_single_precision() const {
+  return single_precision;
+}
+
+bool Forest::has_sparse_prediction_values() const {
+  for (const std::unique_ptr<Tree>& tree : trees) {
+    if (tree->get_sparse_prediction_values().get_num_nodes() < tree->get_leaf_samples().size()) {
+      return false;
+    }
+  }
+  return true;
+}
+
 } // namespace grf
@@ -32,7 +32,8 @@ class Forest {
 public:
   Forest(std::vector<std::unique_ptr<Tree>>& trees,
          size_t num_variables,
-         size_t ci_group_size);
+         size_t ci_group_size,
+         bool single_precision = false);
 
   Forest(Forest&& forest);
 
@@ -47,6 +48,18 @@ public:
   const size_t get_num_variables() const;
   const size_t get_ci_group_size() const;
 
+  /**
+   * Whether the forest was trained on single precision covariates (see
+   * `Data::set_single_precision`). Data used with the forest must match.
+   */
+  bool is_single_precision() const;
+
+  /**
+   * Whether every tree stores sparse prediction values for each of its leaves, as trained
+   * with a prediction strategy that has them (see `OptimizedPredictionStrategy`).
+   */
+  bool has_sparse_prediction_values() const;
+
   /**
    * Merges the given forests into a single forest. The new forest
    * will contain all the trees from the smaller forests.
@@ -60,6 +73,7 @@ private:
   std::vector<std::unique_ptr<Tree>> trees;
   size_t num_variables;
   size_t ci_group_size;
+  bool single_precision;
   DISALLOW_COPY_AND_ASSIGN(Forest);
 };
 
@@ -17,6 +17,7 @@
   along with grf. If not, see <http://www.gnu.org/licenses/>.
  #-------------------------------------------------------------------------------*/
 
+#include <cstdint>
 #include <thread>
 #include <stdexcept>
 
@@ -39,13 +40,15 @@ ForestOptions::ForestOptions(uint num_trees,
                              uint random_seed,
                              bool legacy_seed,
                              const std::vector<size_t>& sample_clusters,
-                             uint samples_per_cluster):
+                             uint samples_per_cluster,
+                             uint max_bins):
     ci_group_size(ci_group_size),
     sample_fraction(sample_fraction),
     tree_options(mtry, min_node_size, honesty, honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty),
     sampling_options(samples_per_cluster, sample_clusters),
     random_seed(random_seed),
-    legacy_seed(legacy_seed) {
+    legacy_seed(legacy_seed),
+    max_bins(max_bins) {
 
   this->num_threads = validate_num_threads(num_threads);
 
@@ -57,6 +60,10 @@ ForestOptions::ForestOptions(uint num_trees,
     throw std::runtime_error("When confidence intervals are enabled, the"
         " sampling fraction must be less than 0.5.");
   }
+
+  if (max_bins > UINT16_MAX) {
+    throw std::runtime_error("The maximum number of bins must be at most 65535.");
+  }
 }
 
 uint ForestOptions::get_num_trees() const {
@@ -91,6 +98,10 @@ bool ForestOptions::get_legacy_seed() const {
   return legacy_seed;
 }
 
+uint ForestOptions::get_max_bins() const {
+  return max_bins;
+}
+
 uint ForestOptions::validate_num_threads(uint num_threads) {
   if (num_threads == DEFAULT_NUM_THREADS) {
     return std::thread::hardware_concurrency();
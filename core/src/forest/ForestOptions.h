@@ -43,7 +43,8 @@ public:
                 uint random_seed,
                 bool legacy_seed,
                 const std::vector<size_t>& sample_clusters,
-                uint samples_per_cluster);
+                uint samples_per_cluster,
+                uint max_bins = 0);
 
   static uint validate_num_threads(uint num_threads);
 
@@ -59,6 +60,12 @@ public:
   // Toggle between seed and num_threads dependence to reproduce behavior prior to grf 2.4.0.
   bool get_legacy_seed() const;
 
+  /**
+   * If non-zero, the covariates are quantized into at most this many bins
+   * before training, and splits are only searched for at bin boundaries.
+   */
+  uint get_max_bins() const;
+
 private:
   uint num_trees;
   size_t ci_group_size;
@@ -70,6 +77,7 @@ private:
   uint num_threads;
   uint random_seed;
   bool legacy_seed;
+  uint max_bins;
 };
 
 } // namespace grf
@@ -17,8 +17,10 @@
   along with grf. If not, see <http://www.gnu.org/licenses/>.
  #-------------------------------------------------------------------------------*/
 
+#include <algorithm>
 #include <stdexcept>
 
+#include "commons/ThreadPool.h"
 #include "forest/ForestPredictor.h"
 #include "prediction/collector/OptimizedPredictionCollector.h"
 #include "prediction/collector/DefaultPredictionCollector.h"
@@ -28,16 +30,18 @@ namespace grf {
 
 ForestPredictor::ForestPredictor(uint num_threads,
                                  std::unique_ptr<DefaultPredictionStrategy> strategy) :
+    num_threads(num_threads),
     tree_traverser(num_threads) {
   this->prediction_collector = std::unique_ptr<PredictionCollector>(
-        new DefaultPredictionCollector(std::move(strategy), num_threads));
+        new DefaultPredictionCollector(std::move(strategy)));
 }
 
 ForestPredictor::ForestPredictor(uint num_threads,
                                  std::unique_ptr<OptimizedPredictionStrategy> strategy) :
+    num_threads(num_threads),
     tree_traverser(num_threads) {
   this->prediction_collector = std::unique_ptr<PredictionCollector>(
-      new OptimizedPredictionCollector(std::move(strategy), num_threads));
+      new OptimizedPredictionCollector(std::move(strategy)));
 }
 
 
@@ -45,31 +49,75 @@ std::vector<Prediction> ForestPredictor::predict(const Forest& forest,
                                                  const Data& train_data,
                                                  const Data& data,
                                                  bool estimate_variance) const {
-  return predict(forest, train_data, data, estimate_variance, false);
+  return predict(forest, train_data, data, estimate_variance, false, 0, data.get_num_rows());
 }
 
 std::vector<Prediction> ForestPredictor::predict_oob(const Forest& forest,
                                                      const Data& data,
                                                      bool estimate_variance) const {
-  return predict(forest, data, data, estimate_variance, true);
+  return predict(forest, data, data, estimate_variance, true, 0, data.get_num_rows());
+}
+
+std::vector<Prediction> ForestPredictor::predict_oob(const Forest& forest,
+                                                     const Data& data,
+                                                     size_t start,
+                                                     size_t num_samples,
+                                                     bool estimate_variance) const {
+  return predict(forest, data, data, estimate_variance, true, start, num_samples);
 }
 
 std::vector<Prediction> ForestPredictor::predict(const Forest& forest,
                                                  const Data& train_data,
                                                  const Data& data,
                                                  bool estimate_variance,
-                                                 bool oob_prediction) const {
+                                                 bool oob_prediction,
+                                                 size_t start,
+                                                 size_t num_samples) const {
   if (estimate_variance && forest.get_ci_group_size() <= 1) {
     throw std::runtime_error("To estimate variance during prediction, the forest must"
        " be trained with ci_group_size greater than 1.");
   }
+  // Only `data` is passed down the trees, so the training data can have either precision.
+  if (data.is_single_precision() != forest.is_single_precision()) {
+    throw std::runtime_error("The data must have the same precision as the data the forest"
+       " was trained on (see Data::set_single_precision).");
+  }
+  if (num_samples == 0) {
+    return std::vector<Prediction>();
+  }
 
-  std::vector<std::vector<size_t>> leaf_nodes_by_tree = tree_traverser.get_leaf_nodes(forest, data, oob_prediction);
-  std::vector<std::vector<bool>> trees_by_sample = tree_traverser.get_valid_trees_by_sample(forest, data, oob_prediction);
-
-  return prediction_collector->collect_predictions(forest, train_data, data,
-      leaf_nodes_by_tree, trees_by_sample,
-      estimate_variance, oob_prediction);
+  // Samples are predicted in blocks, from finding their leaves to collecting their
+  // predictions, so that the leaf nodes of only a few blocks are in memory at any time.
+  size_t max_block_size = MAX_BLOCK_SIZE;
+  uint num_blocks = std::max(static_cast<uint>((num_samples + max_block_size - 1) / max_block_size),
+                             ThreadPool::get_num_chunks(num_samples, num_threads));
+  std::vector<uint> block_ranges;
+  split_sequence(block_ranges, static_cast<uint>(start), static_cast<uint>(start + num_samples - 1), num_blocks);
+  num_blocks = static_cast<uint>(block_ranges.size() - 1);
+
+  std::vector<std::vector<Prediction>> predictions_by_block(num_blocks);
+  std::vector<PredictionCollector::Workspace> workspaces(std::max<uint>(num_threads, 1));
+  ThreadPool::get_instance().parallel_for(num_blocks, num_threads, [&](size_t block, size_t worker) {
+    size_t start = block_ranges[block];
+    size_t block_size = block_ranges[block + 1] - start;
+    std::vector<std::vector<bool>> block_trees_by_sample = tree_traverser.get_valid_trees_by_sample(
+        forest, oob_prediction, start, block_size);
+    std::vector<std::vector<size_t>> leaf_nodes_by_tree = tree_traverser.get_leaf_nodes(
+        forest, data, oob_prediction, start, block_size);
+
+    predictions_by_block[block] = prediction_collector->collect_predictions(forest, train_data, data,
+        leaf_nodes_by_tree, block_trees_by_sample,
+        estimate_variance, oob_prediction, start, block_size, workspaces[worker]);
+  });
+
+  std::vector<Prediction> predictions;
+  predictions.reserve(num_samples);
+  for (auto& block_predictions : predictions_by_block) {
+    predictions.insert(predictions.end(),
+                       std::make_move_iterator(block_predictions.begin()),
+                       std::make_move_iterator(block_predictions.end()));
+  }
+  return predictions;
 }
 
 } // namespace grf
@@ -56,14 +56,32 @@ public:
                                       const Data& data,
                                       bool estimate_variance) const;
 
+  /**
+   * Out-of-bag predictions for the samples start, ..., start + num_samples - 1 of
+   * `data` only, so that the predictions for many samples can be consumed one range
+   * at a time instead of being held in memory all at once.
+   */
+  std::vector<Prediction> predict_oob(const Forest& forest,
+                                      const Data& data,
+                                      size_t start,
+                                      size_t num_samples,
+                                      bool estimate_variance) const;
+
 private:
   std::vector<Prediction> predict(const Forest& forest,
                                   const Data& train_data,
                                   const Data& data,
                                   bool estimate_variance,
-                                  bool oob_prediction) const;
+                                  bool oob_prediction,
+                                  size_t start,
+                                  size_t num_samples) const;
 
 private:
+  // The largest number of samples predicted together. Their leaf nodes in all trees are
+  // kept in memory at once.
+  static const size_t MAX_BLOCK_SIZE = 256;
+
+  uint num_threads;
   TreeTraverser tree_traverser;
   std::unique_ptr<PredictionCollector> prediction_collector;
 };
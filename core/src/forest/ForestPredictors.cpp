@@ -17,6 +17,7 @@
   along with grf. If not, see <http://www.gnu.org/licenses/>.
  #-------------------------------------------------------------------------------*/
 
+#include "commons/ThreadPool.h"
 #include "forest/ForestPredictors.h"
 #include "prediction/InstrumentalPredictionStrategy.h"
 #include "prediction/MultiCausalPredictionStrategy.h"
@@ -28,6 +29,11 @@
 #include "prediction/LLCausalPredictionStrategy.h"
 #include "prediction/SurvivalPredictionStrategy.h"
 #include "prediction/CausalSurvivalPredictionStrategy.h"
+#include "prediction/OptimizedQuantilePredictionStrategy.h"
+#include "prediction/OptimizedSurvivalPredictionStrategy.h"
+#include "prediction/OptimizedLocalLinearPredictionStrategy.h"
+#include "prediction/OptimizedLLCausalPredictionStrategy.h"
+#include "prediction/LocalLinearMoments.h"
 
 namespace grf {
 
@@ -50,6 +56,14 @@ ForestPredictor quantile_predictor(uint num_threads,
   return ForestPredictor(num_threads, std::move(prediction_strategy));
 }
 
+ForestPredictor optimized_quantile_predictor(uint num_threads,
+                                             const std::vector<double>& quantiles) {
+  num_threads = ForestOptions::validate_num_threads(num_threads);
+  std::unique_ptr<OptimizedPredictionStrategy> prediction_strategy(
+      new OptimizedQuantilePredictionStrategy(quantiles));
+  return ForestPredictor(num_threads, std::move(prediction_strategy));
+}
+
 ForestPredictor probability_predictor(uint num_threads, size_t num_classes) {
   num_threads = ForestOptions::validate_num_threads(num_threads);
   std::unique_ptr<OptimizedPredictionStrategy> prediction_strategy(new ProbabilityPredictionStrategy(num_classes));
@@ -68,6 +82,16 @@ ForestPredictor multi_regression_predictor(uint num_threads, size_t num_outcomes
   return ForestPredictor(num_threads, std::move(prediction_strategy));
 }
 
+RowPredictor regression_row_predictor() {
+  std::unique_ptr<OptimizedPredictionStrategy> prediction_strategy(new RegressionPredictionStrategy());
+  return RowPredictor(std::move(prediction_strategy));
+}
+
+RowPredictor multi_regression_row_predictor(size_t num_outcomes) {
+  std::unique_ptr<OptimizedPredictionStrategy> prediction_strategy(new MultiRegressionPredictionStrategy(num_outcomes));
+  return RowPredictor(std::move(prediction_strategy));
+}
+
 ForestPredictor ll_regression_predictor(uint num_threads,
                                         std::vector<double> lambdas,
                                         bool weight_penalty,
@@ -88,6 +112,53 @@ ForestPredictor ll_causal_predictor(uint num_threads,
   return ForestPredictor(num_threads, std::move(prediction_strategy));
 }
 
+ForestPredictor optimized_ll_regression_predictor(uint num_threads,
+                                                  std::vector<double> lambdas,
+                                                  bool weight_penalty,
+                                                  std::vector<size_t> linear_correction_variables) {
+  num_threads = ForestOptions::validate_num_threads(num_threads);
+  std::unique_ptr<OptimizedPredictionStrategy> prediction_strategy(
+      new OptimizedLocalLinearPredictionStrategy(lambdas, weight_penalty, linear_correction_variables));
+  return ForestPredictor(num_threads, std::move(prediction_strategy));
+}
+
+ForestPredictor optimized_ll_causal_predictor(uint num_threads,
+                                              std::vector<double> lambdas,
+                                              bool weight_penalty,
+                                              std::vector<size_t> linear_correction_variables) {
+  num_threads = ForestOptions::validate_num_threads(num_threads);
+  std::unique_ptr<OptimizedPredictionStrategy> prediction_strategy(
+      new OptimizedLLCausalPredictionStrategy(lambdas, weight_penalty, linear_correction_variables));
+  return ForestPredictor(num_threads, std::move(prediction_strategy));
+}
+
+static void precompute_ll_moments(Forest& forest,
+                                  const Data& train_data,
+                                  const LocalLinearMoments& moments,
+                                  uint num_threads) {
+  num_threads = ForestOptions::validate_num_threads(num_threads);
+  std::vector<std::unique_ptr<Tree>>& trees = forest.get_trees_();
+  ThreadPool::get_instance().parallel_for(trees.size(), num_threads, [&](size_t tree, size_t) {
+    trees[tree]->set_sparse_prediction_values(moments.compute(trees[tree]->get_leaf_samples(), train_data));
+  });
+}
+
+void precompute_ll_regression_moments(Forest& forest,
+                                      const Data& train_data,
+                                      std::vector<size_t> linear_correction_variables,
+                                      uint num_threads) {
+  LocalLinearMoments moments(linear_correction_variables, false);
+  precompute_ll_moments(forest, train_data, moments, num_threads);
+}
+
+void precompute_ll_causal_moments(Forest& forest,
+                                  const Data& train_data,
+                                  std::vector<size_t> linear_correction_variables,
+                                  uint num_threads) {
+  LocalLinearMoments moments(linear_correction_variables, true);
+  precompute_ll_moments(forest, train_data, moments, num_threads);
+}
+
 ForestPredictor survival_predictor(uint num_threads, size_t num_failures, int prediction_type) {
   num_threads = ForestOptions::validate_num_threads(num_threads);
   std::unique_ptr<DefaultPredictionStrategy> prediction_strategy(
@@ -95,6 +166,13 @@ ForestPredictor survival_predictor(uint num_threads, size_t num_failures, int pr
   return ForestPredictor(num_threads, std::move(prediction_strategy));
 }
 
+ForestPredictor optimized_survival_predictor(uint num_threads, size_t num_failures, int prediction_type) {
+  num_threads = ForestOptions::validate_num_threads(num_threads);
+  std::unique_ptr<OptimizedPredictionStrategy> prediction_strategy(
+    new OptimizedSurvivalPredictionStrategy(num_failures, prediction_type));
+  return ForestPredictor(num_threads, std::move(prediction_strategy));
+}
+
 ForestPredictor causal_survival_predictor(uint num_threads) {
   num_threads = ForestOptions::validate_num_threads(num_threads);
   std::unique_ptr<OptimizedPredictionStrategy> prediction_strategy(new CausalSurvivalPredictionStrategy());
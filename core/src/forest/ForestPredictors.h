@@ -21,6 +21,7 @@
 #define GRF_FORESTPREDICTORS_H
 
 #include "forest/ForestPredictor.h"
+#include "forest/RowPredictor.h"
 
 namespace grf {
 
@@ -31,12 +32,19 @@ ForestPredictor multi_causal_predictor(uint num_threads, size_t num_treatments,
 ForestPredictor quantile_predictor(uint num_threads,
                                    const std::vector<double>& quantiles);
 
+ForestPredictor optimized_quantile_predictor(uint num_threads,
+                                             const std::vector<double>& quantiles);
+
 ForestPredictor probability_predictor(uint num_threads, size_t num_classes);
 
 ForestPredictor regression_predictor(uint num_threads);
 
 ForestPredictor multi_regression_predictor(uint num_threads, size_t num_outcomes);
 
+RowPredictor regression_row_predictor();
+
+RowPredictor multi_regression_row_predictor(size_t num_outcomes);
+
 ForestPredictor ll_regression_predictor(uint num_threads,
                                         std::vector<double> lambdas,
                                         bool weight_penalty,
@@ -47,8 +55,38 @@ ForestPredictor ll_causal_predictor(uint num_threads,
                                    bool weight_penalty,
                                    std::vector<size_t> linear_correction_variables);
 
+ForestPredictor optimized_ll_regression_predictor(uint num_threads,
+                                                  std::vector<double> lambdas,
+                                                  bool weight_penalty,
+                                                  std::vector<size_t> linear_correction_variables);
+
+ForestPredictor optimized_ll_causal_predictor(uint num_threads,
+                                              std::vector<double> lambdas,
+                                              bool weight_penalty,
+                                              std::vector<size_t> linear_correction_variables);
+
+/**
+ * Stores the local linear moments of every leaf of `forest` as its sparse prediction
+ * values, for prediction with optimized_ll_regression_predictor and the same linear
+ * correction variables.
+ */
+void precompute_ll_regression_moments(Forest& forest,
+                                      const Data& train_data,
+                                      std::vector<size_t> linear_correction_variables,
+                                      uint num_threads);
+
+/**
+ * As precompute_ll_regression_moments, for optimized_ll_causal_predictor.
+ */
+void precompute_ll_causal_moments(Forest& forest,
+                                  const Data& train_data,
+                                  std::vector<size_t> linear_correction_variables,
+                                  uint num_threads);
+
 ForestPredictor survival_predictor(uint num_threads, size_t num_failures, int prediction_type);
 
+ForestPredictor optimized_survival_predictor(uint num_threads, size_t num_failures, int prediction_type);
+
 ForestPredictor causal_survival_predictor(uint num_threads);
 
 } // namespace grf
@@ -18,10 +18,11 @@
  #-------------------------------------------------------------------------------*/
 
 #include <algorithm>
+#include <cstdint>
 #include <ctime>
-#include <future>
 #include <stdexcept>
 
+#include "commons/ThreadPool.h"
 #include "commons/utility.h"
 #include "ForestTrainer.h"
 #include "random/random.hpp"
@@ -37,11 +38,24 @@ ForestTrainer::ForestTrainer(std::unique_ptr<RelabelingStrategy> relabeling_stra
                  std::move(prediction_strategy)) {}
 
 Forest ForestTrainer::train(const Data& data, const ForestOptions& options) const {
-  std::vector<std::unique_ptr<Tree>> trees = train_trees(data, options);
+  // Trees store their sample IDs in 32 bits (see LeafSamples and ResponsesBySample).
+  if (data.get_num_rows() > UINT32_MAX) {
+    throw std::runtime_error("The number of samples must be less than 2^32.");
+  }
+
+  std::vector<std::unique_ptr<Tree>> trees;
+  if (options.get_max_bins() > 0) {
+    // Quantize the covariates once for all trees. The copy shares the underlying data.
+    Data binned_data(data);
+    binned_data.set_max_bins(options.get_max_bins());
+    trees = train_trees(binned_data, options);
+  } else {
+    trees = train_trees(data, options);
+  }
 
   size_t num_variables = data.get_num_cols() - data.get_disallowed_split_variables().size();
   size_t ci_group_size = options.get_ci_group_size();
-  return Forest(trees, num_variables, ci_group_size);
+  return Forest(trees, num_variables, ci_group_size, data.is_single_precision());
 }
 
 std::vector<std::unique_ptr<Tree>> ForestTrainer::train_trees(const Data& data,
@@ -62,33 +76,39 @@ std::vector<std::unique_ptr<Tree>> ForestTrainer::train_trees(const Data& data,
 
   uint num_groups = static_cast<uint>(num_trees / options.get_ci_group_size());
 
-  std::vector<uint> thread_ranges;
-  split_sequence(thread_ranges, 0, num_groups - 1, options.get_num_threads());
+  uint num_threads = std::max<uint>(options.get_num_threads(), 1);
 
-  std::vector<std::future<std::vector<std::unique_ptr<Tree>>>> futures;
-  futures.reserve(thread_ranges.size());
+  // With legacy seeds, the seed of a tree depends on the batch it is trained in, so the
+  // batches are fixed to one per thread. Otherwise every CI group is a separate task,
+  // and threads that are done early take over the remaining groups.
+  std::vector<uint> batch_ranges;
+  if (options.get_legacy_seed()) {
+    split_sequence(batch_ranges, 0, num_groups - 1, num_threads);
+  } else {
+    split_sequence(batch_ranges, 0, num_groups - 1, num_groups);
+  }
+  size_t num_batches = batch_ranges.size() - 1;
+
+  std::vector<std::vector<std::unique_ptr<Tree>>> trees_by_batch(num_batches);
+  std::vector<std::unique_ptr<TreeTrainingWorkspace>> workspaces(num_threads);
+  size_t num_workers = std::min<size_t>(num_threads, num_batches);
+  size_t sorted_sample_index_max_bytes = SortedSampleIndex::get_max_bytes(data, static_cast<uint>(num_workers));
+  ThreadPool::get_instance().parallel_for(num_batches, num_threads, [&](size_t batch, size_t worker) {
+    // The trees trained by a thread are grown one after the other, so they can share scratch buffers.
+    if (workspaces[worker] == nullptr) {
+      workspaces[worker].reset(new TreeTrainingWorkspace(sorted_sample_index_max_bytes));
+    }
+    size_t start_index = batch_ranges[batch];
+    size_t num_trees_batch = batch_ranges[batch + 1] - start_index;
+    trees_by_batch[batch] = train_batch(start_index, num_trees_batch, data, options, *workspaces[worker]);
+  });
 
   std::vector<std::unique_ptr<Tree>> trees;
   trees.reserve(num_trees);
-
-  for (uint i = 0; i < thread_ranges.size() - 1; ++i) {
-    size_t start_index = thread_ranges[i];
-    size_t num_trees_batch = thread_ranges[i + 1] - start_index;
-
-    futures.push_back(std::async(std::launch::async,
-                                 &ForestTrainer::train_batch,
-                                 this,
-                                 start_index,
-                                 num_trees_batch,
-                                 std::ref(data),
-                                 options));
-  }
-
-  for (auto& future : futures) {
-    std::vector<std::unique_ptr<Tree>> thread_trees = future.get();
+  for (auto& batch_trees : trees_by_batch) {
     trees.insert(trees.end(),
-                 std::make_move_iterator(thread_trees.begin()),
-                 std::make_move_iterator(thread_trees.end()));
+                 std::make_move_iterator(batch_trees.begin()),
+                 std::make_move_iterator(batch_trees.end()));
   }
 
   return trees;
@@ -98,7 +118,8 @@ std::vector<std::unique_ptr<Tree>> ForestTrainer::train_batch(
     size_t start,
     size_t num_trees,
     const Data& data,
-    const ForestOptions& options) const {
+    const ForestOptions& options,
+    TreeTrainingWorkspace& workspace) const {
   size_t ci_group_size = options.get_ci_group_size();
 
   std::mt19937_64 random_number_generator(options.get_random_seed() + start);
@@ -116,10 +137,10 @@ std::vector<std::unique_ptr<Tree>> ForestTrainer::train_batch(
     RandomSampler sampler(tree_seed, options.get_sampling_options());
 
     if (ci_group_size == 1) {
-      std::unique_ptr<Tree> tree = train_tree(data, sampler, options);
+      std::unique_ptr<Tree> tree = train_tree(data, sampler, options, workspace);
       trees.push_back(std::move(tree));
     } else {
-      std::vector<std::unique_ptr<Tree>> group = train_ci_group(data, sampler, options);
+      std::vector<std::unique_ptr<Tree>> group = train_ci_group(data, sampler, options, workspace);
       trees.insert(trees.end(),
           std::make_move_iterator(group.begin()),
           std::make_move_iterator(group.end()));
@@ -129,15 +150,17 @@ std::vector<std::unique_ptr<Tree>> ForestTrainer::train_batch(
 }
 std::unique_ptr<Tree> ForestTrainer::train_tree(const Data& data,
                                                 RandomSampler& sampler,
-                                                const ForestOptions& options) const {
+                                                const ForestOptions& options,
+                                                TreeTrainingWorkspace& workspace) const {
   std::vector<size_t> clusters;
   sampler.sample_clusters(data.get_num_rows(), options.get_sample_fraction(), clusters);
-  return tree_trainer.train(data, sampler, clusters, options.get_tree_options());
+  return tree_trainer.train(data, sampler, clusters, options.get_tree_options(), workspace);
 }
 
 std::vector<std::unique_ptr<Tree>> ForestTrainer::train_ci_group(const Data& data,
                                                                  RandomSampler& sampler,
-                                                                 const ForestOptions& options) const {
+                                                                 const ForestOptions& options,
+                                                                 TreeTrainingWorkspace& workspace) const {
   std::vector<std::unique_ptr<Tree>> trees;
 
   std::vector<size_t> clusters;
@@ -148,7 +171,7 @@ std::vector<std::unique_ptr<Tree>> ForestTrainer::train_ci_group(const Data& dat
     std::vector<size_t> cluster_subsample;
     sampler.subsample(clusters, sample_fraction * 2, cluster_subsample);
 
-    std::unique_ptr<Tree> tree = tree_trainer.train(data, sampler, cluster_subsample, options.get_tree_options());
+    std::unique_ptr<Tree> tree = tree_trainer.train(data, sampler, cluster_subsample, options.get_tree_options(), workspace);
     trees.push_back(std::move(tree));
   }
   return trees;
@@ -50,15 +50,18 @@ private:
       size_t start,
       size_t num_trees,
       const Data& data,
-      const ForestOptions& options) const;
+      const ForestOptions& options,
+      TreeTrainingWorkspace& workspace) const;
 
   std::unique_ptr<Tree> train_tree(const Data& data,
                                    RandomSampler& sampler,
-                                   const ForestOptions& options) const;
+                                   const ForestOptions& options,
+                                   TreeTrainingWorkspace& workspace) const;
 
   std::vector<std::unique_ptr<Tree>> train_ci_group(const Data& data,
                                                     RandomSampler& sampler,
-                                                    const ForestOptions& options) const;
+                                                    const ForestOptions& options,
+                                                    TreeTrainingWorkspace& workspace) const;
 
   TreeTrainer tree_trainer;
 };
@@ -19,6 +19,8 @@
 
 #include "forest/ForestTrainers.h"
 #include "prediction/CausalSurvivalPredictionStrategy.h"
+#include "prediction/OptimizedQuantilePredictionStrategy.h"
+#include "prediction/OptimizedSurvivalPredictionStrategy.h"
 #include "prediction/InstrumentalPredictionStrategy.h"
 #include "prediction/MultiCausalPredictionStrategy.h"
 #include "prediction/RegressionPredictionStrategy.h"
@@ -81,6 +83,19 @@ ForestTrainer quantile_trainer(const std::vector<double>& quantiles) {
                        nullptr);
 }
 
+ForestTrainer optimized_quantile_trainer(const std::vector<double>& quantiles,
+                                         const std::vector<double>& outcome_grid) {
+  std::unique_ptr<RelabelingStrategy> relabeling_strategy(new QuantileRelabelingStrategy(quantiles));
+  std::unique_ptr<SplittingRuleFactory> splitting_rule_factory(
+      new ProbabilitySplittingRuleFactory(quantiles.size() + 1));
+  std::unique_ptr<OptimizedPredictionStrategy> prediction_strategy(
+      new OptimizedQuantilePredictionStrategy(quantiles, outcome_grid));
+
+  return ForestTrainer(std::move(relabeling_strategy),
+                       std::move(splitting_rule_factory),
+                       std::move(prediction_strategy));
+}
+
 ForestTrainer probability_trainer(size_t num_classes) {
   std::unique_ptr<RelabelingStrategy> relabeling_strategy(new NoopRelabelingStrategy());
   std::unique_ptr<SplittingRuleFactory> splitting_rule_factory(new ProbabilitySplittingRuleFactory(num_classes));
@@ -135,6 +150,19 @@ ForestTrainer survival_trainer(bool fast_logrank) {
                        nullptr);
 }
 
+ForestTrainer optimized_survival_trainer(bool fast_logrank,
+                                         size_t num_failures) {
+  std::unique_ptr<RelabelingStrategy> relabeling_strategy(new NoopRelabelingStrategy());
+  std::unique_ptr<SplittingRuleFactory> splitting_rule_factory(new SurvivalSplittingRuleFactory(fast_logrank));
+  // The leaf counts precomputed during training do not depend on the prediction type.
+  std::unique_ptr<OptimizedPredictionStrategy> prediction_strategy(
+    new OptimizedSurvivalPredictionStrategy(num_failures, SurvivalPredictionStrategy::KAPLAN_MEIER));
+
+  return ForestTrainer(std::move(relabeling_strategy),
+                       std::move(splitting_rule_factory),
+                       std::move(prediction_strategy));
+}
+
 ForestTrainer causal_survival_trainer(bool stabilize_splits) {
 
   std::unique_ptr<RelabelingStrategy> relabeling_strategy(new CausalSurvivalRelabelingStrategy());
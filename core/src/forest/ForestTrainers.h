@@ -34,6 +34,9 @@ ForestTrainer multi_causal_trainer(size_t num_treatments,
 
 ForestTrainer quantile_trainer(const std::vector<double>& quantiles);
 
+ForestTrainer optimized_quantile_trainer(const std::vector<double>& quantiles,
+                                         const std::vector<double>& outcome_grid = {});
+
 ForestTrainer probability_trainer(size_t num_classes);
 
 ForestTrainer regression_trainer();
@@ -48,6 +51,9 @@ ForestTrainer ll_regression_trainer(double split_lambda,
 
 ForestTrainer survival_trainer(bool fast_logrank);
 
+ForestTrainer optimized_survival_trainer(bool fast_logrank,
+                                         size_t num_failures);
+
 ForestTrainer causal_survival_trainer(bool stabilize_splits);
 
 } // namespace grf
@@ -0,0 +1,153 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#include "forest/RowPredictor.h"
+
+namespace grf {
+
+RowPredictor::RowPredictor(std::unique_ptr<OptimizedPredictionStrategy> strategy) :
+    strategy(std::move(strategy)) {}
+
+size_t RowPredictor::prediction_length() const {
+  return strategy->prediction_length();
+}
+
+void RowPredictor::predict_row(const Forest& forest,
+                               const Data& data,
+                               size_t row,
+                               double* predictions) {
+  predict_small_batch(forest, data, row, 1, predictions);
+}
+
+void RowPredictor::predict_small_batch(const Forest& forest,
+                                       const Data& data,
+                                       size_t start,
+                                       size_t num_samples,
+                                       double* predictions) {
+  if (data.is_single_precision() != forest.is_single_precision()) {
+    throw std::runtime_error("The data must have the same precision as the data the forest"
+       " was trained on (see Data::set_single_precision).");
+  }
+  if (strategy->has_sparse_prediction_values()) {
+    predict_sparse_small_batch(forest, data, start, num_samples, predictions);
+    return;
+  }
+
+  size_t num_types = strategy->prediction_value_length();
+  size_t prediction_length = strategy->prediction_length();
+
+  leaf_nodes.resize(num_samples);
+  average_values.assign(num_samples * num_types, 0.0);
+  num_leaves.assign(num_samples, 0);
+
+  // The leaf values are summed in tree order, as in ForestPredictor, so that both give
+  // the same predictions.
+  for (const std::unique_ptr<Tree>& tree : forest.get_trees()) {
+    tree->find_leaf_nodes(data, start, num_samples, leaf_nodes.data());
+    const PredictionValues& prediction_values = tree->get_prediction_values();
+    for (size_t i = 0; i < num_samples; i++) {
+      size_t node = leaf_nodes[i];
+      if (prediction_values.empty(node)) {
+        continue;
+      }
+      num_leaves[i]++;
+      for (size_t type = 0; type < num_types; type++) {
+        average_values[i * num_types + type] += prediction_values.get(node, type);
+      }
+    }
+  }
+
+  for (size_t i = 0; i < num_samples; i++) {
+    double* sample_predictions = predictions + i * prediction_length;
+    if (num_leaves[i] == 0) {
+      std::fill(sample_predictions, sample_predictions + prediction_length, NAN);
+      continue;
+    }
+
+    average_value.assign(average_values.begin() + i * num_types,
+                         average_values.begin() + (i + 1) * num_types);
+    for (double& value : average_value) {
+      value /= num_leaves[i];
+    }
+
+    std::vector<double> point_prediction = strategy->predict(average_value);
+    write_prediction(point_prediction, start + i, sample_predictions);
+  }
+}
+
+void RowPredictor::predict_sparse_small_batch(const Forest& forest,
+                                              const Data& data,
+                                              size_t start,
+                                              size_t num_samples,
+                                              double* predictions) {
+  size_t prediction_length = strategy->prediction_length();
+
+  leaf_nodes.resize(num_samples);
+  leaf_entries.resize(num_samples);
+  for (std::vector<SparseEntries>& sample_leaf_entries : leaf_entries) {
+    sample_leaf_entries.clear();
+  }
+
+  for (const std::unique_ptr<Tree>& tree : forest.get_trees()) {
+    tree->find_leaf_nodes(data, start, num_samples, leaf_nodes.data());
+    const SparsePredictionValues& prediction_values = tree->get_sparse_prediction_values();
+    if (prediction_values.get_num_nodes() < tree->get_leaf_samples().size()) {
+      throw std::runtime_error("The trees of the forest do not have sparse prediction values:"
+        " the forest must be trained with the prediction strategy it predicts with.");
+    }
+    for (size_t i = 0; i < num_samples; i++) {
+      size_t node = leaf_nodes[i];
+      if (!prediction_values.empty(node)) {
+        leaf_entries[i].push_back(prediction_values.get_entries(node));
+      }
+    }
+  }
+
+  for (size_t i = 0; i < num_samples; i++) {
+    double* sample_predictions = predictions + i * prediction_length;
+    if (leaf_entries[i].empty()) {
+      std::fill(sample_predictions, sample_predictions + prediction_length, NAN);
+      continue;
+    }
+    std::vector<double> point_prediction = strategy->predict_sparse_sample(start + i, leaf_entries[i], data, workspace);
+    write_prediction(point_prediction, start + i, sample_predictions);
+  }
+}
+
+void RowPredictor::write_prediction(const std::vector<double>& point_prediction,
+                                    size_t sample,
+                                    double* sample_predictions) const {
+  size_t prediction_length = strategy->prediction_length();
+  if (point_prediction.empty()) {
+    std::fill(sample_predictions, sample_predictions + prediction_length, NAN);
+    return;
+  }
+  if (point_prediction.size() != prediction_length) {
+    throw std::runtime_error("Prediction for sample " + std::to_string(sample) +
+                             " did not have the expected length.");
+  }
+  std::copy(point_prediction.begin(), point_prediction.end(), sample_predictions);
+}
+
+} // namespace grf
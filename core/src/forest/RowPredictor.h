@@ -0,0 +1,101 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_ROWPREDICTOR_H
+#define GRF_ROWPREDICTOR_H
+
+#include <memory>
+#include <vector>
+
+#include "commons/Data.h"
+#include "forest/Forest.h"
+#include "prediction/OptimizedPredictionStrategy.h"
+
+namespace grf {
+
+/**
+ * Predicts one or a few samples with low latency, for forests trained with an
+ * optimized prediction strategy.
+ *
+ * Unlike ForestPredictor, all work happens on the calling thread, no variance or
+ * error estimates are computed, and predictions are written to a buffer provided by
+ * the caller. The scratch space is kept between calls, so that repeated predictions
+ * of the same number of samples do not allocate apart from the strategy's own
+ * `predict`. A RowPredictor must therefore not be used by several threads at once.
+ */
+class RowPredictor {
+public:
+  RowPredictor(std::unique_ptr<OptimizedPredictionStrategy> strategy);
+
+  /**
+   * The number of values written for each predicted sample.
+   */
+  size_t prediction_length() const;
+
+  /**
+   * Predicts sample `row` of `data`, and writes prediction_length() values to
+   * `predictions`. A sample without any non-empty leaf, or for which the
+   * strategy gives an empty prediction, is predicted as NaN.
+   */
+  void predict_row(const Forest& forest,
+                   const Data& data,
+                   size_t row,
+                   double* predictions);
+
+  /**
+   * Predicts the samples start, ..., start + num_samples - 1 of `data`, and writes the
+   * prediction_length() values of sample start + i to predictions[i * prediction_length()].
+   */
+  void predict_small_batch(const Forest& forest,
+                           const Data& data,
+                           size_t start,
+                           size_t num_samples,
+                           double* predictions);
+
+private:
+  /**
+   * predict_small_batch for a strategy with sparse prediction values, which predicts each
+   * sample from the entries of its leaves.
+   */
+  void predict_sparse_small_batch(const Forest& forest,
+                                  const Data& data,
+                                  size_t start,
+                                  size_t num_samples,
+                                  double* predictions);
+
+  /**
+   * Copies the prediction of `sample` to `sample_predictions`, or NaN if it is empty.
+   */
+  void write_prediction(const std::vector<double>& point_prediction,
+                        size_t sample,
+                        double* sample_predictions) const;
+
+  std::unique_ptr<OptimizedPredictionStrategy> strategy;
+
+  std::vector<size_t> leaf_nodes;
+  std::vector<double> average_values;
+  std::vector<size_t> num_leaves;
+  std::vector<double> average_value;
+  std::vector<std::vector<SparseEntries>> leaf_entries;
+  SparsePredictionWorkspace workspace;
+};
+
+} // namespace grf
+
+#endif //GRF_ROWPREDICTOR_H
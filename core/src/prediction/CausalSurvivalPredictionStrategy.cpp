@@ -67,9 +67,9 @@ std::vector<double> CausalSurvivalPredictionStrategy::compute_variance(
     for (size_t j = 0; j < ci_group_size; ++j) {
 
       size_t i = group * ci_group_size + j;
-      const std::vector<double>& leaf_value = leaf_values.get_values(i);
+      const double* leaf_value = leaf_values.get_values(i);
 
-      double psi_1 = leaf_value.at(NUMERATOR) - leaf_value.at(DENOMINATOR) * average_tau;
+      double psi_1 = leaf_value[NUMERATOR] - leaf_value[DENOMINATOR] * average_tau;
 
       psi_squared += psi_1 * psi_1;
       group_psi += psi_1;
@@ -102,11 +102,11 @@ size_t CausalSurvivalPredictionStrategy::prediction_value_length() const {
 }
 
 PredictionValues CausalSurvivalPredictionStrategy::precompute_prediction_values(
-    const std::vector<std::vector<size_t>>& leaf_samples,
+    const LeafSamples& leaf_samples,
     const Data& data) const {
   size_t num_leaves = leaf_samples.size();
 
-  std::vector<std::vector<double>> values(num_leaves);
+  PredictionValues values(num_leaves, NUM_TYPES);
 
   for (size_t i = 0; i < leaf_samples.size(); ++i) {
     size_t leaf_size = leaf_samples[i].size();
@@ -129,14 +129,13 @@ PredictionValues CausalSurvivalPredictionStrategy::precompute_prediction_values(
     if (std::abs(sum_weight) <= 1e-16) {
       continue;
     }
-    std::vector<double>& value = values[i];
-    value.resize(NUM_TYPES);
+    double* value = values.initialize_values(i);
 
     value[NUMERATOR] = numerator_sum / leaf_size;
     value[DENOMINATOR] = denominator_sum / leaf_size;
   }
 
-  return PredictionValues(values, NUM_TYPES);
+  return values;
 }
 
 std::vector<std::pair<double, double>> CausalSurvivalPredictionStrategy::compute_error(
@@ -20,7 +20,7 @@
 #ifndef GRF_DEFAULTPREDICTIONSTRATEGY_H
 #define GRF_DEFAULTPREDICTIONSTRATEGY_H
 
-#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "commons/globals.h"
@@ -51,15 +51,16 @@ public:
    * Computes a prediction for a single test sample.
    *
    * sample: the ID of the test sample.
-   * weights_by_sample: a map from neighboring sample ID, to a weight specifying
-   *     how often the sample appeared in the same leaf as the test sample. Note that
-   *     these weights are normalized and will sum to 1.
+   * weights_by_sample: pairs of neighboring sample ID and a weight specifying
+   *     how often the sample appeared in the same leaf as the test sample, in
+   *     increasing order of sample ID. Note that these weights are normalized and
+   *     will sum to 1.
    * train_data: the training data matrix.
    * data: the test data matrix. Note that in the case of OOB prediction, this could
    *     be the same as the training matrix.
    */
   virtual std::vector<double> predict(size_t sample,
-    const std::unordered_map<size_t, double>& weights_by_sample,
+    const std::vector<std::pair<size_t, double>>& weights_by_sample,
     const Data& train_data,
     const Data& data) const = 0;
 
@@ -69,9 +70,7 @@ public:
    * sample: the ID of the test sample.
    * samples_by_tree: vector of samples in the same leaf as the test point,
    *    for each tree
-   * weights_by_sampleID: a map from neighboring sample ID, to a weight specifying
-   *     how often the sample appeared in the same leaf as the test sample. Note that
-   *     these weights are normalized and will sum to 1.
+   * weights_by_sampleID: pairs of neighboring sample ID and weight, as above.
    * train_data: the training data matrix.
    * data: the test data matrix. Note that in the case of OOB prediction, this could
    *     be the same as the training matrix.
@@ -81,7 +80,7 @@ public:
   virtual std::vector<double> compute_variance(
       size_t sample,
       const std::vector<std::vector<size_t>>& samples_by_tree,
-      const std::unordered_map<size_t, double>& weights_by_sampleID,
+      const std::vector<std::pair<size_t, double>>& weights_by_sampleID,
       const Data& train_data,
       const Data& data,
       size_t ci_group_size) const = 0;
@@ -84,7 +84,19 @@ std::vector<double> InstrumentalPredictionStrategy::compute_variance(
     const std::vector<double>& average,
     const PredictionValues& leaf_values,
     size_t ci_group_size) const {
+  LeafStatisticSums sums(compute_leaf_statistic_coefficients(average), ci_group_size);
+  for (size_t n = 0; n < leaf_values.get_num_nodes(); n++) {
+    sums.add(leaf_values.empty(n) ? nullptr : leaf_values.get_values(n));
+  }
+  return compute_variance_from_sums(average, sums, ci_group_size);
+}
+
+bool InstrumentalPredictionStrategy::has_linear_variance() const {
+  return true;
+}
 
+std::vector<double> InstrumentalPredictionStrategy::compute_leaf_statistic_coefficients(
+    const std::vector<double>& average) const {
   double instrument_effect_numerator = average.at(OUTCOME_INSTRUMENT) * average.at(WEIGHT)
      - average.at(OUTCOME) * average.at(INSTRUMENT);
   double first_stage_numerator = average.at(TREATMENT_INSTRUMENT) * average.at(WEIGHT)
@@ -93,48 +105,29 @@ std::vector<double> InstrumentalPredictionStrategy::compute_variance(
   double main_effect_estimate = (average.at(OUTCOME) - average.at(TREATMENT) * treatment_effect_estimate)
      / average.at(WEIGHT);
 
-  double num_good_groups = 0;
-  double rho_squared = 0;
-  double rho_grouped_squared = 0;
-
-  for (size_t group = 0; group < leaf_values.get_num_nodes() / ci_group_size; ++group) {
-    bool good_group = true;
-    for (size_t j = 0; j < ci_group_size; ++j) {
-      if (leaf_values.empty(group * ci_group_size + j)) {
-        good_group = false;
-      }
-    }
-    if (!good_group) continue;
-
-    num_good_groups++;
-
-    double group_rho = 0;
-
-    for (size_t j = 0; j < ci_group_size; ++j) {
-
-      size_t i = group * ci_group_size + j;
-      const std::vector<double>& leaf_value = leaf_values.get_values(i);
-
-      double psi_1 = leaf_value.at(OUTCOME_INSTRUMENT)
-                     - leaf_value.at(TREATMENT_INSTRUMENT) * treatment_effect_estimate
-                     - leaf_value.at(INSTRUMENT) * main_effect_estimate;
-      double psi_2 = leaf_value.at(OUTCOME)
-                     - leaf_value.at(TREATMENT) * treatment_effect_estimate
-                     - leaf_value.at(WEIGHT) * main_effect_estimate;
-
-      double rho = (average.at(WEIGHT) * psi_1 - average.at(INSTRUMENT) * psi_2)
-          / first_stage_numerator;
-
-      rho_squared += rho * rho;
-      group_rho += rho;
-    }
-
-    group_rho /= ci_group_size;
-    rho_grouped_squared += group_rho * group_rho;
-  }
+  // rho = (average_weight * psi_1 - average_instrument * psi_2) / first_stage_numerator, where
+  // psi_1 = outcome_instrument - treatment_instrument * tau - instrument * mu, and
+  // psi_2 = outcome - treatment * tau - weight * mu.
+  double psi_1_scale = average.at(WEIGHT) / first_stage_numerator;
+  double psi_2_scale = -average.at(INSTRUMENT) / first_stage_numerator;
+
+  std::vector<double> coefficients(NUM_TYPES, 0.0);
+  coefficients[OUTCOME_INSTRUMENT] = psi_1_scale;
+  coefficients[TREATMENT_INSTRUMENT] = -psi_1_scale * treatment_effect_estimate;
+  coefficients[INSTRUMENT] = -psi_1_scale * main_effect_estimate;
+  coefficients[OUTCOME] = psi_2_scale;
+  coefficients[TREATMENT] = -psi_2_scale * treatment_effect_estimate;
+  coefficients[WEIGHT] = -psi_2_scale * main_effect_estimate;
+  return coefficients;
+}
 
-  double var_between = rho_grouped_squared / num_good_groups;
-  double var_total = rho_squared / (num_good_groups * ci_group_size);
+std::vector<double> InstrumentalPredictionStrategy::compute_variance_from_sums(
+    const std::vector<double>& average,
+    const LeafStatisticSums& sums,
+    size_t ci_group_size) const {
+  double num_good_groups = sums.get_num_good_groups();
+  double var_between = sums.get_rho_grouped_squared() / num_good_groups;
+  double var_total = sums.get_rho_squared() / (num_good_groups * ci_group_size);
 
   // This is the amount by which var_between is inflated due to using small groups
   double group_noise = (var_total - var_between) / (ci_group_size - 1);
@@ -153,11 +146,11 @@ size_t InstrumentalPredictionStrategy::prediction_value_length() const {
 }
 
 PredictionValues InstrumentalPredictionStrategy::precompute_prediction_values(
-    const std::vector<std::vector<size_t>>& leaf_samples,
+    const LeafSamples& leaf_samples,
     const Data& data) const {
   size_t num_leaves = leaf_samples.size();
 
-  std::vector<std::vector<double>> values(num_leaves);
+  PredictionValues values(num_leaves, NUM_TYPES);
 
   for (size_t i = 0; i < leaf_samples.size(); ++i) {
     size_t leaf_size = leaf_samples[i].size();
@@ -188,8 +181,7 @@ PredictionValues InstrumentalPredictionStrategy::precompute_prediction_values(
     if (std::abs(sum_weight) <= 1e-16) {
       continue;
     }
-    std::vector<double>& value = values[i];
-    value.resize(NUM_TYPES);
+    double* value = values.initialize_values(i);
 
     value[OUTCOME] = sum_Y / leaf_size;
     value[TREATMENT] = sum_W / leaf_size;
@@ -200,7 +192,7 @@ PredictionValues InstrumentalPredictionStrategy::precompute_prediction_values(
     value[WEIGHT] = sum_weight / leaf_size;
   }
 
-  return PredictionValues(values, NUM_TYPES);
+  return values;
 }
 
 std::vector<std::pair<double, double>> InstrumentalPredictionStrategy::compute_error(
@@ -246,12 +238,12 @@ std::vector<std::pair<double, double>> InstrumentalPredictionStrategy::compute_e
     if (leaf_values.empty(n)) {
       continue;
     }
-    const std::vector<double>& leaf_value = leaf_values.get_values(n);
-    double weight_loto = (num_trees * average.at(WEIGHT) - leaf_value.at(WEIGHT)) / (num_trees - 1);
-    double outcome_loto = (num_trees * average.at(OUTCOME) - leaf_value.at(OUTCOME)) / (num_trees - 1);
-    double instrument_loto = (num_trees * average.at(INSTRUMENT) - leaf_value.at(INSTRUMENT)) / (num_trees - 1);
-    double outcome_instrument_loto = (num_trees * average.at(OUTCOME_INSTRUMENT) - leaf_value.at(OUTCOME_INSTRUMENT)) / (num_trees - 1);
-    double instrument_instrument_loto = (num_trees * average.at(INSTRUMENT_INSTRUMENT) - leaf_value.at(INSTRUMENT_INSTRUMENT)) / (num_trees - 1);
+    const double* leaf_value = leaf_values.get_values(n);
+    double weight_loto = (num_trees * average.at(WEIGHT) - leaf_value[WEIGHT]) / (num_trees - 1);
+    double outcome_loto = (num_trees * average.at(OUTCOME) - leaf_value[OUTCOME]) / (num_trees - 1);
+    double instrument_loto = (num_trees * average.at(INSTRUMENT) - leaf_value[INSTRUMENT]) / (num_trees - 1);
+    double outcome_instrument_loto = (num_trees * average.at(OUTCOME_INSTRUMENT) - leaf_value[OUTCOME_INSTRUMENT]) / (num_trees - 1);
+    double instrument_instrument_loto = (num_trees * average.at(INSTRUMENT_INSTRUMENT) - leaf_value[INSTRUMENT_INSTRUMENT]) / (num_trees - 1);
 
     double reduced_form_numerator_loto = outcome_instrument_loto * weight_loto - outcome_loto * instrument_loto;
     double reduced_form_denominator_loto = instrument_instrument_loto * weight_loto - instrument_loto * instrument_loto;
@@ -44,7 +44,7 @@ public:
 
   size_t prediction_value_length() const;
   PredictionValues precompute_prediction_values(
-      const std::vector<std::vector<size_t>>& leaf_samples,
+      const LeafSamples& leaf_samples,
       const Data& data) const;
 
   size_t prediction_length() const;
@@ -55,6 +55,14 @@ public:
                           const PredictionValues& leaf_values,
                           size_t ci_group_size) const;
 
+  bool has_linear_variance() const;
+
+  std::vector<double> compute_leaf_statistic_coefficients(const std::vector<double>& average) const;
+
+  std::vector<double> compute_variance_from_sums(const std::vector<double>& average,
+                                                 const LeafStatisticSums& sums,
+                                                 size_t ci_group_size) const;
+
   std::vector<std::pair<double, double>> compute_error(
       size_t sample,
       const std::vector<double>& average,
@@ -22,6 +22,7 @@
 #include "commons/utility.h"
 #include "commons/Data.h"
 #include "prediction/LLCausalPredictionStrategy.h"
+#include "prediction/LocalLinearRidgeSolver.h"
 
 namespace grf {
 
@@ -39,7 +40,7 @@ size_t LLCausalPredictionStrategy::prediction_length() const {
 
 std::vector<double> LLCausalPredictionStrategy::predict(
         size_t sampleID,
-        const std::unordered_map<size_t, double>& weights_by_sampleID,
+        const std::vector<std::pair<size_t, double>>& weights_by_sampleID,
         const Data& train_data,
         const Data& test_data) const {
 
@@ -47,7 +48,6 @@ std::vector<double> LLCausalPredictionStrategy::predict(
   size_t num_variables = linear_correction_variables.size();
 
   size_t num_nonzero_weights = weights_by_sampleID.size();
-  size_t num_lambdas = lambdas.size();
 
   // Creating a vector of neighbor weights weights
   // Weights by sample ID contains pairs [sample ID, weight for test point]
@@ -110,44 +110,38 @@ std::vector<double> LLCausalPredictionStrategy::predict(
   // find ridge regression predictions
   Eigen::MatrixXd M_unpenalized (dim_X, dim_X);
   M_unpenalized.noalias() = X.transpose() * weights_vec.asDiagonal() * X;
+  Eigen::MatrixXd XtWY = X.transpose()*weights_vec.asDiagonal()*Y;
 
-  std::vector<double> predictions(num_lambdas);
-  Eigen::MatrixXd M;
-
-  for (size_t i = 0; i < num_lambdas; ++i){
-    double lambda = lambdas[i];
-    M = M_unpenalized;
-    if (!weight_penalty) {
-      double normalization = M_unpenalized.trace() / dim_X;
+  return ridge_predictions(M_unpenalized, XtWY);
+}
 
-      // standard ridge penalty
-      for (size_t j = 1; j < dim_X; ++j){
-        if (j != treatment_index){
-          M(j, j) += lambda * normalization;
-        }
-      }
-    } else {
-      // covariance ridge penalty
-      for (size_t j = 1; j < dim_X; ++j){
-        if (j != treatment_index){
-          M(j, j) += lambda * M(j, j);
-        }
-      }
-    }
+std::vector<double> LLCausalPredictionStrategy::ridge_predictions(const Eigen::MatrixXd& M_unpenalized,
+                                                                  const Eigen::MatrixXd& XtWY) const {
+  size_t treatment_index = linear_correction_variables.size() + 1;
+  LocalLinearRidgeSolver solver(M_unpenalized, penalized_regressors(), weight_penalty);
 
-    Eigen::MatrixXd local_coefficients = M.ldlt().solve(X.transpose()*weights_vec.asDiagonal()*Y);
+  // We're only interested in the coefficient associated with the treatment variable
+  return solver.solve_path(lambdas, XtWY, treatment_index);
+}
 
-    // We're only interested in the coefficient associated with the treatment variable
-    predictions[i] = local_coefficients(treatment_index);
+std::vector<size_t> LLCausalPredictionStrategy::penalized_regressors() const {
+  // Every regressor but the intercept and the treatment.
+  size_t num_variables = linear_correction_variables.size();
+  size_t dim_X = 2 * num_variables + 2;
+  size_t treatment_index = num_variables + 1;
+  std::vector<size_t> penalized;
+  for (size_t j = 1; j < dim_X; ++j) {
+    if (j != treatment_index) {
+      penalized.push_back(j);
+    }
   }
-
-  return predictions;
+  return penalized;
 }
 
 std::vector<double> LLCausalPredictionStrategy::compute_variance(
         size_t sampleID,
         const std::vector<std::vector<size_t>>& samples_by_tree,
-        const std::unordered_map<size_t, double>& weights_by_sampleID,
+        const std::vector<std::pair<size_t, double>>& weights_by_sampleID,
         const Data& train_data,
         const Data& test_data,
         size_t ci_group_size) const {
@@ -209,31 +203,16 @@ std::vector<double> LLCausalPredictionStrategy::compute_variance(
   Eigen::MatrixXd M_unpenalized (dim_X, dim_X);
   M_unpenalized.noalias() = X.transpose() * weights_vec.asDiagonal() * X;
 
-  Eigen::MatrixXd M;
-  M = M_unpenalized;
-  if (!weight_penalty) {
-    double normalization = M_unpenalized.trace() / dim_X;
-
-    // standard ridge penalty
-    for(size_t j = 1; j < dim_X; ++j){
-      if (j != treatment_index){
-        M(j, j) += lambda * normalization;
-      }
-    }
-  } else {
-    // covariance ridge penalty
-    for(size_t j = 1; j < dim_X; ++j){
-      if (j != treatment_index){
-        M(j, j) += lambda * M(j, j);
-      }
-    }
-  }
-
-  Eigen::VectorXd theta = M.ldlt().solve(X.transpose()*weights_vec.asDiagonal()*Y);
+  // Solve for the local coefficients and for the treatment row of the inverse with
+  // one factorization.
+  Eigen::MatrixXd rhs = Eigen::MatrixXd::Zero(dim_X, 2);
+  rhs.col(0) = X.transpose()*weights_vec.asDiagonal()*Y;
+  rhs(treatment_index, 1) = 1.0;
+  LocalLinearRidgeSolver solver(M_unpenalized, penalized_regressors(), weight_penalty);
+  Eigen::MatrixXd solution = solver.solve(lambda, rhs);
 
-  Eigen::VectorXd e_trt = Eigen::VectorXd::Zero(dim_X);
-  e_trt(treatment_index) = 1.0;
-  Eigen::VectorXd zeta = M.ldlt().solve(e_trt);
+  Eigen::VectorXd theta = solution.col(0);
+  Eigen::VectorXd zeta = solution.col(1);
 
   Eigen::VectorXd X_times_zeta = X * zeta;
   Eigen::VectorXd local_prediction = X * theta;
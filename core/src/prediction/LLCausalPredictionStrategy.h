@@ -19,7 +19,8 @@
 
 
 #include <cstddef>
-#include <unordered_map>
+#include <utility>
+#include <vector>
 #include "Eigen/Dense"
 #include "commons/Data.h"
 #include "prediction/Prediction.h"
@@ -38,19 +39,29 @@ public:
     size_t prediction_length() const;
 
     std::vector<double> predict(size_t sampleID,
-                                const std::unordered_map<size_t, double>& weights_by_sampleID,
+                                const std::vector<std::pair<size_t, double>>& weights_by_sampleID,
                                 const Data& original_data,
                                 const Data& test_data) const;
 
     std::vector<double> compute_variance(
             size_t sampleID,
             const std::vector<std::vector<size_t>>& samples_by_tree,
-            const std::unordered_map<size_t, double>& weights_by_sampleID,
+            const std::vector<std::pair<size_t, double>>& weights_by_sampleID,
             const Data& train_data,
             const Data& data,
             size_t ci_group_size) const;
 
+    /**
+    * The treatment effect predictions along the regularization path, from the
+    * forest-weighted Gram matrix X^T W X of the regressors (1, X - x, W, (X - x) W) at
+    * test point x, and from X^T W Y.
+    */
+    std::vector<double> ridge_predictions(const Eigen::MatrixXd& M_unpenalized,
+                                          const Eigen::MatrixXd& XtWY) const;
+
 private:
+    std::vector<size_t> penalized_regressors() const;
+
     std::vector<double> lambdas;
     bool weight_penalty;
     std::vector<size_t> linear_correction_variables;
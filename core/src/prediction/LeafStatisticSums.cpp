@@ -0,0 +1,87 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include "prediction/LeafStatisticSums.h"
+
+namespace grf {
+
+LeafStatisticSums::LeafStatisticSums(const std::vector<double>& coefficients,
+                                     size_t ci_group_size):
+    coefficients(coefficients),
+    ci_group_size(ci_group_size),
+    group_index(0),
+    good_group(true),
+    group_rho(0),
+    group_rho_squared(0),
+    num_good_groups(0),
+    rho_squared(0),
+    rho_grouped_squared(0),
+    num_leaves(0),
+    leaf_rho_squared(0) {}
+
+void LeafStatisticSums::add(const double* leaf_value) {
+  if (leaf_value == nullptr) {
+    good_group = false;
+  } else {
+    double rho = 0;
+    for (size_t type = 0; type < coefficients.size(); ++type) {
+      rho += coefficients[type] * leaf_value[type];
+    }
+    group_rho += rho;
+    group_rho_squared += rho * rho;
+    num_leaves++;
+    leaf_rho_squared += rho * rho;
+  }
+
+  group_index++;
+  if (group_index == ci_group_size) {
+    if (good_group) {
+      num_good_groups++;
+      rho_squared += group_rho_squared;
+      double group_mean = group_rho / ci_group_size;
+      rho_grouped_squared += group_mean * group_mean;
+    }
+    group_index = 0;
+    good_group = true;
+    group_rho = 0;
+    group_rho_squared = 0;
+  }
+}
+
+double LeafStatisticSums::get_num_good_groups() const {
+  return num_good_groups;
+}
+
+double LeafStatisticSums::get_rho_squared() const {
+  return rho_squared;
+}
+
+double LeafStatisticSums::get_rho_grouped_squared() const {
+  return rho_grouped_squared;
+}
+
+size_t LeafStatisticSums::get_num_leaves() const {
+  return num_leaves;
+}
+
+double LeafStatisticSums::get_leaf_rho_squared() const {
+  return leaf_rho_squared;
+}
+
+} // namespace grf
@@ -0,0 +1,84 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_LEAFSTATISTICSUMS_H
+#define GRF_LEAFSTATISTICSUMS_H
+
+#include <cstddef>
+#include <vector>
+
+namespace grf {
+
+/**
+ * The sums that the variance and error estimates of a test sample need from a statistic
+ * rho = c^T v, linear in the prediction values v of each tree's leaf, with coefficients c
+ * that depend only on the average prediction values.
+ *
+ * Leaves are added in tree order, and every ci_group_size trees form a group. The sums
+ * over groups only count groups whose leaves are all non-empty ("good groups"), while
+ * the sums over leaves count every non-empty leaf.
+ */
+class LeafStatisticSums {
+public:
+  LeafStatisticSums(const std::vector<double>& coefficients,
+                    size_t ci_group_size);
+
+  /**
+   * Adds the leaf of the next tree, or an empty leaf if `leaf_value` is null.
+   */
+  void add(const double* leaf_value);
+
+  double get_num_good_groups() const;
+
+  /**
+   * The sum of rho^2 over the trees of the good groups.
+   */
+  double get_rho_squared() const;
+
+  /**
+   * The sum over the good groups of the squared average rho of the group.
+   */
+  double get_rho_grouped_squared() const;
+
+  size_t get_num_leaves() const;
+
+  /**
+   * The sum of rho^2 over all non-empty leaves.
+   */
+  double get_leaf_rho_squared() const;
+
+private:
+  std::vector<double> coefficients;
+  size_t ci_group_size;
+
+  size_t group_index;
+  bool good_group;
+  double group_rho;
+  double group_rho_squared;
+
+  double num_good_groups;
+  double rho_squared;
+  double rho_grouped_squared;
+  size_t num_leaves;
+  double leaf_rho_squared;
+};
+
+} // namespace grf
+
+#endif //GRF_LEAFSTATISTICSUMS_H
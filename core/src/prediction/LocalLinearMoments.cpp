@@ -0,0 +1,165 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include "prediction/LocalLinearMoments.h"
+
+namespace grf {
+
+LocalLinearMoments::LocalLinearMoments(std::vector<size_t> linear_correction_variables,
+                                       bool treatment_interactions):
+    linear_correction_variables(linear_correction_variables),
+    treatment_interactions(treatment_interactions) {
+  size_t num_variables = linear_correction_variables.size();
+  num_regressors = treatment_interactions ? 2 * num_variables + 2 : num_variables + 1;
+}
+
+size_t LocalLinearMoments::get_num_values() const {
+  size_t num_variables = linear_correction_variables.size();
+  return num_variables + num_regressors * (num_regressors + 1) / 2 + num_regressors;
+}
+
+SparsePredictionValues LocalLinearMoments::compute(const LeafSamples& leaf_samples,
+                                                   const Data& data) const {
+  size_t num_variables = linear_correction_variables.size();
+  size_t treatment_index = num_variables + 1;
+
+  size_t num_leaves = leaf_samples.size();
+  std::vector<std::vector<double>> values(num_leaves);
+  std::vector<double> z(num_regressors);
+
+  for (size_t i = 0; i < num_leaves; ++i) {
+    LeafSampleSpan samples = leaf_samples[i];
+    if (samples.empty()) {
+      continue;
+    }
+
+    std::vector<double>& leaf_values = values[i];
+    leaf_values.assign(get_num_values(), 0.0);
+    double* mean = leaf_values.data();
+    double* XtX = mean + num_variables;
+    double* XtY = XtX + num_regressors * (num_regressors + 1) / 2;
+
+    for (size_t sample : samples) {
+      for (size_t j = 0; j < num_variables; ++j) {
+        mean[j] += data.get(sample, linear_correction_variables[j]);
+      }
+    }
+    for (size_t j = 0; j < num_variables; ++j) {
+      mean[j] /= samples.size();
+    }
+
+    for (size_t sample : samples) {
+      z[0] = 1;
+      for (size_t j = 0; j < num_variables; ++j) {
+        z[j + 1] = data.get(sample, linear_correction_variables[j]) - mean[j];
+      }
+      if (treatment_interactions) {
+        double treatment = data.get_treatment(sample);
+        z[treatment_index] = treatment;
+        for (size_t j = 0; j < num_variables; ++j) {
+          z[treatment_index + j + 1] = z[j + 1] * treatment;
+        }
+      }
+
+      double outcome = data.get_outcome(sample);
+      size_t k = 0;
+      for (size_t a = 0; a < num_regressors; ++a) {
+        for (size_t b = a; b < num_regressors; ++b) {
+          XtX[k++] += z[a] * z[b];
+        }
+        XtY[a] += z[a] * outcome;
+      }
+    }
+
+    for (size_t k = num_variables; k < get_num_values(); ++k) {
+      leaf_values[k] /= samples.size();
+    }
+  }
+
+  return SparsePredictionValues(values, get_num_values());
+}
+
+void LocalLinearMoments::center_at_sample(const std::vector<SparseEntries>& leaf_entries,
+                                          size_t sample,
+                                          const Data& data,
+                                          Eigen::MatrixXd& XtWX,
+                                          Eigen::MatrixXd& XtWY) const {
+  size_t num_variables = linear_correction_variables.size();
+  size_t treatment_index = num_variables + 1;
+
+  // The regressors centered at the test point x are those centered at the leaf mean m
+  // plus an offset times another regressor: X - x = (X - m) + (m - x) * 1, and
+  // (X - x) W = (X - m) W + (m - x) * W. `base` is the index of that other regressor,
+  // and `offset` is m - x, or zero for the regressors that do not depend on x.
+  std::vector<size_t> base(num_regressors, 0);
+  std::vector<double> offset(num_regressors, 0.0);
+  if (treatment_interactions) {
+    for (size_t j = 0; j < num_variables; ++j) {
+      base[treatment_index + j + 1] = treatment_index;
+    }
+  }
+
+  Eigen::MatrixXd moments(num_regressors, num_regressors);
+  XtWX = Eigen::MatrixXd::Zero(num_regressors, num_regressors);
+  XtWY = Eigen::MatrixXd::Zero(num_regressors, 1);
+
+  for (const SparseEntries& entries : leaf_entries) {
+    const double* mean = entries.values;
+    const double* XtX = mean + num_variables;
+    const double* XtY = XtX + num_regressors * (num_regressors + 1) / 2;
+
+    size_t k = 0;
+    for (size_t a = 0; a < num_regressors; ++a) {
+      for (size_t b = a; b < num_regressors; ++b) {
+        moments(a, b) = XtX[k];
+        moments(b, a) = XtX[k];
+        k++;
+      }
+    }
+
+    for (size_t j = 0; j < num_variables; ++j) {
+      double leaf_offset = mean[j] - data.get(sample, linear_correction_variables[j]);
+      offset[j + 1] = leaf_offset;
+      if (treatment_interactions) {
+        offset[treatment_index + j + 1] = leaf_offset;
+      }
+    }
+
+    for (size_t a = 0; a < num_regressors; ++a) {
+      for (size_t b = a; b < num_regressors; ++b) {
+        XtWX(a, b) += moments(a, b)
+            + offset[a] * moments(base[a], b)
+            + offset[b] * moments(a, base[b])
+            + offset[a] * offset[b] * moments(base[a], base[b]);
+      }
+      XtWY(a) += XtY[a] + offset[a] * XtY[base[a]];
+    }
+  }
+
+  double num_leaves = static_cast<double>(leaf_entries.size());
+  for (size_t a = 0; a < num_regressors; ++a) {
+    for (size_t b = a; b < num_regressors; ++b) {
+      XtWX(a, b) /= num_leaves;
+      XtWX(b, a) = XtWX(a, b);
+    }
+    XtWY(a) /= num_leaves;
+  }
+}
+
+} // namespace grf
@@ -0,0 +1,82 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_LOCALLINEARMOMENTS_H
+#define GRF_LOCALLINEARMOMENTS_H
+
+#include <cstddef>
+#include <vector>
+
+#include "Eigen/Dense"
+#include "commons/Data.h"
+#include "prediction/SparsePredictionValues.h"
+#include "tree/LeafSamples.h"
+
+namespace grf {
+
+/**
+ * The moments of the local linear regressors in each leaf, from which the Gram matrix
+ * X^T W X and X^T W Y of a local linear prediction can be assembled without visiting
+ * the neighbors of the test point.
+ *
+ * The regressors of a training sample are z = (1, X - m), or z = (1, X - m, W, (X - m) W)
+ * with treatment interactions, where X are the linear correction variables and m is
+ * their mean over the leaf. A leaf stores m, the upper triangle of the sum of z z^T and
+ * the sum of z Y, both divided by the leaf size, as one sparse prediction value entry.
+ * A prediction shifts the moments of each of its leaves from m to the test point x, which
+ * gives the moments of (1, X - x, ...), and averages them over the leaves. As the
+ * regressors are centered within each leaf, and each leaf is shifted by the distance of
+ * its own mean to x, no precision is lost when the variables are far from zero or from
+ * their mean over the training data.
+ */
+class LocalLinearMoments {
+public:
+  LocalLinearMoments(std::vector<size_t> linear_correction_variables,
+                     bool treatment_interactions);
+
+  /**
+   * The number of values stored for each leaf.
+   */
+  size_t get_num_values() const;
+
+  /**
+   * The moments of every leaf of a tree, one entry per non-empty leaf.
+   */
+  SparsePredictionValues compute(const LeafSamples& leaf_samples,
+                                 const Data& data) const;
+
+  /**
+   * Computes X^T W X and X^T W Y with the regressors centered at test sample `sample`
+   * of `data`, from the moments of the leaves the sample landed in.
+   */
+  void center_at_sample(const std::vector<SparseEntries>& leaf_entries,
+                        size_t sample,
+                        const Data& data,
+                        Eigen::MatrixXd& XtWX,
+                        Eigen::MatrixXd& XtWY) const;
+
+private:
+  std::vector<size_t> linear_correction_variables;
+  bool treatment_interactions;
+  size_t num_regressors;
+};
+
+} // namespace grf
+
+#endif //GRF_LOCALLINEARMOMENTS_H
@@ -22,6 +22,7 @@
 #include "commons/utility.h"
 #include "commons/Data.h"
 #include "prediction/LocalLinearPredictionStrategy.h"
+#include "prediction/LocalLinearRidgeSolver.h"
 
 namespace grf {
 
@@ -39,7 +40,7 @@ size_t LocalLinearPredictionStrategy::prediction_length() const {
 
 std::vector<double> LocalLinearPredictionStrategy::predict(
     size_t sampleID,
-    const std::unordered_map<size_t, double>& weights_by_sampleID,
+    const std::vector<std::pair<size_t, double>>& weights_by_sampleID,
     const Data& train_data,
     const Data& data) const {
   size_t num_variables = linear_correction_variables.size();
@@ -73,39 +74,30 @@ std::vector<double> LocalLinearPredictionStrategy::predict(
   // find ridge regression predictions
   Eigen::MatrixXd M_unpenalized(num_variables+1, num_variables+1);
   M_unpenalized.noalias() = X.transpose()*weights_vec.asDiagonal()*X;
+  Eigen::MatrixXd XtWY = X.transpose()*weights_vec.asDiagonal()*Y;
 
-  Eigen::MatrixXd M;
-  size_t num_lambdas = lambdas.size();
-  std::vector<double> predictions(num_lambdas);
-
-  for (size_t i = 0; i < num_lambdas; ++i){
-    double lambda = lambdas[i];
-    M = M_unpenalized;
+  return ridge_predictions(M_unpenalized, XtWY);
+}
 
-    if (!weight_penalty) {
-      // standard ridge penalty
-      double normalization = M.trace() / (num_variables + 1);
-      for (size_t j = 1; j < num_variables + 1; ++j){
-        M(j,j) += lambda * normalization;
-      }
-    } else {
-      // covariance ridge penalty
-      for (size_t j = 1; j < num_variables+1; ++j){
-        M(j,j) += lambda * M(j,j); // note that the weights are already normalized
-      }
-    }
+std::vector<double> LocalLinearPredictionStrategy::ridge_predictions(const Eigen::MatrixXd& M_unpenalized,
+                                                                     const Eigen::MatrixXd& XtWY) const {
+  LocalLinearRidgeSolver solver(M_unpenalized, penalized_regressors(), weight_penalty);
+  return solver.solve_path(lambdas, XtWY, 0);
+}
 
-    Eigen::MatrixXd local_coefficients = M.ldlt().solve(X.transpose()*weights_vec.asDiagonal()*Y);
-    predictions[i] =  local_coefficients(0);
+std::vector<size_t> LocalLinearPredictionStrategy::penalized_regressors() const {
+  // Every regressor but the intercept.
+  std::vector<size_t> penalized;
+  for (size_t j = 1; j < linear_correction_variables.size() + 1; ++j) {
+    penalized.push_back(j);
   }
-
-  return predictions;
+  return penalized;
 }
 
 std::vector<double> LocalLinearPredictionStrategy::compute_variance(
     size_t sampleID,
     const std::vector<std::vector<size_t>>& samples_by_tree,
-    const std::unordered_map<size_t, double>& weights_by_sampleID,
+    const std::vector<std::pair<size_t, double>>& weights_by_sampleID,
     const Data& train_data,
     const Data& data,
     size_t ci_group_size) const {
@@ -147,22 +139,16 @@ std::vector<double> LocalLinearPredictionStrategy::compute_variance(
   Eigen::MatrixXd M (num_variables+1, num_variables+1);
   M.noalias() = X.transpose()*weights_vec.asDiagonal()*X;
 
-  if (!weight_penalty) {
-    double normalization = M.trace() / (num_variables + 1);
-    for (size_t i = 1; i < num_variables + 1; ++i){
-      M(i,i) += lambda * normalization;
-    }
-  } else {
-    for (size_t i = 1; i < num_variables+1; ++i){
-      M(i,i) += lambda * M(i,i);
-    }
-  }
-
-  Eigen::VectorXd theta = M.ldlt().solve(X.transpose()*weights_vec.asDiagonal()*Y);
+  // Solve for the local coefficients and for the intercept row of the inverse with
+  // one factorization.
+  Eigen::MatrixXd rhs = Eigen::MatrixXd::Zero(num_variables+1, 2);
+  rhs.col(0) = X.transpose()*weights_vec.asDiagonal()*Y;
+  rhs(0, 1) = 1.0;
+  LocalLinearRidgeSolver solver(M, penalized_regressors(), weight_penalty);
+  Eigen::MatrixXd solution = solver.solve(lambda, rhs);
 
-  Eigen::VectorXd e_one = Eigen::VectorXd::Zero(num_variables+1);
-  e_one(0) = 1.0;
-  Eigen::VectorXd zeta = M.ldlt().solve(e_one);
+  Eigen::VectorXd theta = solution.col(0);
+  Eigen::VectorXd zeta = solution.col(1);
 
   Eigen::VectorXd X_times_zeta = X * zeta;
   Eigen::VectorXd local_prediction = X * theta;
@@ -0,0 +1,175 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <limits>
+
+#include "prediction/LocalLinearRidgeSolver.h"
+
+namespace grf {
+
+// The eigendecomposition costs about as much as this many direct solves.
+const size_t LocalLinearRidgeSolver::MIN_FACTORIZED_PATH_LENGTH = 8;
+
+LocalLinearRidgeSolver::LocalLinearRidgeSolver(const Eigen::MatrixXd& M_unpenalized,
+                                               const std::vector<size_t>& penalized_regressors,
+                                               bool weight_penalty):
+    M_unpenalized(M_unpenalized) {
+  size_t dim = M_unpenalized.rows();
+  double normalization = M_unpenalized.trace() / dim;
+
+  penalty = Eigen::VectorXd::Zero(dim);
+  std::vector<bool> is_penalized(dim, false);
+  for (size_t j : penalized_regressors) {
+    penalty(j) = weight_penalty ? M_unpenalized(j, j) : normalization;
+    // A regressor without a positive penalty, such as a constant one with the covariance
+    // penalty, is solved for with the unpenalized ones.
+    is_penalized[j] = penalty(j) > 0 && std::isfinite(penalty(j));
+  }
+  for (size_t j = 0; j < dim; ++j) {
+    if (is_penalized[j]) {
+      penalized.push_back(j);
+    } else {
+      unpenalized.push_back(j);
+    }
+  }
+}
+
+std::vector<double> LocalLinearRidgeSolver::solve_path(const std::vector<double>& lambdas,
+                                                       const Eigen::VectorXd& rhs,
+                                                       size_t index) const {
+  std::vector<double> coefficients(lambdas.size());
+  if (lambdas.size() >= MIN_FACTORIZED_PATH_LENGTH) {
+    solve_path_factorized(lambdas, rhs, index, coefficients);
+    return coefficients;
+  }
+
+  for (size_t i = 0; i < lambdas.size(); ++i) {
+    coefficients[i] = solve(lambdas[i], rhs)(index, 0);
+  }
+  return coefficients;
+}
+
+Eigen::MatrixXd LocalLinearRidgeSolver::solve(double lambda,
+                                              const Eigen::MatrixXd& rhs) const {
+  Eigen::MatrixXd M = M_unpenalized;
+  M.diagonal() += lambda * penalty;
+  return M.ldlt().solve(rhs);
+}
+
+void LocalLinearRidgeSolver::solve_path_factorized(const std::vector<double>& lambdas,
+                                                   const Eigen::VectorXd& rhs,
+                                                   size_t index,
+                                                   std::vector<double>& coefficients) const {
+  size_t num_penalized = penalized.size();
+  size_t num_unpenalized = unpenalized.size();
+
+  // Scale the penalized regressors to a unit penalty, S M_PP S + lambda * I, and
+  // diagonalize the scaled block once: S M_PP S = V E V^T.
+  Eigen::VectorXd scale(num_penalized);
+  for (size_t a = 0; a < num_penalized; ++a) {
+    scale(a) = 1 / std::sqrt(penalty(penalized[a]));
+  }
+
+  Eigen::MatrixXd M_PP(num_penalized, num_penalized);
+  Eigen::MatrixXd M_PU(num_penalized, num_unpenalized);
+  Eigen::VectorXd rhs_penalized(num_penalized);
+  for (size_t a = 0; a < num_penalized; ++a) {
+    for (size_t b = 0; b < num_penalized; ++b) {
+      M_PP(a, b) = scale(a) * M_unpenalized(penalized[a], penalized[b]) * scale(b);
+    }
+    for (size_t b = 0; b < num_unpenalized; ++b) {
+      M_PU(a, b) = scale(a) * M_unpenalized(penalized[a], unpenalized[b]);
+    }
+    rhs_penalized(a) = scale(a) * rhs(penalized[a]);
+  }
+
+  Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> eigen_solver(M_PP);
+  const Eigen::VectorXd& eigenvalues = eigen_solver.eigenvalues();
+  const Eigen::MatrixXd& eigenvectors = eigen_solver.eigenvectors();
+  Eigen::MatrixXd coupling = eigenvectors.transpose() * M_PU;
+  Eigen::VectorXd rhs_eigenbasis = eigenvectors.transpose() * rhs_penalized;
+
+  size_t penalized_index = num_penalized;
+  size_t unpenalized_index = num_unpenalized;
+  for (size_t a = 0; a < num_penalized; ++a) {
+    if (penalized[a] == index) {
+      penalized_index = a;
+    }
+  }
+  for (size_t a = 0; a < num_unpenalized; ++a) {
+    if (unpenalized[a] == index) {
+      unpenalized_index = a;
+    }
+  }
+
+  // Eliminate the penalized regressors: (M_UU - M_UP K M_PU) beta_U = b_U - M_UP K b_P,
+  // where K = (M_PP + lambda * D_P)^-1 is diagonal in the eigenbasis. As in the LDLT of
+  // the direct solve, directions whose pivot vanishes are dropped rather than inverted.
+  Eigen::VectorXd inverse_eigenvalues(num_penalized);
+  Eigen::MatrixXd schur_complement(num_unpenalized, num_unpenalized);
+  Eigen::VectorXd schur_rhs(num_unpenalized);
+  Eigen::VectorXd beta(num_unpenalized);
+  Eigen::LDLT<Eigen::MatrixXd> schur_ldlt(num_unpenalized);
+  double largest_eigenvalue = num_penalized > 0 ? eigenvalues.cwiseAbs().maxCoeff() : 0;
+
+  for (size_t i = 0; i < lambdas.size(); ++i) {
+    double lambda = lambdas[i];
+    double tolerance = std::numeric_limits<double>::epsilon() * num_penalized * (largest_eigenvalue + lambda);
+    for (size_t k = 0; k < num_penalized; ++k) {
+      double pivot = eigenvalues(k) + lambda;
+      inverse_eigenvalues(k) = pivot > tolerance ? 1 / pivot : 0;
+    }
+
+    for (size_t a = 0; a < num_unpenalized; ++a) {
+      for (size_t b = 0; b < num_unpenalized; ++b) {
+        schur_complement(a, b) = M_unpenalized(unpenalized[a], unpenalized[b]);
+      }
+      schur_rhs(a) = rhs(unpenalized[a]);
+    }
+    for (size_t k = 0; k < num_penalized; ++k) {
+      for (size_t a = 0; a < num_unpenalized; ++a) {
+        double weighted_coupling = inverse_eigenvalues(k) * coupling(k, a);
+        for (size_t b = 0; b < num_unpenalized; ++b) {
+          schur_complement(a, b) -= weighted_coupling * coupling(k, b);
+        }
+        schur_rhs(a) -= weighted_coupling * rhs_eigenbasis(k);
+      }
+    }
+
+    if (num_unpenalized > 0) {
+      schur_ldlt.compute(schur_complement);
+      beta = schur_ldlt.solve(schur_rhs);
+    }
+
+    if (unpenalized_index < num_unpenalized) {
+      coefficients[i] = beta(unpenalized_index);
+    } else {
+      // Back substitute: beta_P = S V K_E (V^T S b_P - V^T S M_PU beta_U).
+      double coefficient = 0;
+      for (size_t k = 0; k < num_penalized; ++k) {
+        double residual = rhs_eigenbasis(k) - coupling.row(k).dot(beta);
+        coefficient += eigenvectors(penalized_index, k) * inverse_eigenvalues(k) * residual;
+      }
+      coefficients[i] = scale(penalized_index) * coefficient;
+    }
+  }
+}
+
+} // namespace grf
@@ -0,0 +1,77 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_LOCALLINEARRIDGESOLVER_H
+#define GRF_LOCALLINEARRIDGESOLVER_H
+
+#include <cstddef>
+#include <vector>
+
+#include "Eigen/Dense"
+
+namespace grf {
+
+/**
+ * Solves the ridge regressions (M + lambda * D) beta = b of a local linear
+ * prediction, where M = X^T W X is the Gram matrix of the regressors. D is diagonal,
+ * and is zero for the unpenalized regressors, such as the intercept. For the penalized
+ * regressors it is the trace of M divided by its dimension, or, with the covariance
+ * penalty, their own diagonal entry in M.
+ *
+ * Along a long regularization path, the penalized block of M is scaled by D and
+ * eigendecomposed once, so that each lambda only costs a diagonal solve and a solve on
+ * the few unpenalized regressors (their Schur complement). Short paths are solved
+ * directly for each lambda.
+ */
+class LocalLinearRidgeSolver {
+public:
+  LocalLinearRidgeSolver(const Eigen::MatrixXd& M_unpenalized,
+                         const std::vector<size_t>& penalized_regressors,
+                         bool weight_penalty);
+
+  /**
+   * The coefficient `index` of the solution for each penalty in `lambdas`.
+   */
+  std::vector<double> solve_path(const std::vector<double>& lambdas,
+                                 const Eigen::VectorXd& rhs,
+                                 size_t index) const;
+
+  /**
+   * The solution for penalty `lambda`, for each column of `rhs`, from one factorization.
+   */
+  Eigen::MatrixXd solve(double lambda,
+                        const Eigen::MatrixXd& rhs) const;
+
+private:
+  void solve_path_factorized(const std::vector<double>& lambdas,
+                             const Eigen::VectorXd& rhs,
+                             size_t index,
+                             std::vector<double>& coefficients) const;
+
+  static const size_t MIN_FACTORIZED_PATH_LENGTH;
+
+  Eigen::MatrixXd M_unpenalized;
+  Eigen::VectorXd penalty;
+  std::vector<size_t> penalized;
+  std::vector<size_t> unpenalized;
+};
+
+} // namespace grf
+
+#endif //GRF_LOCALLINEARRIDGESOLVER_H
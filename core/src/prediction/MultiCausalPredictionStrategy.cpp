@@ -125,12 +125,12 @@ std::vector<double> MultiCausalPredictionStrategy::compute_variance(
     for (size_t j = 0; j < ci_group_size; ++j) {
 
       size_t i = group * ci_group_size + j;
-      const std::vector<double>& leaf_value = leaf_values.get_values(i);
+      const double* leaf_value = leaf_values.get_values(i);
       double leaf_weight = leaf_value[weight_index];
       double leaf_Y = leaf_value[Y_index];
-      Eigen::Map<const Eigen::VectorXd> leaf_W(leaf_value.data() + W_index, num_treatments);
-      Eigen::Map<const Eigen::VectorXd> leaf_YW(leaf_value.data() + YW_index, num_treatments);
-      Eigen::Map<const Eigen::MatrixXd> leaf_WW(leaf_value.data() + WW_index, num_treatments, num_treatments);
+      Eigen::Map<const Eigen::VectorXd> leaf_W(leaf_value + W_index, num_treatments);
+      Eigen::Map<const Eigen::VectorXd> leaf_YW(leaf_value + YW_index, num_treatments);
+      Eigen::Map<const Eigen::MatrixXd> leaf_WW(leaf_value + WW_index, num_treatments, num_treatments);
 
       psi_1 = leaf_YW - leaf_WW * theta - leaf_W * main_effect;
       double psi_2 = leaf_Y - leaf_W.transpose() * theta - leaf_weight * main_effect;
@@ -167,10 +167,10 @@ size_t MultiCausalPredictionStrategy::prediction_value_length() const {
 }
 
 PredictionValues MultiCausalPredictionStrategy::precompute_prediction_values(
-    const std::vector<std::vector<size_t>>& leaf_samples,
+    const LeafSamples& leaf_samples,
     const Data& data) const {
   size_t num_leaves = leaf_samples.size();
-  std::vector<std::vector<double>> values(num_leaves);
+  PredictionValues values(num_leaves, num_types);
 
   for (size_t i = 0; i < leaf_samples.size(); ++i) {
     size_t num_samples = leaf_samples[i].size();
@@ -185,8 +185,8 @@ PredictionValues MultiCausalPredictionStrategy::precompute_prediction_values(
     double sum_weight = 0.0;
     for (auto& sample : leaf_samples[i]) {
       double weight = data.get_weight(sample);
-      Eigen::VectorXd outcome = data.get_outcomes(sample);
-      Eigen::VectorXd treatment = data.get_treatments(sample);
+      Data::RowView outcome = data.get_outcomes(sample);
+      Data::RowView treatment = data.get_treatments(sample);
       sum_Y += weight * outcome;
       sum_W += weight * treatment;
       sum_YW.noalias() += weight * treatment * outcome.transpose();
@@ -197,28 +197,27 @@ PredictionValues MultiCausalPredictionStrategy::precompute_prediction_values(
     if (std::abs(sum_weight) <= 1e-16) {
       continue;
     }
-    std::vector<double>& value = values[i];
-    value.reserve(num_types);
+    double* value = values.initialize_values(i);
     // store sufficient statistics in order
     // {sum_weight, sum_Y, sum_W, sum_YW, sum_WW}
 
-    value.push_back(sum_weight / num_samples);
+    *value++ = sum_weight / num_samples;
     for (size_t j = 0; j < num_outcomes; j++) {
-      value.push_back(sum_Y[j] / num_samples);
+      *value++ = sum_Y[j] / num_samples;
     }
     for (size_t j = 0; j < num_treatments; j++) {
-      value.push_back(sum_W[j] / num_samples);
+      *value++ = sum_W[j] / num_samples;
     }
     for (size_t j = 0; j < num_treatments * num_outcomes; j++) {
-      value.push_back(sum_YW.data()[j] / num_samples);
+      *value++ = sum_YW.data()[j] / num_samples;
     }
     for (size_t j = 0; j < num_treatments * num_treatments; j++) {
-      value.push_back(sum_WW.data()[j] / num_samples);
+      *value++ = sum_WW.data()[j] / num_samples;
     }
 
   }
 
-  return PredictionValues(values, num_types);
+  return values;
 }
 
 std::vector<std::pair<double, double>> MultiCausalPredictionStrategy::compute_error(
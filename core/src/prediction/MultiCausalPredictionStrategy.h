@@ -60,7 +60,7 @@ public:
 
   size_t prediction_value_length() const;
   PredictionValues precompute_prediction_values(
-      const std::vector<std::vector<size_t>>& leaf_samples,
+      const LeafSamples& leaf_samples,
       const Data& data) const;
 
   size_t prediction_length() const;
@@ -56,13 +56,13 @@ size_t MultiRegressionPredictionStrategy::prediction_value_length() const {
 }
 
 PredictionValues MultiRegressionPredictionStrategy::precompute_prediction_values(
-    const std::vector<std::vector<size_t>>& leaf_samples,
+    const LeafSamples& leaf_samples,
     const Data& data) const {
   size_t num_leaves = leaf_samples.size();
-  std::vector<std::vector<double>> values(num_leaves);
+  PredictionValues values(num_leaves, num_types);
 
   for (size_t i = 0; i < num_leaves; i++) {
-    const std::vector<size_t>& leaf_node = leaf_samples.at(i);
+    LeafSampleSpan leaf_node = leaf_samples[i];
     size_t num_samples = leaf_node.size();
     if (num_samples == 0) {
       continue;
@@ -82,15 +82,14 @@ PredictionValues MultiRegressionPredictionStrategy::precompute_prediction_values
 
     // store sufficient statistics in order
     // {outcome_1, ..., outcome_M, weight_sum}
-    std::vector<double>& value = values[i];
-    value.reserve(num_types);
+    double* value = values.initialize_values(i);
     for (size_t j = 0; j < num_outcomes; j++) {
-      value.push_back(sum[j] / num_samples);
+      value[j] = sum[j] / num_samples;
     }
-    value.push_back(sum_weight / num_samples);
+    value[num_outcomes] = sum_weight / num_samples;
   }
 
-  return PredictionValues(values, num_types);
+  return values;
 }
 
 std::vector<std::pair<double, double>> MultiRegressionPredictionStrategy::compute_error(
@@ -0,0 +1,88 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <stdexcept>
+
+#include "prediction/OptimizedLLCausalPredictionStrategy.h"
+
+namespace grf {
+
+OptimizedLLCausalPredictionStrategy::OptimizedLLCausalPredictionStrategy(
+    std::vector<double> lambdas,
+    bool weight_penalty,
+    std::vector<size_t> linear_correction_variables):
+  moments(linear_correction_variables, true),
+  ll_strategy(lambdas, weight_penalty, linear_correction_variables) {}
+
+size_t OptimizedLLCausalPredictionStrategy::prediction_length() const {
+  return ll_strategy.prediction_length();
+}
+
+std::vector<double> OptimizedLLCausalPredictionStrategy::predict(const std::vector<double>& average) const {
+  throw std::runtime_error("Local linear predictions require the test sample.");
+}
+
+std::vector<double> OptimizedLLCausalPredictionStrategy::compute_variance(
+    const std::vector<double>& average,
+    const PredictionValues& leaf_values,
+    size_t ci_group_size) const {
+  throw std::runtime_error("Variance estimates are not supported with precomputed local linear moments.");
+}
+
+size_t OptimizedLLCausalPredictionStrategy::prediction_value_length() const {
+  return 0;
+}
+
+PredictionValues OptimizedLLCausalPredictionStrategy::precompute_prediction_values(
+    const LeafSamples& leaf_samples,
+    const Data& data) const {
+  return PredictionValues();
+}
+
+std::vector<std::pair<double, double>> OptimizedLLCausalPredictionStrategy::compute_error(
+    size_t sample,
+    const std::vector<double>& average,
+    const PredictionValues& leaf_values,
+    const Data& data) const {
+  return { std::make_pair<double, double>(NAN, NAN) };
+}
+
+bool OptimizedLLCausalPredictionStrategy::has_sparse_prediction_values() const {
+  return true;
+}
+
+SparsePredictionValues OptimizedLLCausalPredictionStrategy::precompute_sparse_prediction_values(
+    const LeafSamples& leaf_samples,
+    const Data& data) const {
+  return moments.compute(leaf_samples, data);
+}
+
+std::vector<double> OptimizedLLCausalPredictionStrategy::predict_sparse_sample(
+    size_t sample,
+    const std::vector<SparseEntries>& leaf_entries,
+    const Data& data,
+    SparsePredictionWorkspace& workspace) const {
+  Eigen::MatrixXd XtWX;
+  Eigen::MatrixXd XtWY;
+  moments.center_at_sample(leaf_entries, sample, data, XtWX, XtWY);
+  return ll_strategy.ridge_predictions(XtWX, XtWY);
+}
+
+} // namespace grf
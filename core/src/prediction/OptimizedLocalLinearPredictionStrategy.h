@@ -0,0 +1,94 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_OPTIMIZEDLOCALLINEARPREDICTIONSTRATEGY_H
+#define GRF_OPTIMIZEDLOCALLINEARPREDICTIONSTRATEGY_H
+
+#include <cstddef>
+#include <vector>
+
+#include "commons/Data.h"
+#include "prediction/LocalLinearMoments.h"
+#include "prediction/LocalLinearPredictionStrategy.h"
+#include "prediction/OptimizedPredictionStrategy.h"
+#include "prediction/PredictionValues.h"
+#include "prediction/SparsePredictionValues.h"
+
+namespace grf {
+
+/**
+ * Computes the same regularization path as LocalLinearPredictionStrategy, from the
+ * moments of the local linear regressors precomputed for each leaf (see
+ * LocalLinearMoments). A prediction shifts the moments of each leaf of the test point
+ * to it, averages them and solves one small ridge regression per lambda, instead of
+ * assembling the regression from every neighbor of the test point.
+ *
+ * The moments depend on the linear correction variables, so they are computed for
+ * the trees of a trained forest right before prediction, and stored as sparse
+ * prediction values with one entry per leaf. Variance estimates are not supported.
+ */
+class OptimizedLocalLinearPredictionStrategy final: public OptimizedPredictionStrategy {
+public:
+  OptimizedLocalLinearPredictionStrategy(std::vector<double> lambdas,
+                                         bool weight_penalty,
+                                         std::vector<size_t> linear_correction_variables);
+
+  size_t prediction_length() const;
+
+  /**
+   * Not supported, since a local linear prediction depends on the test sample.
+   */
+  std::vector<double> predict(const std::vector<double>& average) const;
+
+  std::vector<double> compute_variance(
+      const std::vector<double>& average,
+      const PredictionValues& leaf_values,
+      size_t ci_group_size) const;
+
+  size_t prediction_value_length() const;
+
+  PredictionValues precompute_prediction_values(
+      const LeafSamples& leaf_samples,
+      const Data& data) const;
+
+  std::vector<std::pair<double, double>> compute_error(
+      size_t sample,
+      const std::vector<double>& average,
+      const PredictionValues& leaf_values,
+      const Data& data) const;
+
+  bool has_sparse_prediction_values() const;
+
+  SparsePredictionValues precompute_sparse_prediction_values(
+      const LeafSamples& leaf_samples,
+      const Data& data) const;
+
+  std::vector<double> predict_sparse_sample(size_t sample,
+                                            const std::vector<SparseEntries>& leaf_entries,
+                                            const Data& data,
+                                            SparsePredictionWorkspace& workspace) const;
+
+private:
+  LocalLinearMoments moments;
+  LocalLinearPredictionStrategy ll_strategy;
+};
+
+} // namespace grf
+
+#endif //GRF_OPTIMIZEDLOCALLINEARPREDICTIONSTRATEGY_H
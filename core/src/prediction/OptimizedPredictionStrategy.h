@@ -20,15 +20,32 @@
 #ifndef GRF_OPTIMIZEDPREDICTIONSTRATEGY_H
 #define GRF_OPTIMIZEDPREDICTIONSTRATEGY_H
 
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
 #include "commons/globals.h"
 #include "commons/Data.h"
+#include "prediction/LeafStatisticSums.h"
 #include "prediction/Prediction.h"
 #include "prediction/PredictionValues.h"
+#include "prediction/SparsePredictionValues.h"
+#include "tree/LeafSamples.h"
 
 namespace grf {
 
+/**
+ * Scratch space for OptimizedPredictionStrategy::predict_sparse, owned by the caller so
+ * that it is reused across the samples it predicts. A strategy may accumulate failure
+ * and censoring counts on the failure time grid in `count_failure` and `count_censor`,
+ * or gather (value, weight) pairs in `weighted_values`.
+ */
+struct SparsePredictionWorkspace {
+  std::vector<double> count_failure;
+  std::vector<double> count_censor;
+  std::vector<std::pair<double, double>> weighted_values;
+};
+
 /**
  * A prediction strategy defines how predictions are computed over test samples.
  *
@@ -88,7 +105,7 @@ public:
   * each leaf so that it does not need to recompute these values during every prediction.
   */
   virtual PredictionValues precompute_prediction_values(
-      const std::vector<std::vector<size_t>>& leaf_samples,
+      const LeafSamples& leaf_samples,
       const Data& data) const = 0;
 
  /**
@@ -108,6 +125,97 @@ public:
       const std::vector<double>& average,
       const PredictionValues& leaf_values,
       const Data& data) const = 0;
+
+ /**
+  * Whether compute_variance depends on each leaf only through a statistic rho = c^T v,
+  * linear in the leaf's prediction values v, whose coefficients c are given by
+  * compute_leaf_statistic_coefficients. The collector then sums rho by group of trees as
+  * it visits each tree's leaf, and calls compute_variance_from_sums instead of copying the
+  * values of every leaf. has_linear_error is the same for compute_error.
+  */
+  virtual bool has_linear_variance() const {
+    return false;
+  }
+
+  virtual bool has_linear_error() const {
+    return false;
+  }
+
+ /**
+  * The coefficients c of the statistic rho = c^T v of each leaf, one per type of
+  * prediction value, for a test sample with average prediction values `average`.
+  */
+  virtual std::vector<double> compute_leaf_statistic_coefficients(const std::vector<double>& average) const {
+    throw std::runtime_error("This prediction strategy does not have a linear variance estimate.");
+  }
+
+ /**
+  * Computes compute_variance from the sums of the leaf statistic, for strategies with
+  * a linear variance estimate.
+  */
+  virtual std::vector<double> compute_variance_from_sums(const std::vector<double>& average,
+                                                         const LeafStatisticSums& sums,
+                                                         size_t ci_group_size) const {
+    throw std::runtime_error("This prediction strategy does not have a linear variance estimate.");
+  }
+
+ /**
+  * Computes compute_error from the sums of the leaf statistic, for strategies with
+  * a linear error estimate.
+  */
+  virtual std::vector<std::pair<double, double>> compute_error_from_sums(size_t sample,
+                                                                         const std::vector<double>& average,
+                                                                         const LeafStatisticSums& sums,
+                                                                         const Data& data) const {
+    throw std::runtime_error("This prediction strategy does not have a linear error estimate.");
+  }
+
+ /**
+  * Whether this strategy summarizes each leaf by a varying number of entries, stored in
+  * SparsePredictionValues, instead of prediction_value_length() values. A prediction
+  * is then computed by predict_sparse from the entries of the leaves the test sample
+  * landed in, and no variance or error estimates are computed from the individual
+  * leaves: compute_variance is passed no values, and compute_error is not called.
+  */
+  virtual bool has_sparse_prediction_values() const {
+    return false;
+  }
+
+ /**
+  * Precomputes the sparse summary of each leaf during training, for strategies with
+  * sparse prediction values. Other strategies store none.
+  */
+  virtual SparsePredictionValues precompute_sparse_prediction_values(
+      const LeafSamples& leaf_samples,
+      const Data& data) const {
+    return SparsePredictionValues();
+  }
+
+ /**
+  * Computes a prediction for a single test sample, for strategies with sparse
+  * prediction values.
+  *
+  * leaf_entries: the entries of every non-empty leaf this test sample landed in, one
+  *     per tree, in order of the trees.
+  * workspace: scratch space that is not shared with other threads.
+  */
+  virtual std::vector<double> predict_sparse(const std::vector<SparseEntries>& leaf_entries,
+                                             SparsePredictionWorkspace& workspace) const {
+    throw std::runtime_error("This prediction strategy does not have sparse prediction values.");
+  }
+
+ /**
+  * Computes a prediction for test sample `sample` of `data`, for strategies with sparse
+  * prediction values. By default this is predict_sparse(leaf_entries, workspace);
+  * strategies whose predictions also depend on the covariates of the test sample, such
+  * as local linear corrections, override it.
+  */
+  virtual std::vector<double> predict_sparse_sample(size_t sample,
+                                                    const std::vector<SparseEntries>& leaf_entries,
+                                                    const Data& data,
+                                                    SparsePredictionWorkspace& workspace) const {
+    return predict_sparse(leaf_entries, workspace);
+  }
 };
 
 } // namespace grf
@@ -0,0 +1,199 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "prediction/OptimizedQuantilePredictionStrategy.h"
+
+namespace grf {
+
+const std::size_t OptimizedQuantilePredictionStrategy::OUTCOME = 0;
+const std::size_t OptimizedQuantilePredictionStrategy::WEIGHT = 1;
+const std::size_t OptimizedQuantilePredictionStrategy::NUM_TYPES = 2;
+const std::size_t OptimizedQuantilePredictionStrategy::SORTED_SELECTION_SIZE = 32;
+
+OptimizedQuantilePredictionStrategy::OptimizedQuantilePredictionStrategy(std::vector<double> quantiles,
+                                                                         std::vector<double> outcome_grid):
+    quantiles(quantiles),
+    outcome_grid(outcome_grid) {
+  if (!std::is_sorted(outcome_grid.begin(), outcome_grid.end())) {
+    throw std::runtime_error("OptimizedQuantilePredictionStrategy: the outcome grid must be sorted.");
+  }
+}
+
+size_t OptimizedQuantilePredictionStrategy::prediction_length() const {
+  return quantiles.size();
+}
+
+std::vector<double> OptimizedQuantilePredictionStrategy::predict(const std::vector<double>& average) const {
+  throw std::runtime_error("OptimizedQuantilePredictionStrategy predicts from sparse prediction values.");
+}
+
+std::vector<double> OptimizedQuantilePredictionStrategy::compute_variance(
+    const std::vector<double>& average,
+    const PredictionValues& leaf_values,
+    size_t ci_group_size) const {
+  return { 0.0 };
+}
+
+size_t OptimizedQuantilePredictionStrategy::prediction_value_length() const {
+  return 0;
+}
+
+PredictionValues OptimizedQuantilePredictionStrategy::precompute_prediction_values(
+    const LeafSamples& leaf_samples,
+    const Data& data) const {
+  return PredictionValues();
+}
+
+std::vector<std::pair<double, double>> OptimizedQuantilePredictionStrategy::compute_error(
+    size_t sample,
+    const std::vector<double>& average,
+    const PredictionValues& leaf_values,
+    const Data& data) const {
+  return { std::make_pair<double, double>(NAN, NAN) };
+}
+
+bool OptimizedQuantilePredictionStrategy::has_sparse_prediction_values() const {
+  return true;
+}
+
+SparsePredictionValues OptimizedQuantilePredictionStrategy::precompute_sparse_prediction_values(
+    const LeafSamples& leaf_samples,
+    const Data& data) const {
+  size_t num_leaves = leaf_samples.size();
+  std::vector<std::vector<double>> values(num_leaves);
+  std::vector<double> outcomes;
+
+  for (size_t i = 0; i < num_leaves; ++i) {
+    LeafSampleSpan samples = leaf_samples[i];
+    if (samples.empty()) {
+      continue;
+    }
+
+    outcomes.clear();
+    for (size_t sample : samples) {
+      outcomes.push_back(get_leaf_outcome(data, sample));
+    }
+    std::sort(outcomes.begin(), outcomes.end());
+
+    // One run per distinct outcome, in increasing order of outcome.
+    std::vector<double>& leaf_values = values[i];
+    for (size_t j = 0; j < outcomes.size(); ++j) {
+      if (j == 0 || outcomes[j] != outcomes[j - 1]) {
+        leaf_values.insert(leaf_values.end(), {outcomes[j], 0.0});
+      }
+      leaf_values[leaf_values.size() - NUM_TYPES + WEIGHT] += 1.0;
+    }
+
+    for (size_t j = 0; j < leaf_values.size(); j += NUM_TYPES) {
+      leaf_values[j + WEIGHT] /= samples.size();
+    }
+  }
+
+  return SparsePredictionValues(values, NUM_TYPES);
+}
+
+std::vector<double> OptimizedQuantilePredictionStrategy::predict_sparse(
+    const std::vector<SparseEntries>& leaf_entries,
+    SparsePredictionWorkspace& workspace) const {
+  std::vector<std::pair<double, double>>& runs = workspace.weighted_values;
+  runs.clear();
+  for (const SparseEntries& entries : leaf_entries) {
+    for (size_t i = 0; i < entries.num_entries; i++) {
+      const double* run = entries.values + i * NUM_TYPES;
+      runs.emplace_back(run[OUTCOME], run[WEIGHT]);
+    }
+  }
+
+  // The weights of each leaf sum to one, so the quantiles are compared with the
+  // cumulative weight divided by the number of leaves.
+  std::vector<double> targets;
+  targets.reserve(quantiles.size());
+  for (double quantile : quantiles) {
+    targets.push_back(quantile * leaf_entries.size());
+  }
+
+  std::vector<double> quantile_cutoffs(quantiles.size());
+  select_quantiles(runs.begin(), runs.end(), 0.0, targets.data(), targets.size(), quantile_cutoffs.data());
+  return quantile_cutoffs;
+}
+
+void OptimizedQuantilePredictionStrategy::select_quantiles(std::vector<std::pair<double, double>>::iterator begin,
+                                                           std::vector<std::pair<double, double>>::iterator end,
+                                                           double weight_before,
+                                                           const double* targets,
+                                                           size_t num_targets,
+                                                           double* cutoffs) const {
+  if (num_targets == 0) {
+    return;
+  }
+
+  if (end - begin <= static_cast<std::ptrdiff_t>(SORTED_SELECTION_SIZE)) {
+    std::sort(begin, end);
+    double cumulative_weight = weight_before;
+    size_t target = 0;
+    for (auto run = begin; run != end && target < num_targets; ++run) {
+      cumulative_weight += run->second;
+      while (target < num_targets && cumulative_weight >= targets[target]) {
+        cutoffs[target++] = run->first;
+      }
+    }
+
+    // Targets that the summed weights fall short of, through rounding, get the largest outcome.
+    for (; target < num_targets; target++) {
+      cutoffs[target] = (end - 1)->first;
+    }
+    return;
+  }
+
+  // Partition around the middle run, and send each target to the side where it is reached.
+  auto middle = begin + (end - begin) / 2;
+  std::nth_element(begin, middle, end);
+  double cumulative_weight = weight_before;
+  for (auto run = begin; run <= middle; ++run) {
+    cumulative_weight += run->second;
+  }
+
+  size_t num_left_targets = std::upper_bound(targets, targets + num_targets, cumulative_weight) - targets;
+  select_quantiles(begin, middle + 1, weight_before, targets, num_left_targets, cutoffs);
+  select_quantiles(middle + 1, end, cumulative_weight, targets + num_left_targets,
+                   num_targets - num_left_targets, cutoffs + num_left_targets);
+}
+
+double OptimizedQuantilePredictionStrategy::get_leaf_outcome(const Data& data, size_t sample) const {
+  double outcome = data.get_outcome(sample);
+  if (outcome_grid.empty()) {
+    return outcome;
+  }
+
+  auto grid_value = std::lower_bound(outcome_grid.begin(), outcome_grid.end(), outcome);
+  if (grid_value == outcome_grid.end()) {
+    throw std::runtime_error("OptimizedQuantilePredictionStrategy: outcome " + std::to_string(outcome) +
+                             " of sample " + std::to_string(sample) + " is above the outcome grid.");
+  }
+  return *grid_value;
+}
+
+} // namespace grf
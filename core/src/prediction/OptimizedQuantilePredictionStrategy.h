@@ -0,0 +1,131 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_OPTIMIZEDQUANTILEPREDICTIONSTRATEGY_H
+#define GRF_OPTIMIZEDQUANTILEPREDICTIONSTRATEGY_H
+
+#include <cstddef>
+#include <vector>
+
+#include "commons/Data.h"
+#include "prediction/OptimizedPredictionStrategy.h"
+#include "prediction/PredictionValues.h"
+#include "prediction/SparsePredictionValues.h"
+
+namespace grf {
+
+/**
+ * Computes quantiles of the forest-weighted outcome distribution from the sorted
+ * outcomes of each leaf, precomputed during training.
+ *
+ * A leaf stores one (outcome, weight) run for each distinct outcome it holds, in
+ * increasing order of outcome, as sparse prediction values. The weight is the count of
+ * the outcome divided by the leaf size. A prediction gathers the runs of its leaves and
+ * finds the quantiles by weighted selection: it partitions the runs around a middle
+ * outcome, as in quickselect, and continues on the side each quantile falls in, sorting
+ * only small ranges. Unlike QuantilePredictionStrategy, it neither accumulates weights
+ * per neighbor nor sorts the neighbors of every test sample, and its work and memory do
+ * not depend on the number of distinct outcomes.
+ * The predictions are those of QuantilePredictionStrategy, except where a cumulative
+ * weight equals a quantile exactly, as the two sum the weights in different orders:
+ * there the cutoff is either of the two outcomes the quantile falls between. Such ties
+ * are common for round quantiles like the default 0.1, 0.5 and 0.9.
+ *
+ * Optionally, the outcomes are first rounded up to a fixed outcome grid: each outcome is
+ * replaced by the first grid value at least as large. This approximate mode merges
+ * fewer runs when the grid is coarser than the outcomes, and rounds each quantile up to
+ * the next grid value. An outcome above the largest grid value is rejected.
+ */
+class OptimizedQuantilePredictionStrategy final: public OptimizedPredictionStrategy {
+public:
+  static const std::size_t OUTCOME;
+  static const std::size_t WEIGHT;
+  static const std::size_t NUM_TYPES;
+
+  /**
+   * quantiles: the quantiles to predict, in increasing order.
+   *
+   * outcome_grid: if non-empty, the increasing grid the training outcomes are rounded up
+   * to. Only used in training.
+   */
+  OptimizedQuantilePredictionStrategy(std::vector<double> quantiles,
+                                      std::vector<double> outcome_grid = {});
+
+  size_t prediction_length() const;
+
+  /**
+   * Predictions are computed by predict_sparse.
+   */
+  std::vector<double> predict(const std::vector<double>& average) const;
+
+  std::vector<double> compute_variance(
+      const std::vector<double>& average,
+      const PredictionValues& leaf_values,
+      size_t ci_group_size) const;
+
+  size_t prediction_value_length() const;
+
+  PredictionValues precompute_prediction_values(
+      const LeafSamples& leaf_samples,
+      const Data& data) const;
+
+  std::vector<std::pair<double, double>> compute_error(
+      size_t sample,
+      const std::vector<double>& average,
+      const PredictionValues& leaf_values,
+      const Data& data) const;
+
+  bool has_sparse_prediction_values() const;
+
+  SparsePredictionValues precompute_sparse_prediction_values(
+      const LeafSamples& leaf_samples,
+      const Data& data) const;
+
+  std::vector<double> predict_sparse(const std::vector<SparseEntries>& leaf_entries,
+                                     SparsePredictionWorkspace& workspace) const;
+
+private:
+  // Runs are sorted instead of partitioned once a range holds at most this many.
+  static const std::size_t SORTED_SELECTION_SIZE;
+
+  /**
+   * Finds the quantile cutoffs for the increasing cumulative weights `targets` among the
+   * (outcome, weight) runs in [begin, end), which are reordered. The cutoff of a target is
+   * the smallest outcome at which the cumulative weight, starting from `weight_before`,
+   * reaches it, or the largest outcome if none does.
+   */
+  void select_quantiles(std::vector<std::pair<double, double>>::iterator begin,
+                        std::vector<std::pair<double, double>>::iterator end,
+                        double weight_before,
+                        const double* targets,
+                        size_t num_targets,
+                        double* cutoffs) const;
+
+  /**
+   * The outcome of `sample`, rounded up to the outcome grid if there is one.
+   */
+  double get_leaf_outcome(const Data& data, size_t sample) const;
+
+  std::vector<double> quantiles;
+  std::vector<double> outcome_grid;
+};
+
+} // namespace grf
+
+#endif //GRF_OPTIMIZEDQUANTILEPREDICTIONSTRATEGY_H
@@ -0,0 +1,157 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "prediction/OptimizedSurvivalPredictionStrategy.h"
+
+namespace grf {
+
+const std::size_t OptimizedSurvivalPredictionStrategy::TIME = 0;
+const std::size_t OptimizedSurvivalPredictionStrategy::FAILURE = 1;
+const std::size_t OptimizedSurvivalPredictionStrategy::CENSOR = 2;
+const std::size_t OptimizedSurvivalPredictionStrategy::NUM_TYPES = 3;
+
+OptimizedSurvivalPredictionStrategy::OptimizedSurvivalPredictionStrategy(size_t num_failures,
+                                                                         int prediction_type):
+  num_failures(num_failures),
+  prediction_type(prediction_type),
+  survival_strategy(num_failures, prediction_type) {}
+
+size_t OptimizedSurvivalPredictionStrategy::prediction_length() const {
+  return num_failures;
+}
+
+std::vector<double> OptimizedSurvivalPredictionStrategy::predict(const std::vector<double>& average) const {
+  throw std::runtime_error("OptimizedSurvivalPredictionStrategy predicts from sparse prediction values.");
+}
+
+std::vector<double> OptimizedSurvivalPredictionStrategy::compute_variance(
+    const std::vector<double>& average,
+    const PredictionValues& leaf_values,
+    size_t ci_group_size) const {
+  return { 0.0 };
+}
+
+size_t OptimizedSurvivalPredictionStrategy::prediction_value_length() const {
+  return 0;
+}
+
+PredictionValues OptimizedSurvivalPredictionStrategy::precompute_prediction_values(
+    const LeafSamples& leaf_samples,
+    const Data& data) const {
+  return PredictionValues();
+}
+
+std::vector<std::pair<double, double>> OptimizedSurvivalPredictionStrategy::compute_error(
+    size_t sample,
+    const std::vector<double>& average,
+    const PredictionValues& leaf_values,
+    const Data& data) const {
+  return { std::make_pair<double, double>(NAN, NAN) };
+}
+
+bool OptimizedSurvivalPredictionStrategy::has_sparse_prediction_values() const {
+  return true;
+}
+
+SparsePredictionValues OptimizedSurvivalPredictionStrategy::precompute_sparse_prediction_values(
+    const LeafSamples& leaf_samples,
+    const Data& data) const {
+  size_t num_leaves = leaf_samples.size();
+  std::vector<std::vector<double>> values(num_leaves);
+  std::vector<std::pair<size_t, size_t>> times_and_samples;
+
+  for (size_t i = 0; i < num_leaves; ++i) {
+    LeafSampleSpan samples = leaf_samples[i];
+    if (samples.empty()) {
+      continue;
+    }
+
+    times_and_samples.clear();
+    for (size_t sample : samples) {
+      times_and_samples.emplace_back(static_cast<size_t>(data.get_outcome(sample)), sample);
+    }
+    std::sort(times_and_samples.begin(), times_and_samples.end());
+
+    // One run per event time, in increasing order of time.
+    std::vector<double>& leaf_values = values[i];
+    for (size_t j = 0; j < times_and_samples.size(); ++j) {
+      size_t time = times_and_samples[j].first;
+      size_t sample = times_and_samples[j].second;
+      if (j == 0 || time != times_and_samples[j - 1].first) {
+        leaf_values.insert(leaf_values.end(), {static_cast<double>(time), 0.0, 0.0});
+      }
+      double* run = &leaf_values[leaf_values.size() - NUM_TYPES];
+      run[data.is_failure(sample) ? FAILURE : CENSOR] += data.get_weight(sample);
+    }
+
+    for (size_t j = 0; j < leaf_values.size(); j += NUM_TYPES) {
+      leaf_values[j + FAILURE] /= samples.size();
+      leaf_values[j + CENSOR] /= samples.size();
+    }
+  }
+
+  return SparsePredictionValues(values, NUM_TYPES);
+}
+
+std::vector<double> OptimizedSurvivalPredictionStrategy::predict_sparse(
+    const std::vector<SparseEntries>& leaf_entries,
+    SparsePredictionWorkspace& workspace) const {
+  std::vector<double>& count_failure = workspace.count_failure;
+  std::vector<double>& count_censor = workspace.count_censor;
+  count_failure.assign(num_failures + 1, 0.0);
+  count_censor.assign(num_failures + 1, 0.0);
+
+  for (const SparseEntries& entries : leaf_entries) {
+    for (size_t i = 0; i < entries.num_entries; i++) {
+      const double* run = entries.values + i * NUM_TYPES;
+      size_t time = static_cast<size_t>(run[TIME]);
+      count_failure[time] += run[FAILURE];
+      count_censor[time] += run[CENSOR];
+    }
+  }
+
+  // Each leaf's counts sum to its mean sample weight, so scaling by one over the number
+  // of leaves gives the counts under the normalized forest weights.
+  double scale = 1.0 / leaf_entries.size();
+  double sum = 0;
+  for (size_t time = 0; time <= num_failures; time++) {
+    count_failure[time] *= scale;
+    count_censor[time] *= scale;
+    sum += count_failure[time] + count_censor[time];
+  }
+
+  // All the neighbors have zero sample weight.
+  if (std::abs(sum) <= 1e-16) {
+    return std::vector<double>();
+  }
+
+  if (prediction_type == SurvivalPredictionStrategy::NELSON_AALEN) {
+    return survival_strategy.predict_nelson_aalen(count_failure, count_censor, sum);
+  } else {
+    return survival_strategy.predict_kaplan_meier(count_failure, count_censor, sum);
+  }
+}
+
+} // namespace grf
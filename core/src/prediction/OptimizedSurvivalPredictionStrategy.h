@@ -0,0 +1,107 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_OPTIMIZEDSURVIVALPREDICTIONSTRATEGY_H
+#define GRF_OPTIMIZEDSURVIVALPREDICTIONSTRATEGY_H
+
+#include <cstddef>
+
+#include "commons/Data.h"
+#include "prediction/OptimizedPredictionStrategy.h"
+#include "prediction/PredictionValues.h"
+#include "prediction/SparsePredictionValues.h"
+#include "prediction/SurvivalPredictionStrategy.h"
+
+namespace grf {
+
+/**
+ * Computes the Kaplan-Meier or Nelson-Aalen estimates of SurvivalPredictionStrategy
+ * from failure and censoring counts precomputed for each leaf on the failure time grid,
+ * instead of from the forest weights of every neighbor.
+ *
+ * A leaf stores one (time, failure count, censor count) run for each event time among
+ * its samples, in increasing order of time, as sparse prediction values. The counts sum
+ * the sample weights of the failures and censored samples at that time, divided by the
+ * leaf size. A prediction adds the runs of its leaves into counts on the grid, scaled by
+ * one over the number of leaves, which are the forest-weighted counts that
+ * SurvivalPredictionStrategy accumulates neighbor by neighbor. Its work is proportional
+ * to the number of runs and failure times, not to the number of neighbors, and it looks
+ * up nothing in the training data. As the counts are summed in a different order, the
+ * estimates agree with SurvivalPredictionStrategy up to floating point rounding.
+ *
+ * Variance estimates are not supported, as in SurvivalPredictionStrategy.
+ */
+class OptimizedSurvivalPredictionStrategy final: public OptimizedPredictionStrategy {
+public:
+  static const std::size_t TIME;
+  static const std::size_t FAILURE;
+  static const std::size_t CENSOR;
+  static const std::size_t NUM_TYPES;
+
+  /**
+   * num_failures: the count of failures in the training data. The event times
+   * retrieved from data.get_outcome(sample) are integers in 0, ..., num_failures.
+   *
+   * prediction_type: SurvivalPredictionStrategy::KAPLAN_MEIER or NELSON_AALEN.
+   */
+  OptimizedSurvivalPredictionStrategy(size_t num_failures,
+                                      int prediction_type);
+
+  size_t prediction_length() const;
+
+  /**
+   * Predictions are computed by predict_sparse.
+   */
+  std::vector<double> predict(const std::vector<double>& average) const;
+
+  std::vector<double> compute_variance(
+      const std::vector<double>& average,
+      const PredictionValues& leaf_values,
+      size_t ci_group_size) const;
+
+  size_t prediction_value_length() const;
+
+  PredictionValues precompute_prediction_values(
+      const LeafSamples& leaf_samples,
+      const Data& data) const;
+
+  std::vector<std::pair<double, double>> compute_error(
+      size_t sample,
+      const std::vector<double>& average,
+      const PredictionValues& leaf_values,
+      const Data& data) const;
+
+  bool has_sparse_prediction_values() const;
+
+  SparsePredictionValues precompute_sparse_prediction_values(
+      const LeafSamples& leaf_samples,
+      const Data& data) const;
+
+  std::vector<double> predict_sparse(const std::vector<SparseEntries>& leaf_entries,
+                                     SparsePredictionWorkspace& workspace) const;
+
+private:
+  size_t num_failures;
+  int prediction_type;
+  SurvivalPredictionStrategy survival_strategy;
+};
+
+} // namespace grf
+
+#endif //GRF_OPTIMIZEDSURVIVALPREDICTIONSTRATEGY_H
@@ -17,6 +17,10 @@
   along with grf. If not, see <http://www.gnu.org/licenses/>.
  #-------------------------------------------------------------------------------*/
 
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
 #include "prediction/PredictionValues.h"
 
 namespace grf {
@@ -27,26 +31,46 @@ PredictionValues::PredictionValues():
 
 PredictionValues::PredictionValues(const std::vector<std::vector<double>>& values,
                                    size_t num_types):
-  values(values),
-  num_nodes(values.size()),
-  num_types(num_types) {}
-
-
-
-double PredictionValues::get(std::size_t node, size_t type) const {
-  return values.at(node).at(type);
+  PredictionValues(values.size(), num_types) {
+  for (size_t node = 0; node < num_nodes; node++) {
+    const std::vector<double>& node_values = values[node];
+    if (node_values.empty()) {
+      continue;
+    }
+    if (node_values.size() != num_types) {
+      throw std::runtime_error("Prediction values of node " + std::to_string(node) +
+                               " do not have the expected length.");
+    }
+    std::copy(node_values.begin(), node_values.end(), initialize_values(node));
+  }
 }
 
-const std::vector<double>& PredictionValues::get_values(std::size_t node) const {
-  return values.at(node);
+PredictionValues::PredictionValues(size_t num_nodes,
+                                   size_t num_types):
+  values(num_nodes * num_types, 0.0),
+  empty_nodes(num_nodes, true),
+  num_nodes(num_nodes),
+  num_types(num_types) {}
+
+double* PredictionValues::initialize_values(size_t node) {
+  empty_nodes[node] = false;
+  double* node_values = values.data() + node * num_types;
+  std::fill(node_values, node_values + num_types, 0.0);
+  return node_values;
 }
 
-bool PredictionValues::empty(std::size_t node) const {
-  return values.at(node).empty();
+void PredictionValues::clear() {
+  std::fill(empty_nodes.begin(), empty_nodes.end(), true);
 }
 
-const std::vector<std::vector<double>>& PredictionValues::get_all_values() const {
-  return values;
+std::vector<std::vector<double>> PredictionValues::get_all_values() const {
+  std::vector<std::vector<double>> all_values(num_nodes);
+  for (size_t node = 0; node < num_nodes; node++) {
+    if (!empty(node)) {
+      all_values[node].assign(get_values(node), get_values(node) + num_types);
+    }
+  }
+  return all_values;
 }
 
 const size_t PredictionValues::get_num_nodes() const {
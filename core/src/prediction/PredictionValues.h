@@ -25,32 +25,76 @@
 
 namespace grf {
 
+/**
+ * Summary values for every node of a tree, precomputed by an optimized prediction
+ * strategy. The values are stored node by node in one array, `num_types` values per
+ * node, and a bitmap records which nodes are empty, so that reading the values of a
+ * leaf touches one contiguous range of memory.
+ */
 class PredictionValues {
 public:
   PredictionValues();
 
+  /**
+   * The values of every node given as one vector per node. A vector must be either
+   * empty or hold num_types values.
+   */
   PredictionValues(const std::vector<std::vector<double>>& values,
                    size_t num_types);
 
+  /**
+   * Values for `num_nodes` nodes that are all empty, to be filled in with
+   * `initialize_values`.
+   */
+  PredictionValues(size_t num_nodes,
+                   size_t num_types);
+
+  /**
+   * Marks `node` as non-empty, and returns its num_types values, set to zero.
+   */
+  double* initialize_values(size_t node);
+
+  /**
+   * Marks every node as empty, so that the same storage can be filled in again.
+   */
+  void clear();
 
   double get(size_t node, size_t type) const;
-  const std::vector<double>& get_values(size_t node) const;
+
+  /**
+   * The num_types values of a node.
+   */
+  const double* get_values(size_t node) const;
+
   bool empty(size_t node) const;
 
   /**
    *  Returns all prediction values in this object. Values are
-   *  organized first by node, then by type.
+   *  organized first by node, then by type, and empty nodes have no values.
    */
-  const std::vector<std::vector<double>>& get_all_values() const;
+  std::vector<std::vector<double>> get_all_values() const;
   const size_t get_num_nodes() const;
   const size_t get_num_types() const;
 
 private:
-  std::vector<std::vector<double>> values;
+  std::vector<double> values;
+  std::vector<bool> empty_nodes;
   size_t num_nodes;
   size_t num_types;
 };
 
+inline double PredictionValues::get(size_t node, size_t type) const {
+  return values[node * num_types + type];
+}
+
+inline const double* PredictionValues::get_values(size_t node) const {
+  return values.data() + node * num_types;
+}
+
+inline bool PredictionValues::empty(size_t node) const {
+  return empty_nodes[node];
+}
+
 } // namespace grf
 
 #endif //GRF_PREDICTIONVALUES_H
@@ -102,40 +102,41 @@ size_t ProbabilityPredictionStrategy::prediction_value_length() const {
 }
 
 PredictionValues ProbabilityPredictionStrategy::precompute_prediction_values(
-    const std::vector<std::vector<size_t>>& leaf_samples,
+    const LeafSamples& leaf_samples,
     const Data& data) const {
   size_t num_leaves = leaf_samples.size();
-  std::vector<std::vector<double>> values(num_leaves);
+  PredictionValues values(num_leaves, num_types);
 
   for (size_t i = 0; i < num_leaves; i++) {
-    const std::vector<size_t>& leaf_node = leaf_samples.at(i);
+    LeafSampleSpan leaf_node = leaf_samples[i];
     if (leaf_node.empty()) {
       continue;
     }
 
-    std::vector<double>& averages = values[i];
-    averages.resize(num_types);
     double weight_sum = 0.0;
     for (auto& sample : leaf_node) {
-      // The data Yi will be relabeled to integers {0, ..., num_classes - 1}
-      size_t sample_class = static_cast<size_t>(data.get_outcome(sample));
-      averages[sample_class] += data.get_weight(sample);
       weight_sum += data.get_weight(sample);
     }
     // if total weight is very small, treat the leaf as empty
     if (std::abs(weight_sum) <= 1e-16) {
-      averages.clear();
       continue;
     }
+
     // store sufficient statistics in order
     // {class_counts_1, ..., class_counts_K, sum_weight}
+    double* averages = values.initialize_values(i);
+    for (auto& sample : leaf_node) {
+      // The data Yi will be relabeled to integers {0, ..., num_classes - 1}
+      size_t sample_class = static_cast<size_t>(data.get_outcome(sample));
+      averages[sample_class] += data.get_weight(sample);
+    }
     for (size_t cls = 0; cls < num_classes; ++cls) {
       averages[cls] = averages[cls] / leaf_node.size();
     }
     averages[weight_index] = weight_sum / leaf_node.size();
   }
 
-  return PredictionValues(values, num_types);
+  return values;
 }
 
 std::vector<std::pair<double, double>> ProbabilityPredictionStrategy::compute_error(
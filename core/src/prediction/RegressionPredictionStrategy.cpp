@@ -54,41 +54,40 @@ std::vector<double> RegressionPredictionStrategy::compute_variance(
     const std::vector<double>& average,
     const PredictionValues& leaf_values,
     size_t ci_group_size) const {
+  LeafStatisticSums sums(compute_leaf_statistic_coefficients(average), ci_group_size);
+  for (size_t n = 0; n < leaf_values.get_num_nodes(); n++) {
+    sums.add(leaf_values.empty(n) ? nullptr : leaf_values.get_values(n));
+  }
+  return compute_variance_from_sums(average, sums, ci_group_size);
+}
 
-  double average_weight = average.at(WEIGHT);
-  double average_outcome = average.at(OUTCOME) / average_weight;
-
-  double num_good_groups = 0;
-  double rho_squared = 0;
-  double rho_grouped_squared = 0;
-
-  for (size_t group = 0; group < leaf_values.get_num_nodes() / ci_group_size; ++group) {
-    bool good_group = true;
-    for (size_t j = 0; j < ci_group_size; ++j) {
-      if (leaf_values.empty(group * ci_group_size + j)) {
-        good_group = false;
-      }
-    }
-    if (!good_group) continue;
-
-    num_good_groups++;
-
-    double group_rho = 0;
+bool RegressionPredictionStrategy::has_linear_variance() const {
+  return true;
+}
 
-    for (size_t j = 0; j < ci_group_size; ++j) {
-      size_t i = group * ci_group_size + j;
-      double rho = (leaf_values.get(i, OUTCOME) - average_outcome * leaf_values.get(i, WEIGHT)) / average_weight;
+bool RegressionPredictionStrategy::has_linear_error() const {
+  return true;
+}
 
-      rho_squared += rho * rho;
-      group_rho += rho;
-    }
+std::vector<double> RegressionPredictionStrategy::compute_leaf_statistic_coefficients(
+    const std::vector<double>& average) const {
+  double average_weight = average.at(WEIGHT);
+  double average_outcome = average.at(OUTCOME) / average_weight;
 
-    group_rho /= ci_group_size;
-    rho_grouped_squared += group_rho * group_rho;
-  }
+  // rho = (outcome - average_outcome * weight) / average_weight.
+  std::vector<double> coefficients(2);
+  coefficients[OUTCOME] = 1 / average_weight;
+  coefficients[WEIGHT] = -average_outcome / average_weight;
+  return coefficients;
+}
 
-  double var_between = rho_grouped_squared / num_good_groups;
-  double var_total = rho_squared / (num_good_groups * ci_group_size);
+std::vector<double> RegressionPredictionStrategy::compute_variance_from_sums(
+    const std::vector<double>& average,
+    const LeafStatisticSums& sums,
+    size_t ci_group_size) const {
+  double num_good_groups = sums.get_num_good_groups();
+  double var_between = sums.get_rho_grouped_squared() / num_good_groups;
+  double var_total = sums.get_rho_squared() / (num_good_groups * ci_group_size);
 
   // This is the amount by which var_between is inflated due to using small groups
   double group_noise = (var_total - var_between) / (ci_group_size - 1);
@@ -102,19 +101,18 @@ std::vector<double> RegressionPredictionStrategy::compute_variance(
   return { var_debiased };
 }
 
-
 size_t RegressionPredictionStrategy::prediction_value_length() const {
   return 2;
 }
 
 PredictionValues RegressionPredictionStrategy::precompute_prediction_values(
-    const std::vector<std::vector<size_t>>& leaf_samples,
+    const LeafSamples& leaf_samples,
     const Data& data) const {
   size_t num_leaves = leaf_samples.size();
-  std::vector<std::vector<double>> values(num_leaves);
+  PredictionValues values(num_leaves, 2);
 
   for (size_t i = 0; i < num_leaves; i++) {
-    const std::vector<size_t>& leaf_node = leaf_samples.at(i);
+    LeafSampleSpan leaf_node = leaf_samples[i];
     if (leaf_node.empty()) {
       continue;
     }
@@ -131,13 +129,12 @@ PredictionValues RegressionPredictionStrategy::precompute_prediction_values(
       continue;
     }
 
-    std::vector<double>& averages = values[i];
-    averages.resize(2);
+    double* averages = values.initialize_values(i);
     averages[OUTCOME] = sum / leaf_node.size();
     averages[WEIGHT] = weight / leaf_node.size();
   }
 
-  return PredictionValues(values, 2);
+  return values;
 }
 
 std::vector<std::pair<double, double>> RegressionPredictionStrategy::compute_error(
@@ -145,6 +142,18 @@ std::vector<std::pair<double, double>> RegressionPredictionStrategy::compute_err
     const std::vector<double>& average,
     const PredictionValues& leaf_values,
     const Data& data) const {
+  LeafStatisticSums sums(compute_leaf_statistic_coefficients(average), 1);
+  for (size_t n = 0; n < leaf_values.get_num_nodes(); n++) {
+    sums.add(leaf_values.empty(n) ? nullptr : leaf_values.get_values(n));
+  }
+  return compute_error_from_sums(sample, average, sums, data);
+}
+
+std::vector<std::pair<double, double>> RegressionPredictionStrategy::compute_error_from_sums(
+    size_t sample,
+    const std::vector<double>& average,
+    const LeafStatisticSums& sums,
+    const Data& data) const {
   double outcome = data.get_outcome(sample);
 
   double average_weight = average.at(WEIGHT);
@@ -152,23 +161,13 @@ std::vector<std::pair<double, double>> RegressionPredictionStrategy::compute_err
   double error = average_outcome - outcome;
   double mse = error * error;
 
-  double bias = 0.0;
-  size_t num_trees = 0;
-  for (size_t n = 0; n < leaf_values.get_num_nodes(); n++) {
-    if (leaf_values.empty(n)) {
-      continue;
-    }
-
-    double tree_variance = (leaf_values.get(n, OUTCOME) - average_outcome * leaf_values.get(n, WEIGHT)) / average_weight;
-    bias += tree_variance * tree_variance;
-    num_trees++;
-  }
-
+  // Each tree's variance is the leaf statistic rho of its leaf.
+  size_t num_trees = sums.get_num_leaves();
   if (num_trees <= 1) {
     return { std::make_pair<double, double>(NAN, NAN) };
   }
 
-  bias /= num_trees * (num_trees - 1);
+  double bias = sums.get_leaf_rho_squared() / (num_trees * (num_trees - 1));
 
   double debiased_error = mse - bias;
 
@@ -31,7 +31,7 @@ class RegressionPredictionStrategy final: public OptimizedPredictionStrategy {
 public:
   size_t prediction_value_length() const;
 
-  PredictionValues precompute_prediction_values(const std::vector<std::vector<size_t>>& leaf_samples,
+  PredictionValues precompute_prediction_values(const LeafSamples& leaf_samples,
                                                 const Data& data) const;
 
   size_t prediction_length() const;
@@ -49,6 +49,23 @@ public:
       const PredictionValues& leaf_values,
       const Data& data) const;
 
+  bool has_linear_variance() const;
+
+  bool has_linear_error() const;
+
+  std::vector<double> compute_leaf_statistic_coefficients(const std::vector<double>& average) const;
+
+  std::vector<double> compute_variance_from_sums(
+      const std::vector<double>& average,
+      const LeafStatisticSums& sums,
+      size_t ci_group_size) const;
+
+  std::vector<std::pair<double, double>> compute_error_from_sums(
+      size_t sample,
+      const std::vector<double>& average,
+      const LeafStatisticSums& sums,
+      const Data& data) const;
+
 private:
   static const std::size_t OUTCOME;
   static const std::size_t WEIGHT;
@@ -0,0 +1,70 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <stdexcept>
+#include <string>
+
+#include "prediction/SparsePredictionValues.h"
+
+namespace grf {
+
+SparsePredictionValues::SparsePredictionValues():
+  node_offsets(1, 0),
+  entry_length(0) {}
+
+SparsePredictionValues::SparsePredictionValues(const std::vector<std::vector<double>>& values,
+                                               size_t entry_length):
+  node_offsets(1, 0),
+  entry_length(entry_length) {
+  size_t num_values = 0;
+  for (size_t node = 0; node < values.size(); node++) {
+    size_t node_length = values[node].size();
+    if (node_length > 0 && (entry_length == 0 || node_length % entry_length != 0)) {
+      throw std::runtime_error("Sparse prediction values of node " + std::to_string(node) +
+                               " do not have the expected length.");
+    }
+    num_values += node_length;
+  }
+
+  this->values.reserve(num_values);
+  node_offsets.reserve(values.size() + 1);
+  for (const std::vector<double>& node_values : values) {
+    this->values.insert(this->values.end(), node_values.begin(), node_values.end());
+    node_offsets.push_back(entry_length == 0 ? 0 : this->values.size() / entry_length);
+  }
+}
+
+std::vector<std::vector<double>> SparsePredictionValues::get_all_values() const {
+  std::vector<std::vector<double>> all_values(get_num_nodes());
+  for (size_t node = 0; node < get_num_nodes(); node++) {
+    const double* node_values = values.data() + node_offsets[node] * entry_length;
+    all_values[node].assign(node_values, node_values + get_num_entries(node) * entry_length);
+  }
+  return all_values;
+}
+
+size_t SparsePredictionValues::get_num_nodes() const {
+  return node_offsets.size() - 1;
+}
+
+size_t SparsePredictionValues::get_entry_length() const {
+  return entry_length;
+}
+
+} // namespace grf
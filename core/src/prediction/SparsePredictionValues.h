@@ -0,0 +1,93 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_SPARSEPREDICTIONVALUES_H
+#define GRF_SPARSEPREDICTIONVALUES_H
+
+#include <cstddef>
+#include <vector>
+
+namespace grf {
+
+/**
+ * The entries of one node of SparsePredictionValues: `num_entries` entries, each made
+ * of the strategy's entry length of consecutive values, starting at `values`.
+ */
+struct SparseEntries {
+  const double* values;
+  size_t num_entries;
+};
+
+/**
+ * Summary values for every node of a tree, precomputed by an optimized prediction
+ * strategy whose leaf summaries vary in length, such as one entry per sample or per
+ * distinct outcome of the leaf. Every entry holds `entry_length` values.
+ *
+ * Like LeafSamples, the entries of all nodes are stored in one array in order of node
+ * ID, with the offset of the first entry of every node. A node without entries is
+ * empty. Fixed-length summaries are kept in PredictionValues instead, which locates a
+ * node without the offset lookup.
+ */
+class SparsePredictionValues {
+public:
+  SparsePredictionValues();
+
+  /**
+   * The values of every node given as one vector per node. A vector must hold a
+   * multiple of entry_length values, and is empty for an empty node.
+   */
+  SparsePredictionValues(const std::vector<std::vector<double>>& values,
+                         size_t entry_length);
+
+  SparseEntries get_entries(size_t node) const;
+
+  size_t get_num_entries(size_t node) const;
+
+  bool empty(size_t node) const;
+
+  /**
+   *  Returns all values in this object, as one vector per node.
+   */
+  std::vector<std::vector<double>> get_all_values() const;
+  size_t get_num_nodes() const;
+  size_t get_entry_length() const;
+
+private:
+  std::vector<double> values;
+  // The entries of node n start at values[node_offsets[n] * entry_length], and there are
+  // node_offsets[n + 1] - node_offsets[n] of them.
+  std::vector<size_t> node_offsets;
+  size_t entry_length;
+};
+
+inline SparseEntries SparsePredictionValues::get_entries(size_t node) const {
+  return SparseEntries{values.data() + node_offsets[node] * entry_length, get_num_entries(node)};
+}
+
+inline size_t SparsePredictionValues::get_num_entries(size_t node) const {
+  return node_offsets[node + 1] - node_offsets[node];
+}
+
+inline bool SparsePredictionValues::empty(size_t node) const {
+  return node_offsets[node + 1] == node_offsets[node];
+}
+
+} // namespace grf
+
+#endif //GRF_SPARSEPREDICTIONVALUES_H
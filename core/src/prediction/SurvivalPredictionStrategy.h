@@ -51,6 +51,8 @@ public:
    * drawback is, particularly in the case of shallow trees (as will be
    * the case with very few events), more CPU time spent in hash table
    * lookups, as a target sample x will match many training samples.
+   * OptimizedSurvivalPredictionStrategy instead stores sparse failure and
+   * censor counts for each leaf, trading memory for prediction speed.
    */
   SurvivalPredictionStrategy(size_t num_failures,
                              int prediction_type);
@@ -58,19 +60,22 @@ public:
   size_t prediction_length() const;
 
   std::vector<double> predict(size_t prediction_sample,
-    const std::unordered_map<size_t, double>& weights_by_sample,
+    const std::vector<std::pair<size_t, double>>& weights_by_sample,
     const Data& train_data,
     const Data& data) const;
 
   std::vector<double> compute_variance(
     size_t sample,
     const std::vector<std::vector<size_t>>& samples_by_tree,
-    const std::unordered_map<size_t, double>& weights_by_sampleID,
+    const std::vector<std::pair<size_t, double>>& weights_by_sampleID,
     const Data& train_data,
     const Data& data,
     size_t ci_group_size) const;
 
-private:
+  /**
+   * The survival function estimates from the weighted failure and censor counts at
+   * each event time 0, ..., num_failures, where `sum` is the total of all counts.
+   */
   std::vector<double> predict_kaplan_meier(
     const std::vector<double>& count_failure,
     const std::vector<double>& count_censor,
@@ -81,6 +86,7 @@ private:
     const std::vector<double>& count_censor,
     double sum) const;
 
+private:
   size_t num_failures;
   size_t prediction_type;
 };
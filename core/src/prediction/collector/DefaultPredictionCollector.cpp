@@ -17,7 +17,6 @@
   along with grf. If not, see <http://www.gnu.org/licenses/>.
  #-------------------------------------------------------------------------------*/
 
-#include <future>
 #include <stdexcept>
 
 #include "prediction/collector/DefaultPredictionCollector.h"
@@ -25,9 +24,8 @@
 
 namespace grf {
 
-DefaultPredictionCollector::DefaultPredictionCollector(std::unique_ptr<DefaultPredictionStrategy> strategy,
-                                                       uint num_threads):
-    strategy(std::move(strategy)), num_threads(num_threads) {}
+DefaultPredictionCollector::DefaultPredictionCollector(std::unique_ptr<DefaultPredictionStrategy> strategy):
+    strategy(std::move(strategy)) {}
 
 std::vector<Prediction> DefaultPredictionCollector::collect_predictions(
     const Forest& forest,
@@ -36,54 +34,10 @@ std::vector<Prediction> DefaultPredictionCollector::collect_predictions(
     const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
     const std::vector<std::vector<bool>>& valid_trees_by_sample,
     bool estimate_variance,
-    bool estimate_error) const {
-
-  size_t num_samples = data.get_num_rows();
-  std::vector<uint> thread_ranges;
-  split_sequence(thread_ranges, 0, static_cast<uint>(num_samples - 1), num_threads);
-
-  std::vector<std::future<std::vector<Prediction>>> futures;
-  futures.reserve(thread_ranges.size());
-
-  std::vector<Prediction> predictions;
-  predictions.reserve(num_samples);
-
-  for (uint i = 0; i < thread_ranges.size() - 1; ++i) {
-    size_t start_index = thread_ranges[i];
-    size_t num_samples_batch = thread_ranges[i + 1] - start_index;
-
-    futures.push_back(std::async(std::launch::async,
-                                 &DefaultPredictionCollector::collect_predictions_batch,
-                                 this,
-                                 std::ref(forest),
-                                 std::ref(train_data),
-                                 std::ref(data),
-                                 std::ref(leaf_nodes_by_tree),
-                                 std::ref(valid_trees_by_sample),
-                                 estimate_variance,
-                                 start_index,
-                                 num_samples_batch));
-  }
-
-  for (auto& future : futures) {
-    std::vector<Prediction> thread_predictions = future.get();
-    predictions.insert(predictions.end(),
-                       std::make_move_iterator(thread_predictions.begin()),
-                       std::make_move_iterator(thread_predictions.end()));
-  }
-
-  return predictions;
-}
-
-std::vector<Prediction> DefaultPredictionCollector::collect_predictions_batch(
-    const Forest& forest,
-    const Data& train_data,
-    const Data& data,
-    const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
-    const std::vector<std::vector<bool>>& valid_trees_by_sample,
-    bool estimate_variance,
+    bool estimate_error,
     size_t start,
-    size_t num_samples) const {
+    size_t num_samples,
+    Workspace& workspace) const {
   size_t num_trees = forest.get_trees().size();
   bool record_leaf_samples = estimate_variance;
 
@@ -91,8 +45,8 @@ std::vector<Prediction> DefaultPredictionCollector::collect_predictions_batch(
   predictions.reserve(num_samples);
 
   for (size_t sample = start; sample < num_samples + start; ++sample) {
-    std::unordered_map<size_t, double> weights_by_sample = weight_computer.compute_weights(
-        sample, forest, leaf_nodes_by_tree, valid_trees_by_sample);
+    std::vector<std::pair<size_t, double>> weights_by_sample = weight_computer.compute_weights(
+        sample - start, forest, leaf_nodes_by_tree, valid_trees_by_sample, workspace.weight_accumulator);
     std::vector<std::vector<size_t>> samples_by_tree;
 
     // If this sample has no neighbors, then return placeholder predictions. Note
@@ -108,15 +62,16 @@ std::vector<Prediction> DefaultPredictionCollector::collect_predictions_batch(
       samples_by_tree.resize(num_trees);
 
       for (size_t tree_index = 0; tree_index < forest.get_trees().size(); ++tree_index) {
-        if (!valid_trees_by_sample[sample][tree_index]) {
+        if (!valid_trees_by_sample.empty() && !valid_trees_by_sample[sample - start][tree_index]) {
           continue;
         }
         const std::vector<size_t>& leaf_nodes = leaf_nodes_by_tree.at(tree_index);
-        size_t node = leaf_nodes.at(sample);
+        size_t node = leaf_nodes.at(sample - start);
 
         const std::unique_ptr<Tree>& tree = forest.get_trees()[tree_index];
-        const std::vector<std::vector<size_t>>& leaf_samples = tree->get_leaf_samples();
-        samples_by_tree.push_back(leaf_samples.at(node));
+        const LeafSamples& leaf_samples = tree->get_leaf_samples();
+        LeafSampleSpan node_samples = leaf_samples[node];
+        samples_by_tree.emplace_back(node_samples.begin(), node_samples.end());
       }
     }
 
@@ -30,7 +30,7 @@ namespace grf {
 
 class DefaultPredictionCollector final: public PredictionCollector {
 public:
-  DefaultPredictionCollector(std::unique_ptr<DefaultPredictionStrategy> strategy, uint num_threads);
+  DefaultPredictionCollector(std::unique_ptr<DefaultPredictionStrategy> strategy);
 
   /**
    * Collect predictions and variance estimates computed by the DefaultPredictionStrategy.
@@ -43,23 +43,17 @@ public:
                                               const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
                                               const std::vector<std::vector<bool>>& valid_trees_by_sample,
                                               bool estimate_variance,
-                                              bool estimate_error) const;
+                                              bool estimate_error,
+                                              size_t start,
+                                              size_t num_samples,
+                                              Workspace& workspace) const;
 
 private:
-  std::vector<Prediction> collect_predictions_batch(const Forest& forest,
-                                                    const Data& train_data,
-                                                    const Data& data,
-                                                    const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
-                                                    const std::vector<std::vector<bool>>& valid_trees_by_sample,
-                                                    bool estimate_variance,
-                                                    size_t start,
-                                                    size_t num_samples) const;
 
   void validate_prediction(size_t sample, const Prediction& prediction) const;
 
   std::unique_ptr<DefaultPredictionStrategy> strategy;
   SampleWeightComputer weight_computer;
-  uint num_threads;
 };
 
 } // namespace grf
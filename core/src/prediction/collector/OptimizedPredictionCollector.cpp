@@ -17,7 +17,7 @@
   along with grf. If not, see <http://www.gnu.org/licenses/>.
  #-------------------------------------------------------------------------------*/
 
-#include <future>
+#include <algorithm>
 #include <stdexcept>
 
 #include "prediction/collector/OptimizedPredictionCollector.h"
@@ -25,8 +25,8 @@
 
 namespace grf {
 
-OptimizedPredictionCollector::OptimizedPredictionCollector(std::unique_ptr<OptimizedPredictionStrategy> strategy, uint num_threads):
-    strategy(std::move(strategy)), num_threads(num_threads) {}
+OptimizedPredictionCollector::OptimizedPredictionCollector(std::unique_ptr<OptimizedPredictionStrategy> strategy):
+    strategy(std::move(strategy)) {}
 
 std::vector<Prediction> OptimizedPredictionCollector::collect_predictions(const Forest& forest,
                                                                           const Data& train_data,
@@ -34,88 +34,70 @@ std::vector<Prediction> OptimizedPredictionCollector::collect_predictions(const
                                                                           const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
                                                                           const std::vector<std::vector<bool>>& valid_trees_by_sample,
                                                                           bool estimate_variance,
-                                                                          bool estimate_error) const {
-  size_t num_samples = data.get_num_rows();
-  std::vector<uint> thread_ranges;
-  split_sequence(thread_ranges, 0, static_cast<uint>(num_samples - 1), num_threads);
-
-  std::vector<std::future<std::vector<Prediction>>> futures;
-  futures.reserve(thread_ranges.size());
+                                                                          bool estimate_error,
+                                                                          size_t start,
+                                                                          size_t num_samples,
+                                                                          Workspace& workspace) const {
+  if (strategy->has_sparse_prediction_values()) {
+    return collect_sparse_predictions(forest, data, leaf_nodes_by_tree, valid_trees_by_sample,
+                                      estimate_variance, start, num_samples, workspace);
+  }
 
-  std::vector<Prediction> predictions;
-  predictions.reserve(num_samples);
+  size_t num_trees = forest.get_trees().size();
+  size_t num_types = strategy->prediction_value_length();
+  // Strategies whose estimates are linear in each leaf's values are summed by group of
+  // trees while visiting the leaves; the others get a copy of every leaf's values.
+  bool record_leaf_values = (estimate_variance && !strategy->has_linear_variance())
+      || (estimate_error && !strategy->has_linear_error());
+  bool sum_leaf_statistics = (estimate_variance || estimate_error) && !record_leaf_values;
+
+  // Accumulate the leaf values tree by tree, so that each tree's prediction values
+  // are scattered to the samples of the block in one pass.
+  std::vector<double> average_values(num_samples * num_types, 0.0);
+  std::vector<uint> num_leaves_by_sample(num_samples, 0);
+
+  for (size_t tree_index = 0; tree_index < num_trees; ++tree_index) {
+    const std::vector<size_t>& leaf_nodes = leaf_nodes_by_tree.at(tree_index);
+    const PredictionValues& prediction_values = forest.get_trees()[tree_index]->get_prediction_values();
+
+    for (size_t i = 0; i < num_samples; ++i) {
+      if (!valid_trees_by_sample.empty() && !valid_trees_by_sample[i][tree_index]) {
+        continue;
+      }
 
-  for (uint i = 0; i < thread_ranges.size() - 1; ++i) {
-    size_t start_index = thread_ranges[i];
-    size_t num_samples_batch = thread_ranges[i + 1] - start_index;
-
-    futures.push_back(std::async(std::launch::async,
-                                 &OptimizedPredictionCollector::collect_predictions_batch,
-                                 this,
-                                 std::ref(forest),
-                                 std::ref(train_data),
-                                 std::ref(data),
-                                 std::ref(leaf_nodes_by_tree),
-                                 std::ref(valid_trees_by_sample),
-                                 estimate_variance,
-                                 estimate_error,
-                                 start_index,
-                                 num_samples_batch));
+      size_t node = leaf_nodes[i];
+      if (!prediction_values.empty(node)) {
+        num_leaves_by_sample[i]++;
+        add_prediction_values(node, prediction_values, &average_values[i * num_types]);
+      }
+    }
   }
 
-  for (auto& future : futures) {
-    std::vector<Prediction> thread_predictions = future.get();
-    predictions.insert(predictions.end(),
-                       std::make_move_iterator(thread_predictions.begin()),
-                       std::make_move_iterator(thread_predictions.end()));
+  // For strategies whose estimates are linear in each leaf's values, sum the leaf statistics
+  // of the samples in a second pass over the trees, now that the averages that set their
+  // coefficients are known.
+  std::vector<LeafStatisticSums> sums_by_sample;
+  if (sum_leaf_statistics) {
+    sums_by_sample.reserve(num_samples);
+    for (size_t i = 0; i < num_samples; ++i) {
+      std::vector<double> average_value(average_values.begin() + i * num_types,
+                                        average_values.begin() + (i + 1) * num_types);
+      normalize_prediction_values(num_leaves_by_sample[i], average_value);
+      sums_by_sample.emplace_back(strategy->compute_leaf_statistic_coefficients(average_value),
+                                  forest.get_ci_group_size());
+    }
+    add_leaf_statistics(forest, leaf_nodes_by_tree, valid_trees_by_sample, sums_by_sample);
   }
 
-  return predictions;
-}
-
-std::vector<Prediction> OptimizedPredictionCollector::collect_predictions_batch(const Forest& forest,
-                                                                                const Data& train_data,
-                                                                                const Data& data,
-                                                                                const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
-                                                                                const std::vector<std::vector<bool>>& valid_trees_by_sample,
-                                                                                bool estimate_variance,
-                                                                                bool estimate_error,
-                                                                                size_t start,
-                                                                                size_t num_samples) const {
-  size_t num_trees = forest.get_trees().size();
-  bool record_leaf_values = estimate_variance || estimate_error;
+  // The leaf values of one sample in every tree, for the variance and error estimates.
+  // The storage is reused from sample to sample.
+  PredictionValues leaf_values(record_leaf_values ? num_trees : 0, num_types);
 
   std::vector<Prediction> predictions;
   predictions.reserve(num_samples);
 
   for (size_t sample = start; sample < num_samples + start; ++sample) {
-    std::vector<double> average_value;
-    std::vector<std::vector<double>> leaf_values;
-    if (record_leaf_values) {
-      leaf_values.resize(num_trees);
-    }
-
-    // Create a list of weighted neighbors for this sample.
-    uint num_leaves = 0;
-    for (size_t tree_index = 0; tree_index < forest.get_trees().size(); ++tree_index) {
-      if (!valid_trees_by_sample[sample][tree_index]) {
-        continue;
-      }
-
-      const std::vector<size_t>& leaf_nodes = leaf_nodes_by_tree.at(tree_index);
-      size_t node = leaf_nodes.at(sample);
-
-      const std::unique_ptr<Tree>& tree = forest.get_trees()[tree_index];
-      const PredictionValues& prediction_values = tree->get_prediction_values();
-
-      if (!prediction_values.empty(node)) {
-        num_leaves++;
-        add_prediction_values(node, prediction_values, average_value);
-        if (record_leaf_values) {
-          leaf_values[tree_index] = prediction_values.get_values(node);
-        }
-      }
-    }
+    uint num_leaves = num_leaves_by_sample[sample - start];
 
     // If this sample has no neighbors, then return placeholder predictions. Note
     // that this can only occur when honesty is enabled, and is expected to be rare.
@@ -126,21 +108,44 @@ std::vector<Prediction> OptimizedPredictionCollector::collect_predictions_batch(
       continue;
     }
 
+    std::vector<double> average_value(average_values.begin() + (sample - start) * num_types,
+                                      average_values.begin() + (sample - start + 1) * num_types);
     normalize_prediction_values(num_leaves, average_value);
     std::vector<double> point_prediction = strategy->predict(average_value);
 
-    PredictionValues prediction_values(leaf_values, strategy->prediction_value_length());
-    std::vector<double> variance = estimate_variance
-        ? strategy->compute_variance(average_value, prediction_values, forest.get_ci_group_size())
-        : std::vector<double>();
+    // If the returned prediction is empty, for example because all the neighbors have
+    // zero sample weight, then return placeholder predictions.
+    if (point_prediction.empty()) {
+      std::vector<double> nan(strategy->prediction_length(), NAN);
+      std::vector<double> nan_error(1, NAN);
+      predictions.emplace_back(nan, estimate_variance ? nan : std::vector<double>(), nan_error, nan_error);
+      continue;
+    }
+
+    std::vector<double> variance;
+    std::vector<std::pair<double, double>> error;
+    if (sum_leaf_statistics) {
+      const LeafStatisticSums& sums = sums_by_sample[sample - start];
+      if (estimate_variance) {
+        variance = strategy->compute_variance_from_sums(average_value, sums, forest.get_ci_group_size());
+      }
+      if (estimate_error) {
+        error = strategy->compute_error_from_sums(sample, average_value, sums, data);
+      }
+    } else if (record_leaf_values) {
+      collect_leaf_values(forest, leaf_nodes_by_tree, valid_trees_by_sample, sample - start, leaf_values);
+      if (estimate_variance) {
+        variance = strategy->compute_variance(average_value, leaf_values, forest.get_ci_group_size());
+      }
+      if (estimate_error) {
+        error = strategy->compute_error(sample, average_value, leaf_values, data);
+      }
+    }
 
     std::vector<double> mse;
     std::vector<double> mce;
 
     if (estimate_error) {
-      std::vector<std::pair<double, double>> error = strategy->compute_error(
-              sample, average_value, prediction_values, data);
-
       mse.push_back(error[0].first);
       mce.push_back(error[0].second);
     }
@@ -153,15 +158,123 @@ std::vector<Prediction> OptimizedPredictionCollector::collect_predictions_batch(
   return predictions;
 }
 
-void OptimizedPredictionCollector::add_prediction_values(size_t node,
-    const PredictionValues& prediction_values,
-    std::vector<double>& combined_average) const {
-  if (combined_average.empty()) {
-    combined_average.resize(prediction_values.get_num_types());
+std::vector<Prediction> OptimizedPredictionCollector::collect_sparse_predictions(const Forest& forest,
+    const Data& data,
+    const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
+    const std::vector<std::vector<bool>>& valid_trees_by_sample,
+    bool estimate_variance,
+    size_t start,
+    size_t num_samples,
+    Workspace& workspace) const {
+  size_t num_trees = forest.get_trees().size();
+
+  // Gather the entries of each sample's leaves tree by tree, so that they are in tree order.
+  // The lists are kept from block to block, so only their contents are cleared.
+  std::vector<std::vector<SparseEntries>>& leaf_entries_by_sample = workspace.leaf_entries_by_sample;
+  if (leaf_entries_by_sample.size() < num_samples) {
+    leaf_entries_by_sample.resize(num_samples);
+  }
+  for (size_t i = 0; i < num_samples; ++i) {
+    leaf_entries_by_sample[i].clear();
+  }
+  for (size_t tree_index = 0; tree_index < num_trees; ++tree_index) {
+    const std::vector<size_t>& leaf_nodes = leaf_nodes_by_tree.at(tree_index);
+    const std::unique_ptr<Tree>& tree = forest.get_trees()[tree_index];
+    const SparsePredictionValues& prediction_values = tree->get_sparse_prediction_values();
+    if (prediction_values.get_num_nodes() < tree->get_leaf_samples().size()) {
+      throw std::runtime_error("The trees of the forest do not have sparse prediction values:"
+        " the forest must be trained with the prediction strategy it predicts with.");
+    }
+
+    for (size_t i = 0; i < num_samples; ++i) {
+      if (!valid_trees_by_sample.empty() && !valid_trees_by_sample[i][tree_index]) {
+        continue;
+      }
+
+      size_t node = leaf_nodes[i];
+      if (!prediction_values.empty(node)) {
+        leaf_entries_by_sample[i].push_back(prediction_values.get_entries(node));
+      }
+    }
   }
 
-  for (size_t type = 0; type < prediction_values.get_num_types(); ++type) {
-    combined_average[type] += prediction_values.get(node, type);
+  std::vector<Prediction> predictions;
+  predictions.reserve(num_samples);
+
+  for (size_t sample = start; sample < num_samples + start; ++sample) {
+    const std::vector<SparseEntries>& leaf_entries = leaf_entries_by_sample[sample - start];
+    std::vector<double> point_prediction;
+    if (!leaf_entries.empty()) {
+      point_prediction = strategy->predict_sparse_sample(sample, leaf_entries, data, workspace.sparse_workspace);
+    }
+
+    // If this sample has no neighbors, or the returned prediction is empty, for example
+    // because all the neighbors have zero sample weight, then return placeholder predictions.
+    if (point_prediction.empty()) {
+      std::vector<double> nan(strategy->prediction_length(), NAN);
+      std::vector<double> nan_error(1, NAN);
+      predictions.emplace_back(nan, estimate_variance ? nan : std::vector<double>(), nan_error, nan_error);
+      continue;
+    }
+
+    std::vector<double> variance = estimate_variance
+        ? strategy->compute_variance(std::vector<double>(), PredictionValues(), forest.get_ci_group_size())
+        : std::vector<double>();
+
+    Prediction prediction(point_prediction, variance, std::vector<double>(), std::vector<double>());
+    validate_prediction(sample, prediction);
+    predictions.push_back(prediction);
+  }
+  return predictions;
+}
+
+void OptimizedPredictionCollector::collect_leaf_values(const Forest& forest,
+    const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
+    const std::vector<std::vector<bool>>& valid_trees_by_sample,
+    size_t sample,
+    PredictionValues& leaf_values) const {
+  leaf_values.clear();
+  for (size_t tree_index = 0; tree_index < forest.get_trees().size(); ++tree_index) {
+    if (!valid_trees_by_sample.empty() && !valid_trees_by_sample[sample][tree_index]) {
+      continue;
+    }
+
+    size_t node = leaf_nodes_by_tree[tree_index][sample];
+    const PredictionValues& prediction_values = forest.get_trees()[tree_index]->get_prediction_values();
+    if (!prediction_values.empty(node)) {
+      const double* values = prediction_values.get_values(node);
+      std::copy(values, values + prediction_values.get_num_types(), leaf_values.initialize_values(tree_index));
+    }
+  }
+}
+
+void OptimizedPredictionCollector::add_leaf_statistics(const Forest& forest,
+    const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
+    const std::vector<std::vector<bool>>& valid_trees_by_sample,
+    std::vector<LeafStatisticSums>& sums_by_sample) const {
+  for (size_t tree_index = 0; tree_index < forest.get_trees().size(); ++tree_index) {
+    const std::vector<size_t>& leaf_nodes = leaf_nodes_by_tree[tree_index];
+    const PredictionValues& prediction_values = forest.get_trees()[tree_index]->get_prediction_values();
+
+    for (size_t i = 0; i < sums_by_sample.size(); ++i) {
+      if (!valid_trees_by_sample.empty() && !valid_trees_by_sample[i][tree_index]) {
+        sums_by_sample[i].add(nullptr);
+        continue;
+      }
+
+      size_t node = leaf_nodes[i];
+      sums_by_sample[i].add(prediction_values.empty(node) ? nullptr : prediction_values.get_values(node));
+    }
+  }
+}
+
+void OptimizedPredictionCollector::add_prediction_values(size_t node,
+    const PredictionValues& prediction_values,
+    double* combined_average) const {
+  const double* values = prediction_values.get_values(node);
+  size_t num_types = prediction_values.get_num_types();
+  for (size_t type = 0; type < num_types; ++type) {
+    combined_average[type] += values[type];
   }
 }
 
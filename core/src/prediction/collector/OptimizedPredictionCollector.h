@@ -28,7 +28,7 @@ namespace grf {
 
 class OptimizedPredictionCollector final: public PredictionCollector {
 public:
-  OptimizedPredictionCollector(std::unique_ptr<OptimizedPredictionStrategy> strategy, uint num_threads);
+  OptimizedPredictionCollector(std::unique_ptr<OptimizedPredictionStrategy> strategy);
 
   std::vector<Prediction> collect_predictions(const Forest& forest,
                                               const Data& train_data,
@@ -36,22 +36,49 @@ public:
                                               const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
                                               const std::vector<std::vector<bool>>& valid_trees_by_sample,
                                               bool estimate_variance,
-                                              bool estimate_error) const;
+                                              bool estimate_error,
+                                              size_t start,
+                                              size_t num_samples,
+                                              Workspace& workspace) const;
 
 private:
-  std::vector<Prediction> collect_predictions_batch(const Forest& forest,
-                                                    const Data& train_data,
-                                                    const Data& data,
-                                                    const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
-                                                    const std::vector<std::vector<bool>>& valid_trees_by_sample,
-                                                    bool estimate_variance,
-                                                    bool estimate_error,
-                                                    size_t start,
-                                                    size_t num_samples) const;
+  /**
+   * Predicts the samples of the block for a strategy with sparse prediction values,
+   * from the entries of the leaves each sample landed in. The entries and the strategy's
+   * scratch space are kept in `workspace`.
+   */
+  std::vector<Prediction> collect_sparse_predictions(const Forest& forest,
+                                                     const Data& data,
+                                                     const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
+                                                     const std::vector<std::vector<bool>>& valid_trees_by_sample,
+                                                     bool estimate_variance,
+                                                     size_t start,
+                                                     size_t num_samples,
+                                                     Workspace& workspace) const;
+
+  /**
+   * Copies the leaf values of `sample` (relative to the block) in every tree into
+   * `leaf_values`, at the index of the tree. Trees that are not valid for the sample,
+   * or whose leaf is empty, are left empty.
+   */
+  void collect_leaf_values(const Forest& forest,
+                           const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
+                           const std::vector<std::vector<bool>>& valid_trees_by_sample,
+                           size_t sample,
+                           PredictionValues& leaf_values) const;
+
+  /**
+   * Adds the leaf of every sample of the block in every tree to the sums of the sample,
+   * tree by tree. Trees that are not valid for a sample count as empty leaves.
+   */
+  void add_leaf_statistics(const Forest& forest,
+                           const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
+                           const std::vector<std::vector<bool>>& valid_trees_by_sample,
+                           std::vector<LeafStatisticSums>& sums_by_sample) const;
 
   void add_prediction_values(size_t node,
                              const PredictionValues& prediction_values,
-                             std::vector<double>& combined_average) const;
+                             double* combined_average) const;
 
   void normalize_prediction_values(size_t num_leaves,
                                    std::vector<double>& combined_average) const;
@@ -60,7 +87,6 @@ private:
                            const Prediction& prediction) const;
 
   std::unique_ptr<OptimizedPredictionStrategy> strategy;
-  uint num_threads;
 };
 
 } // namespace grf
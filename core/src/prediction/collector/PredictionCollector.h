@@ -21,21 +21,48 @@
 #define GRF_PREDICTIONCOLLECTOR_H
 
 #include "forest/Forest.h"
+#include "prediction/collector/SampleWeightComputer.h"
+#include "prediction/OptimizedPredictionStrategy.h"
 
 namespace grf {
 
 class PredictionCollector {
 public:
+  /**
+   * The scratch space of the blocks one thread collects during a prediction call. It is
+   * kept for the whole call, so that blocks do not allocate and clear it again, and freed
+   * with it. Collectors use only the parts they need.
+   */
+  struct Workspace {
+    SampleWeightComputer::WeightAccumulator weight_accumulator;
+    std::vector<std::vector<SparseEntries>> leaf_entries_by_sample;
+    SparsePredictionWorkspace sparse_workspace;
+  };
 
   virtual ~PredictionCollector() = default;
 
+  /**
+   * Computes the predictions for a block of consecutive samples of `data`, on the
+   * calling thread.
+   *
+   * @param leaf_nodes_by_tree: for every tree, the leaf node of each sample in the block.
+   * @param valid_trees_by_sample: for every sample in the block, whether each tree may
+   * be used to predict it, or empty if every tree may be used.
+   * @param start: the ID of the first sample of the block. Both vectors above are indexed
+   * by sample ID - start.
+   * @param num_samples: the number of samples in the block.
+   * @param workspace: scratch space owned by the calling thread.
+   */
   virtual std::vector<Prediction> collect_predictions(const Forest& forest,
                                                       const Data& train_data,
                                                       const Data& data,
                                                       const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
                                                       const std::vector<std::vector<bool>>& valid_trees_by_sample,
                                                       bool estimate_variance,
-                                                      bool estimate_error) const = 0;
+                                                      bool estimate_error,
+                                                      size_t start,
+                                                      size_t num_samples,
+                                                      Workspace& workspace) const = 0;
 };
 
 } // namespace grf
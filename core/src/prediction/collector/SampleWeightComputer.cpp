@@ -17,21 +17,22 @@
   along with grf. If not, see <http://www.gnu.org/licenses/>.
  #-------------------------------------------------------------------------------*/
 
+#include <algorithm>
+
 #include "SampleWeightComputer.h"
 
 #include "tree/Tree.h"
 
 namespace grf {
 
-std::unordered_map<size_t, double> SampleWeightComputer::compute_weights(size_t sample,
-                                                                         const Forest& forest,
-                                                                         const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
-                                                                         const std::vector<std::vector<bool>>& valid_trees_by_sample) const {
-  std::unordered_map<size_t, double> weights_by_sample;
-
+std::vector<std::pair<size_t, double>> SampleWeightComputer::compute_weights(size_t sample,
+                                                                             const Forest& forest,
+                                                                             const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
+                                                                             const std::vector<std::vector<bool>>& valid_trees_by_sample,
+                                                                             WeightAccumulator& accumulator) const {
   // Create a list of weighted neighbors for this sample.
   for (size_t tree_index = 0; tree_index < forest.get_trees().size(); ++tree_index) {
-    if (!valid_trees_by_sample[sample][tree_index]) {
+    if (!valid_trees_by_sample.empty() && !valid_trees_by_sample[sample][tree_index]) {
       continue;
     }
 
@@ -39,34 +40,50 @@ std::unordered_map<size_t, double> SampleWeightComputer::compute_weights(size_t
     size_t node = leaf_nodes.at(sample);
 
     const std::unique_ptr<Tree>& tree = forest.get_trees()[tree_index];
-    const std::vector<size_t>& samples = tree->get_leaf_samples()[node];
+    LeafSampleSpan samples = tree->get_leaf_samples()[node];
     if (!samples.empty()) {
-      add_sample_weights(samples, weights_by_sample);
+      add_sample_weights(samples, accumulator);
     }
   }
 
-  normalize_sample_weights(weights_by_sample);
-  return weights_by_sample;
+  return normalize_sample_weights(accumulator);
 }
 
-void SampleWeightComputer::add_sample_weights(const std::vector<size_t>& samples,
-                                              std::unordered_map<size_t, double>& weights_by_sample) const {
+void SampleWeightComputer::add_sample_weights(LeafSampleSpan samples,
+                                              WeightAccumulator& accumulator) const {
   double sample_weight = 1.0 / samples.size();
 
+  std::vector<double>& weights = accumulator.weights;
   for (auto& sample : samples) {
-    weights_by_sample[sample] += sample_weight;
+    if (sample >= weights.size()) {
+      weights.resize(sample + 1, 0.0);
+    }
+    if (weights[sample] == 0.0) {
+      accumulator.touched_samples.push_back(sample);
+    }
+    weights[sample] += sample_weight;
   }
 }
 
-void SampleWeightComputer::normalize_sample_weights(std::unordered_map<size_t, double>& weights_by_sample) const {
+std::vector<std::pair<size_t, double>> SampleWeightComputer::normalize_sample_weights(
+    WeightAccumulator& accumulator) const {
+  std::vector<double>& weights = accumulator.weights;
+  std::vector<size_t>& touched_samples = accumulator.touched_samples;
+  std::sort(touched_samples.begin(), touched_samples.end());
+
   double total_weight = 0.0;
-  for (const auto& entry : weights_by_sample) {
-    total_weight += entry.second;
+  for (size_t sample : touched_samples) {
+    total_weight += weights[sample];
   }
 
-  for (auto& entry : weights_by_sample) {
-    entry.second/= total_weight;
+  std::vector<std::pair<size_t, double>> weights_by_sample;
+  weights_by_sample.reserve(touched_samples.size());
+  for (size_t sample : touched_samples) {
+    weights_by_sample.emplace_back(sample, weights[sample] / total_weight);
+    weights[sample] = 0.0;
   }
+  touched_samples.clear();
+  return weights_by_sample;
 }
 
 } // namespace grf
@@ -22,23 +22,43 @@
 
 #include "forest/Forest.h"
 
-#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace grf {
 
 class SampleWeightComputer {
 public:
-  std::unordered_map<size_t, double> compute_weights(size_t sample,
-                                                     const Forest& forest,
-                                                     const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
-                                                     const std::vector<std::vector<bool>>& valid_trees_by_sample) const;
+  /**
+   * The scratch space of compute_weights: a dense array with one entry per training
+   * sample, cleared through the list of touched entries after each call so that no
+   * hashing or allocation per neighbor is needed.
+   *
+   * The caller owns it, typically for all the samples one thread predicts in a
+   * prediction call, and frees it after the call. It may not be shared by threads.
+   */
+  struct WeightAccumulator {
+    // The weight of every training sample, all zero between calls.
+    std::vector<double> weights;
+    // The training samples with a nonzero weight.
+    std::vector<size_t> touched_samples;
+  };
+
+  /**
+   * Computes the normalized weights of the training samples that share a leaf with
+   * `sample`, as pairs of training sample ID and weight in increasing order of sample ID.
+   */
+  std::vector<std::pair<size_t, double>> compute_weights(size_t sample,
+                                                         const Forest& forest,
+                                                         const std::vector<std::vector<size_t>>& leaf_nodes_by_tree,
+                                                         const std::vector<std::vector<bool>>& valid_trees_by_sample,
+                                                         WeightAccumulator& accumulator) const;
 
 private:
-  void add_sample_weights(const std::vector<size_t>& samples,
-                          std::unordered_map<size_t, double>& weights_by_sample) const;
+  void add_sample_weights(LeafSampleSpan samples,
+                          WeightAccumulator& accumulator) const;
 
-  void normalize_sample_weights(std::unordered_map<size_t, double>& weights_by_sample) const;
+  std::vector<std::pair<size_t, double>> normalize_sample_weights(WeightAccumulator& accumulator) const;
 };
 
 } // namespace grf
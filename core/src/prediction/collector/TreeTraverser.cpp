@@ -17,11 +17,12 @@
   along with grf. If not, see <http://www.gnu.org/licenses/>.
  #-------------------------------------------------------------------------------*/
 
+#include <algorithm>
+
 #include "TreeTraverser.h"
+#include "commons/ThreadPool.h"
 #include "commons/utility.h"
 
-#include <future>
-
 namespace grf {
 
 TreeTraverser::TreeTraverser(uint num_threads) :
@@ -33,51 +34,67 @@ std::vector<std::vector<size_t>> TreeTraverser::get_leaf_nodes(
     bool oob_prediction) const {
   size_t num_trees = forest.get_trees().size();
 
-  std::vector<std::vector<size_t>> leaf_nodes_by_tree;
-  leaf_nodes_by_tree.reserve(num_trees);
+  std::vector<uint> chunk_ranges;
+  split_sequence(chunk_ranges, 0, static_cast<uint>(num_trees - 1),
+                 ThreadPool::get_num_chunks(num_trees, num_threads));
+  size_t num_chunks = chunk_ranges.size() - 1;
 
-  std::vector<uint> thread_ranges;
-  split_sequence(thread_ranges, 0, static_cast<uint>(num_trees - 1), num_threads);
-
-  std::vector<std::future<
-      std::vector<std::vector<size_t>>>> futures;
-  futures.reserve(thread_ranges.size());
-
-  for (uint i = 0; i < thread_ranges.size() - 1; ++i) {
-    size_t start_index = thread_ranges[i];
-    size_t num_trees_batch = thread_ranges[i + 1] - start_index;
-    futures.push_back(std::async(std::launch::async,
-                                 &TreeTraverser::get_leaf_node_batch,
-                                 this,
-                                 start_index,
-                                 num_trees_batch,
-                                 std::ref(forest),
-                                 std::ref(data),
-                                 oob_prediction));
-  }
+  std::vector<std::vector<std::vector<size_t>>> leaf_nodes_by_chunk(num_chunks);
+  ThreadPool::get_instance().parallel_for(num_chunks, num_threads, [&](size_t chunk, size_t) {
+    size_t start_index = chunk_ranges[chunk];
+    size_t num_trees_batch = chunk_ranges[chunk + 1] - start_index;
+    leaf_nodes_by_chunk[chunk] = get_leaf_node_batch(start_index, num_trees_batch, forest, data, oob_prediction);
+  });
 
-  for (auto& future : futures) {
-    std::vector<std::vector<size_t>> leaf_nodes = future.get();
+  std::vector<std::vector<size_t>> leaf_nodes_by_tree;
+  leaf_nodes_by_tree.reserve(num_trees);
+  for (auto& leaf_nodes : leaf_nodes_by_chunk) {
     leaf_nodes_by_tree.insert(leaf_nodes_by_tree.end(),
-                              leaf_nodes.begin(),
-                              leaf_nodes.end());
+                              std::make_move_iterator(leaf_nodes.begin()),
+                              std::make_move_iterator(leaf_nodes.end()));
   }
 
   return leaf_nodes_by_tree;
 };
 
+std::vector<std::vector<size_t>> TreeTraverser::get_leaf_nodes(
+    const Forest& forest,
+    const Data& data,
+    bool oob_prediction,
+    size_t start,
+    size_t num_samples) const {
+  size_t num_trees = forest.get_trees().size();
+
+  std::vector<std::vector<size_t>> leaf_nodes_by_tree(num_trees);
+  for (size_t tree_index = 0; tree_index < num_trees; ++tree_index) {
+    const std::unique_ptr<Tree>& tree = forest.get_trees()[tree_index];
+    std::vector<bool> valid_samples = get_valid_samples(tree, oob_prediction, start, num_samples);
+    leaf_nodes_by_tree[tree_index] = tree->find_leaf_nodes(data, start, valid_samples);
+  }
+  return leaf_nodes_by_tree;
+}
+
 std::vector<std::vector<bool>> TreeTraverser::get_valid_trees_by_sample(const Forest& forest,
                                                                         const Data& data,
                                                                         bool oob_prediction) const {
-  size_t num_trees = forest.get_trees().size();
-  size_t num_samples = data.get_num_rows();
+  return get_valid_trees_by_sample(forest, oob_prediction, 0, data.get_num_rows());
+}
+
+std::vector<std::vector<bool>> TreeTraverser::get_valid_trees_by_sample(const Forest& forest,
+                                                                        bool oob_prediction,
+                                                                        size_t start,
+                                                                        size_t num_samples) const {
+  if (!oob_prediction) {
+    return std::vector<std::vector<bool>>();
+  }
 
+  size_t num_trees = forest.get_trees().size();
   std::vector<std::vector<bool>> result(num_samples, std::vector<bool>(num_trees, true));
-  if (oob_prediction) {
-    for (size_t tree_idx = 0; tree_idx < num_trees; ++tree_idx) {
-      for (size_t sample : forest.get_trees()[tree_idx]->get_drawn_samples()) {
-        result[sample][tree_idx] = false;
-      }
+  for (size_t tree_idx = 0; tree_idx < num_trees; ++tree_idx) {
+    const std::vector<size_t>& drawn_samples = forest.get_trees()[tree_idx]->get_drawn_samples();
+    auto it = std::lower_bound(drawn_samples.begin(), drawn_samples.end(), start);
+    for (; it != drawn_samples.end() && *it < start + num_samples; ++it) {
+      result[*it - start][tree_idx] = false;
     }
   }
   return result;
@@ -96,7 +113,7 @@ std::vector<std::vector<size_t>> TreeTraverser::get_leaf_node_batch(
   for (size_t i = 0; i < num_trees; ++i) {
     const std::unique_ptr<Tree>& tree = forest.get_trees()[start + i];
 
-    std::vector<bool> valid_samples = get_valid_samples(num_samples, tree, oob_prediction);
+    std::vector<bool> valid_samples = get_valid_samples(tree, oob_prediction, 0, num_samples);
     std::vector<size_t> leaf_nodes = tree->find_leaf_nodes(data, valid_samples);
     all_leaf_nodes[i] = leaf_nodes;
   }
@@ -104,13 +121,16 @@ std::vector<std::vector<size_t>> TreeTraverser::get_leaf_node_batch(
   return all_leaf_nodes;
 }
 
-std::vector<bool> TreeTraverser::get_valid_samples(size_t num_samples,
-                                                   const std::unique_ptr<Tree>& tree,
-                                                   bool oob_prediction) const {
+std::vector<bool> TreeTraverser::get_valid_samples(const std::unique_ptr<Tree>& tree,
+                                                   bool oob_prediction,
+                                                   size_t start,
+                                                   size_t num_samples) const {
   std::vector<bool> valid_samples(num_samples, true);
   if (oob_prediction) {
-    for (size_t sample : tree->get_drawn_samples()) {
-      valid_samples[sample] = false;
+    const std::vector<size_t>& drawn_samples = tree->get_drawn_samples();
+    auto it = std::lower_bound(drawn_samples.begin(), drawn_samples.end(), start);
+    for (; it != drawn_samples.end() && *it < start + num_samples; ++it) {
+      valid_samples[*it - start] = false;
     }
   }
   return valid_samples;
@@ -33,10 +33,41 @@ public:
       const Data& data,
       bool oob_prediction) const;
 
+  /**
+   * Finds the leaf nodes of a block of consecutive samples in every tree, on the calling
+   * thread.
+   *
+   * @param oob_prediction: whether to skip the samples each tree was trained on.
+   * @param start: the ID of the first sample in the block.
+   * @param num_samples: the number of samples in the block.
+   * @return for every tree, the leaf node of each sample in the block, indexed by sample
+   * ID - start, or 0 if the tree is not valid for the sample.
+   */
+  std::vector<std::vector<size_t>> get_leaf_nodes(
+      const Forest& forest,
+      const Data& data,
+      bool oob_prediction,
+      size_t start,
+      size_t num_samples) const;
+
+  /**
+   * For every sample, whether each tree may be used to predict it: for OOB prediction,
+   * the trees that did not draw the sample. Without OOB prediction every tree is valid,
+   * and the result is empty.
+   */
   std::vector<std::vector<bool>> get_valid_trees_by_sample(const Forest& forest,
                                                            const Data& data,
                                                            bool oob_prediction) const;
 
+  /**
+   * Same as above, for the samples start, ..., start + num_samples - 1 only, indexed by
+   * sample ID - start.
+   */
+  std::vector<std::vector<bool>> get_valid_trees_by_sample(const Forest& forest,
+                                                           bool oob_prediction,
+                                                           size_t start,
+                                                           size_t num_samples) const;
+
 private:
   std::vector<std::vector<size_t>> get_leaf_node_batch(
       size_t start,
@@ -45,9 +76,10 @@ private:
       const Data& data,
       bool oob_prediction) const;
 
-  std::vector<bool> get_valid_samples(size_t num_samples,
-                                      const std::unique_ptr<Tree>& tree,
-                                      bool oob_prediction) const;
+  std::vector<bool> get_valid_samples(const std::unique_ptr<Tree>& tree,
+                                      bool oob_prediction,
+                                      size_t start,
+                                      size_t num_samples) const;
 
   uint num_threads;
 };
@@ -23,9 +23,9 @@
 namespace grf {
 
 bool CausalSurvivalRelabelingStrategy::relabel(
-    const std::vector<size_t>& samples,
+    SampleSpan samples,
     const Data& data,
-    Eigen::ArrayXXd& responses_by_sample) const {
+    ResponsesBySample& responses_by_sample) const {
 
   // Prepare the relevant averages.
   double numerator_sum = 0;
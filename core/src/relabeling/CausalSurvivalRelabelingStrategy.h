@@ -30,9 +30,9 @@ namespace grf {
 class CausalSurvivalRelabelingStrategy final: public RelabelingStrategy {
 public:
   bool relabel(
-      const std::vector<size_t>& samples,
+      SampleSpan samples,
       const Data& data,
-      Eigen::ArrayXXd& responses_by_sample) const;
+      ResponsesBySample& responses_by_sample) const;
 
 };
 
@@ -0,0 +1,133 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "relabeling/CausalSurvivalScores.h"
+
+namespace grf {
+
+const int CausalSurvivalScores::RMST = 0;
+const int CausalSurvivalScores::SURVIVAL_PROBABILITY = 1;
+
+CausalSurvivalScores::CausalSurvivalScores(std::vector<double> grid,
+                                           int target,
+                                           double horizon):
+    grid(grid),
+    target(target),
+    horizon(horizon) {
+  if (grid.empty() || !std::is_sorted(grid.begin(), grid.end())) {
+    throw std::runtime_error("The grid of event times must be non-empty and sorted.");
+  }
+  horizon_index = std::upper_bound(grid.begin(), grid.end(), horizon) - grid.begin();
+  if (target == SURVIVAL_PROBABILITY && horizon_index == 0) {
+    throw std::runtime_error("The horizon cannot be before the first event.");
+  }
+}
+
+const std::vector<double>& CausalSurvivalScores::get_grid() const {
+  return grid;
+}
+
+std::vector<size_t> CausalSurvivalScores::get_grid_indices(const std::vector<double>& failure_times) const {
+  std::vector<size_t> grid_indices(grid.size());
+  for (size_t t = 0; t < grid.size(); ++t) {
+    grid_indices[t] = std::upper_bound(failure_times.begin(), failure_times.end(), grid[t]) - failure_times.begin();
+  }
+  return grid_indices;
+}
+
+double CausalSurvivalScores::expected_outcome(const std::vector<double>& survival,
+                                              const std::vector<double>& failure_times) const {
+  size_t num_failures = failure_times.size();
+  if (target == RMST) {
+    // The area under the survival curve, which is 1 until the first failure time and
+    // constant between failure times.
+    if (num_failures == 0) {
+      return 0;
+    }
+    double expected = failure_times[0];
+    for (size_t k = 0; k + 1 < num_failures; ++k) {
+      expected += survival[k] * (failure_times[k + 1] - failure_times[k]);
+    }
+    return expected;
+  }
+
+  size_t index = std::upper_bound(failure_times.begin(), failure_times.end(), horizon) - failure_times.begin();
+  return index == 0 ? 1 : survival[index - 1];
+}
+
+double CausalSurvivalScores::compute_numerator(const std::vector<double>& survival,
+                                               const std::vector<double>& censoring,
+                                               double Y_hat,
+                                               double W_centered,
+                                               double censor,
+                                               double f_Y,
+                                               size_t Y_index,
+                                               std::vector<double>& Q) const {
+  compute_conditional_outcomes(survival, Y_index, Q);
+
+  double C_Y = censoring[Y_index];
+  double numerator_one = (censor * (f_Y - Y_hat) + (1 - censor) * (Q[Y_index] - Y_hat)) * W_centered / C_Y;
+
+  // The integral of (Q(t) - Y_hat) / C(t) against the censoring hazard -d log C(t),
+  // approximated by forward differences up to the event time of the sample.
+  double integral = 0;
+  double previous_log_censoring = 0;
+  for (size_t t = 0; t <= Y_index; ++t) {
+    double log_censoring = std::log(censoring[t]);
+    double dlambda = previous_log_censoring - log_censoring;
+    integral += dlambda / censoring[t] * (Q[t] - Y_hat);
+    previous_log_censoring = log_censoring;
+  }
+
+  return numerator_one - integral * W_centered;
+}
+
+void CausalSurvivalScores::compute_conditional_outcomes(const std::vector<double>& survival,
+                                                        size_t Y_index,
+                                                        std::vector<double>& Q) const {
+  size_t grid_length = grid.size();
+  Q.resize(Y_index + 1);
+
+  if (target == RMST) {
+    // Q(t) = t + (the area under S after t) / S(t), where the area is accumulated
+    // backwards from the end of the grid. The last grid time has Q = max(grid).
+    double area = 0;
+    for (size_t t = grid_length - 1; t-- > 0;) {
+      area += survival[t] * (grid[t + 1] - grid[t]);
+      if (t <= Y_index) {
+        Q[t] = grid[t] + area / survival[t];
+      }
+    }
+    if (Y_index == grid_length - 1) {
+      Q[Y_index] = grid[grid_length - 1];
+    }
+  } else {
+    // Q(t) = P(T > horizon | T > t) = S(horizon) / S(t), which is 1 from the horizon on.
+    double survival_horizon = survival[horizon_index - 1];
+    for (size_t t = 0; t <= Y_index; ++t) {
+      Q[t] = t + 1 >= horizon_index ? 1 : survival_horizon / survival[t];
+    }
+  }
+}
+
+} // namespace grf
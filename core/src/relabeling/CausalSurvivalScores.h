@@ -0,0 +1,105 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_CAUSALSURVIVALSCORES_H
+#define GRF_CAUSALSURVIVALSCORES_H
+
+#include <cstddef>
+#include <vector>
+
+namespace grf {
+
+/**
+ * The doubly robust scores that CausalSurvivalRelabelingStrategy splits on, computed
+ * one sample at a time from the estimated survival curves of the sample.
+ *
+ * The score of a sample is numerator / denominator, where denominator = W_centered^2
+ * and numerator combines the outcome of the sample with the conditional survival
+ * function S(t | X, W) and the censoring survival function C(t | X, W) on the grid of
+ * event times, as described in https://arxiv.org/abs/2001.09887. The target f(T) is
+ * either the restricted mean survival time min(T, horizon), or the survival
+ * probability 1{T > horizon}.
+ */
+class CausalSurvivalScores {
+public:
+  static const int RMST;
+  static const int SURVIVAL_PROBABILITY;
+
+  /**
+   * grid: the increasing event times at which the survival curves are evaluated.
+   *
+   * target: RMST or SURVIVAL_PROBABILITY.
+   */
+  CausalSurvivalScores(std::vector<double> grid,
+                       int target,
+                       double horizon);
+
+  const std::vector<double>& get_grid() const;
+
+  /**
+   * For each grid time, the number of `failure_times` at or before it, such that a
+   * survival curve at `failure_times` is evaluated at grid time t by its value at
+   * index grid_indices[t] - 1, or 1 if that index is zero.
+   */
+  std::vector<size_t> get_grid_indices(const std::vector<double>& failure_times) const;
+
+  /**
+   * E[f(T) | X] from a survival curve at the increasing `failure_times`.
+   */
+  double expected_outcome(const std::vector<double>& survival,
+                          const std::vector<double>& failure_times) const;
+
+  /**
+   * The score numerator of one sample.
+   *
+   * survival, censoring: S and C of the sample on the grid.
+   * Y_hat: the estimate of E[f(T) | X].
+   * censor: 1 if the event of the sample was observed, and 0 if it was censored.
+   * f_Y: the target evaluated at the event time of the sample.
+   * Y_index: the index in the grid of the event time of the sample.
+   * Q: scratch space for the conditional outcomes, which the caller can reuse across
+   *  samples to avoid allocating.
+   */
+  double compute_numerator(const std::vector<double>& survival,
+                           const std::vector<double>& censoring,
+                           double Y_hat,
+                           double W_centered,
+                           double censor,
+                           double f_Y,
+                           size_t Y_index,
+                           std::vector<double>& Q) const;
+
+private:
+  /**
+   * Q(t) = E[f(T) | X, W, T > t] for the grid times t up to Y_index.
+   */
+  void compute_conditional_outcomes(const std::vector<double>& survival,
+                                    size_t Y_index,
+                                    std::vector<double>& Q) const;
+
+  std::vector<double> grid;
+  int target;
+  double horizon;
+  // The number of grid times at or before the horizon.
+  size_t horizon_index;
+};
+
+} // namespace grf
+
+#endif //GRF_CAUSALSURVIVALSCORES_H
@@ -29,9 +29,9 @@ InstrumentalRelabelingStrategy::InstrumentalRelabelingStrategy(double reduced_fo
   reduced_form_weight(reduced_form_weight) {}
 
 bool InstrumentalRelabelingStrategy::relabel(
-    const std::vector<size_t>& samples,
+    SampleSpan samples,
     const Data& data,
-    Eigen::ArrayXXd& responses_by_sample) const {
+    ResponsesBySample& responses_by_sample) const {
 
   // Prepare the relevant averages.
   double sum_weight = 0.0;
@@ -35,9 +35,9 @@ public:
   InstrumentalRelabelingStrategy(double reduced_form_weight);
 
   bool relabel(
-      const std::vector<size_t>& samples,
+      SampleSpan samples,
       const Data& data,
-      Eigen::ArrayXXd& responses_by_sample) const;
+      ResponsesBySample& responses_by_sample) const;
 
   DISALLOW_COPY_AND_ASSIGN(InstrumentalRelabelingStrategy);
 
@@ -34,9 +34,9 @@ LLRegressionRelabelingStrategy::LLRegressionRelabelingStrategy(double split_lamb
 };
 
 bool LLRegressionRelabelingStrategy::relabel(
-    const std::vector<size_t>& samples,
+    SampleSpan samples,
     const Data& data,
-    Eigen::ArrayXXd& responses_by_sample) const {
+    ResponsesBySample& responses_by_sample) const {
 
   size_t num_variables = ll_split_variables.size();
   size_t num_data_points = samples.size();
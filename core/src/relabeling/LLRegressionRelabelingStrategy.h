@@ -32,9 +32,9 @@ public:
                                  size_t ll_split_cutoff,
                                  std::vector<size_t> ll_split_variables);
   bool relabel(
-      const std::vector<size_t>& samples,
+      SampleSpan samples,
       const Data& data,
-      Eigen::ArrayXXd& responses_by_sample) const;
+      ResponsesBySample& responses_by_sample) const;
 private:
     double split_lambda;
     bool weight_penalty;
@@ -35,9 +35,9 @@ MultiCausalRelabelingStrategy::MultiCausalRelabelingStrategy(size_t response_len
 }
 
 bool MultiCausalRelabelingStrategy::relabel(
-    const std::vector<size_t>& samples,
+    SampleSpan samples,
     const Data& data,
-    Eigen::ArrayXXd& responses_by_sample) const {
+    ResponsesBySample& responses_by_sample) const {
 
   // Prepare the relevant averages.
   size_t num_samples = samples.size();
@@ -56,8 +56,8 @@ bool MultiCausalRelabelingStrategy::relabel(
   for (size_t i = 0; i < num_samples; i++) {
     size_t sample = samples[i];
     double weight = data.get_weight(sample);
-    Eigen::VectorXd outcome = data.get_outcomes(sample);
-    Eigen::VectorXd treatment = data.get_treatments(sample);
+    Data::RowView outcome = data.get_outcomes(sample);
+    Data::RowView treatment = data.get_treatments(sample);
     Y_centered.row(i) = outcome;
     W_centered.row(i) = treatment;
     weights(i) = weight;
@@ -48,9 +48,9 @@ public:
                                 const std::vector<double>& gradient_weights);
 
   bool relabel(
-      const std::vector<size_t>& samples,
+      SampleSpan samples,
       const Data& data,
-      Eigen::ArrayXXd& responses_by_sample) const;
+      ResponsesBySample& responses_by_sample) const;
 
   size_t get_response_length() const;
 
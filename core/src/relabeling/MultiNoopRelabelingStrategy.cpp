@@ -25,9 +25,9 @@
   num_outcomes(num_outcomes) {}
 
  bool MultiNoopRelabelingStrategy::relabel(
-     const std::vector<size_t>& samples,
+     SampleSpan samples,
      const Data& data,
-     Eigen::ArrayXXd& responses_by_sample) const {
+     ResponsesBySample& responses_by_sample) const {
 
    for (size_t sample : samples) {
      responses_by_sample.row(sample) = data.get_outcomes(sample);
@@ -39,4 +39,8 @@ size_t MultiNoopRelabelingStrategy::get_response_length() const {
   return num_outcomes;
 }
 
+bool MultiNoopRelabelingStrategy::is_node_invariant() const {
+  return true;
+}
+
  } // namespace grf
@@ -29,12 +29,14 @@ public:
   MultiNoopRelabelingStrategy(size_t num_outcomes);
 
   bool relabel(
-      const std::vector<size_t>& samples,
+      SampleSpan samples,
       const Data& data,
-      Eigen::ArrayXXd& responses_by_sample) const;
+      ResponsesBySample& responses_by_sample) const;
 
   size_t get_response_length() const;
 
+  bool is_node_invariant() const;
+
 private:
   size_t num_outcomes;
 };
@@ -22,9 +22,9 @@
  namespace grf {
 
  bool NoopRelabelingStrategy::relabel(
-     const std::vector<size_t>& samples,
+     SampleSpan samples,
      const Data& data,
-     Eigen::ArrayXXd& responses_by_sample) const {
+     ResponsesBySample& responses_by_sample) const {
 
    for (size_t sample : samples) {
      double outcome = data.get_outcome(sample);
@@ -33,4 +33,8 @@
    return false;
  }
 
+ bool NoopRelabelingStrategy::is_node_invariant() const {
+   return true;
+ }
+
  } // namespace grf
@@ -27,9 +27,11 @@ namespace grf {
 class NoopRelabelingStrategy final: public RelabelingStrategy {
 public:
   bool relabel(
-      const std::vector<size_t>& samples,
+      SampleSpan samples,
       const Data& data,
-      Eigen::ArrayXXd& responses_by_sample) const;
+      ResponsesBySample& responses_by_sample) const;
+
+  bool is_node_invariant() const;
 };
 
 } // namespace grf
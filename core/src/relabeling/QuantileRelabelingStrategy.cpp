@@ -26,9 +26,9 @@ QuantileRelabelingStrategy::QuantileRelabelingStrategy(const std::vector<double>
     quantiles(quantiles) {}
 
 bool QuantileRelabelingStrategy::relabel(
-    const std::vector<size_t>& samples,
+    SampleSpan samples,
     const Data& data,
-    Eigen::ArrayXXd& responses_by_sample) const {
+    ResponsesBySample& responses_by_sample) const {
 
   std::vector<double> sorted_outcomes(samples.size());
   for (size_t i = 0; i < samples.size(); i++) {
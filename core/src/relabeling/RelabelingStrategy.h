@@ -24,6 +24,7 @@
 
 #include "Eigen/Dense"
 #include "commons/Data.h"
+#include "commons/ResponsesBySample.h"
 
 namespace grf {
 
@@ -43,7 +44,7 @@ public:
    * samples: the subset of samples to relabel.
    * data: the training data matrix.
    * responses_by_sample: the output of the method, an array of relabelled response for each sample ID in `samples`.
-   * The dimension of this array is N * K where N is the total number of samples in the data, and K is given
+   * It holds K values for each sample the tree is grown on (see ResponsesBySample), where K is given
    * by `get_response_length()`.
    *
    * In most cases, like a single-variable regression forest, K is 1, and `responses_by_sample` is a scalar for
@@ -55,15 +56,21 @@ public:
    *
    * returns: a boolean that will be 'true' if splitting should stop early.
    */
-  virtual bool relabel(const std::vector<size_t>& samples,
+  virtual bool relabel(SampleSpan samples,
                        const Data& data,
-                       Eigen::ArrayXXd& responses_by_sample) const = 0;
+                       ResponsesBySample& responses_by_sample) const = 0;
 
  /**
    * Override to specify the column dimension of `responses_by_sample`.
    * The default value of 1 is used for most forests splitting on scalar values.
    */
   virtual size_t get_response_length() const { return 1; };
+
+ /**
+   * Override to return true if the relabelled response of a sample does not depend on the
+   * node it is in, so that sums of responses over a node can be reused by its children.
+   */
+  virtual bool is_node_invariant() const { return false; };
 };
 
 } // namespace grf
@@ -48,45 +48,33 @@ void RandomSampler::sample(size_t num_samples,
 void RandomSampler::subsample(const std::vector<size_t>& samples,
                               double sample_fraction,
                               std::vector<size_t>& subsamples) {
-  std::vector<size_t> shuffled_sample(samples);
-  nonstd::shuffle(shuffled_sample.begin(), shuffled_sample.end(), random_number_generator);
+  // Shuffle in the output vector, so that a caller reusing it does not allocate.
+  subsamples.assign(samples.begin(), samples.end());
+  nonstd::shuffle(subsamples.begin(), subsamples.end(), random_number_generator);
 
   uint subsample_size = (uint) std::ceil(samples.size() * sample_fraction);
   subsamples.resize(subsample_size);
-  std::copy(shuffled_sample.begin(),
-            shuffled_sample.begin() + subsamples.size(),
-            subsamples.begin());
 }
 
 void RandomSampler::subsample(const std::vector<size_t>& samples,
                               double sample_fraction,
                               std::vector<size_t>& subsamples,
                               std::vector<size_t>& oob_samples) {
-  std::vector<size_t> shuffled_sample(samples);
-  nonstd::shuffle(shuffled_sample.begin(), shuffled_sample.end(), random_number_generator);
+  subsamples.assign(samples.begin(), samples.end());
+  nonstd::shuffle(subsamples.begin(), subsamples.end(), random_number_generator);
 
   size_t subsample_size = (size_t) std::ceil(samples.size() * sample_fraction);
+  oob_samples.assign(subsamples.begin() + subsample_size, subsamples.end());
   subsamples.resize(subsample_size);
-  oob_samples.resize(samples.size() - subsample_size);
-
-  std::copy(shuffled_sample.begin(),
-            shuffled_sample.begin() + subsamples.size(),
-            subsamples.begin());
-  std::copy(shuffled_sample.begin() + subsamples.size(),
-            shuffled_sample.end(),
-            oob_samples.begin());
 }
 
 void RandomSampler::subsample_with_size(const std::vector<size_t>& samples,
                                         size_t subsample_size,
                                         std::vector<size_t>& subsamples) {
-  std::vector<size_t> shuffled_sample(samples);
-  nonstd::shuffle(shuffled_sample.begin(), shuffled_sample.end(), random_number_generator);
+  subsamples.assign(samples.begin(), samples.end());
+  nonstd::shuffle(subsamples.begin(), subsamples.end(), random_number_generator);
 
   subsamples.resize(subsample_size);
-  std::copy(shuffled_sample.begin(),
-            shuffled_sample.begin() + subsamples.size(),
-            subsamples.begin());
 }
 
 void RandomSampler::sample_from_clusters(const std::vector<size_t>& clusters,
@@ -103,9 +91,11 @@ void RandomSampler::sample_from_clusters(const std::vector<size_t>& clusters,
       if (cluster_samples.size() <= options.get_samples_per_cluster()) {
         samples.insert(samples.end(), cluster_samples.begin(), cluster_samples.end());
       } else {
-        std::vector<size_t> subsamples;
-        subsample_with_size(cluster_samples, options.get_samples_per_cluster(), subsamples);
-        samples.insert(samples.end(), subsamples.begin(), subsamples.end());
+        // Same draw as subsample_with_size, shuffled in place at the end of `samples`.
+        size_t start = samples.size();
+        samples.insert(samples.end(), cluster_samples.begin(), cluster_samples.end());
+        nonstd::shuffle(samples.begin() + start, samples.end(), random_number_generator);
+        samples.resize(start + options.get_samples_per_cluster());
       }
     }
   }
@@ -139,8 +129,17 @@ void RandomSampler::draw(std::vector<size_t>& result,
                          size_t max,
                          const std::set<size_t>& skip,
                          size_t num_samples) {
+  std::vector<bool> drawn;
+  draw(result, max, skip, num_samples, drawn);
+}
+
+void RandomSampler::draw(std::vector<size_t>& result,
+                         size_t max,
+                         const std::set<size_t>& skip,
+                         size_t num_samples,
+                         std::vector<bool>& drawn) {
   if (num_samples < max / 10) {
-    draw_simple(result, max, skip, num_samples);
+    draw_simple(result, max, skip, num_samples, drawn);
   } else {
     draw_fisher_yates(result, max, skip, num_samples);
   }
@@ -149,12 +148,12 @@ void RandomSampler::draw(std::vector<size_t>& result,
 void RandomSampler::draw_simple(std::vector<size_t>& result,
                                 size_t max,
                                 const std::set<size_t>& skip,
-                                size_t num_samples) {
+                                size_t num_samples,
+                                std::vector<bool>& temp) {
   result.resize(num_samples);
 
   // Set all to not selected
-  std::vector<bool> temp;
-  temp.resize(max, false);
+  temp.assign(max, false);
 
   nonstd::uniform_int_distribution<size_t> unif_dist(0, max - 1 - skip.size());
   for (size_t i = 0; i < num_samples; ++i) {
@@ -103,6 +103,15 @@ public:
             const std::set<size_t>& skip,
             size_t num_samples);
 
+  /**
+   * Same as above, with a scratch buffer that the caller can reuse across draws.
+   */
+  void draw(std::vector<size_t>& result,
+            size_t max,
+            const std::set<size_t>& skip,
+            size_t num_samples,
+            std::vector<bool>& drawn);
+
   size_t sample_poisson(size_t mean);
 
 private:
@@ -123,11 +132,13 @@ private:
    * @param range_length Length of range. Interval to draw from: 0..max-1
    * @param skip Values to skip
    * @param num_samples Number of samples to draw
+   * @param temp Scratch buffer marking the drawn values
    */
   void draw_simple(std::vector<size_t>& result,
                    size_t max,
                    const std::set<size_t>& skip,
-                   size_t num_samples);
+                   size_t num_samples,
+                   std::vector<bool>& temp);
 
     /**
    * Fisher-Yates algorithm for sampling without replacement, faster for larger num_samples
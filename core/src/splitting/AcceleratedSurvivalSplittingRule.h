@@ -40,8 +40,8 @@ public:
   bool find_best_split(const Data& data,
                        size_t node,
                        const std::vector<size_t>& possible_split_vars,
-                       const Eigen::ArrayXXd& responses_by_sample,
-                       const std::vector<std::vector<size_t>>& samples_by_node,
+                       const ResponsesBySample& responses_by_sample,
+                       const NodeSamples& samples_by_node,
                        std::vector<size_t>& split_vars,
                        std::vector<double>& split_values,
                        std::vector<bool>& send_missing_left);
@@ -52,8 +52,8 @@ public:
   */
  void find_best_split_internal(const Data& data,
                                const std::vector<size_t>& possible_split_vars,
-                               const Eigen::ArrayXXd& responses_by_sample,
-                               const std::vector<size_t>& samples,
+                               const ResponsesBySample& responses_by_sample,
+                               SampleSpan samples,
                                double& best_value,
                                size_t& best_var,
                                bool& best_send_missing_left,
@@ -70,13 +70,20 @@ private:
                              size_t& best_var,
                              double& best_logrank,
                              bool& best_send_missing_left,
-                             const std::vector<size_t>& samples,
-                             const std::vector<double>& cumsum_weights,
+                             SampleSpan samples,
                              double gamma_node);
 
   std::vector<size_t> relabeled_failures;
   double alpha;
 
+  // Per node buffers, indexed by the relabeled failure times.
+  std::vector<double> failure_values;
+  std::vector<double> count_failure;
+  std::vector<double> count_censor;
+  std::vector<double> at_risk;
+  std::vector<double> numerator_weights;
+  std::vector<double> cumsum_weights;
+
   DISALLOW_COPY_AND_ASSIGN(AcceleratedSurvivalSplittingRule);
 };
 
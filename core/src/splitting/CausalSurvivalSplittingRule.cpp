@@ -67,8 +67,8 @@ CausalSurvivalSplittingRule::~CausalSurvivalSplittingRule() {
 bool CausalSurvivalSplittingRule::find_best_split(const Data& data,
                                                   size_t node,
                                                   const std::vector<size_t>& possible_split_vars,
-                                                  const Eigen::ArrayXXd& responses_by_sample,
-                                                  const std::vector<std::vector<size_t>>& samples,
+                                                  const ResponsesBySample& responses_by_sample,
+                                                  const NodeSamples& samples,
                                                   std::vector<size_t>& split_vars,
                                                   std::vector<double>& split_values,
                                                   std::vector<bool>& send_missing_left) {
@@ -147,11 +147,9 @@ void CausalSurvivalSplittingRule::find_best_split_value(const Data& data,
                                                         size_t& best_var,
                                                         double& best_decrease,
                                                         bool& best_send_missing_left,
-                                                        const Eigen::ArrayXXd& responses_by_sample,
-                                                        const std::vector<std::vector<size_t>>& samples) {
-  std::vector<double> possible_split_values;
-  std::vector<size_t> sorted_samples;
-  data.get_all_values(possible_split_values, sorted_samples, samples[node], var);
+                                                        const ResponsesBySample& responses_by_sample,
+                                                        const NodeSamples& samples) {
+  get_all_values(data, possible_split_values, sorted_samples, index, samples[node], var);
 
   // Try next variable if all equal for this
   if (possible_split_values.size() < 2) {
@@ -179,7 +177,7 @@ void CausalSurvivalSplittingRule::find_best_split_value(const Data& data,
   for (size_t i = 0; i < num_samples - 1; i++) {
     size_t sample = sorted_samples[i];
     size_t next_sample = sorted_samples[i + 1];
-    double sample_value = data.get(sample, var);
+    double sample_value = data.get_bin_value(sample, var);
     double z = data.get_instrument(sample);
     double sample_weight = data.get_weight(sample);
 
@@ -211,7 +209,7 @@ void CausalSurvivalSplittingRule::find_best_split_value(const Data& data,
       }
     }
 
-    double next_sample_value = data.get(next_sample, var);
+    double next_sample_value = data.get_bin_value(next_sample, var);
     // if the next sample value is different, including the transition (..., NaN, Xij, ...)
     // then move on to the next bucket (all logical operators with NaN evaluates to false by default)
     if (sample_value != next_sample_value && !std::isnan(next_sample_value)) {
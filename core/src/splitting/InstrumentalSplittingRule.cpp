@@ -63,8 +63,8 @@ InstrumentalSplittingRule::~InstrumentalSplittingRule() {
 bool InstrumentalSplittingRule::find_best_split(const Data& data,
                                                 size_t node,
                                                 const std::vector<size_t>& possible_split_vars,
-                                                const Eigen::ArrayXXd& responses_by_sample,
-                                                const std::vector<std::vector<size_t>>& samples,
+                                                const ResponsesBySample& responses_by_sample,
+                                                const NodeSamples& samples,
                                                 std::vector<size_t>& split_vars,
                                                 std::vector<double>& split_values,
                                                 std::vector<bool>& send_missing_left) {
@@ -104,9 +104,15 @@ bool InstrumentalSplittingRule::find_best_split(const Data& data,
   bool best_send_missing_left = true;
 
   for (auto& var : possible_split_vars) {
-    find_best_split_value(data, node, var, num_samples, weight_sum_node, sum_node, mean_z_node, num_node_small_z,
-                          sum_node_z, sum_node_z_squared, min_child_size, best_value,
-                          best_var, best_decrease, best_send_missing_left, responses_by_sample, samples);
+    if (data.has_weights()) {
+      find_best_split_value<true>(data, node, var, num_samples, weight_sum_node, sum_node, mean_z_node, num_node_small_z,
+                                  sum_node_z, sum_node_z_squared, min_child_size, best_value,
+                                  best_var, best_decrease, best_send_missing_left, responses_by_sample, samples);
+    } else {
+      find_best_split_value<false>(data, node, var, num_samples, weight_sum_node, sum_node, mean_z_node, num_node_small_z,
+                                   sum_node_z, sum_node_z_squared, min_child_size, best_value,
+                                   best_var, best_decrease, best_send_missing_left, responses_by_sample, samples);
+    }
   }
 
   // Stop if no good split found
@@ -121,6 +127,7 @@ bool InstrumentalSplittingRule::find_best_split(const Data& data,
   return false;
 }
 
+template <bool weighted>
 void InstrumentalSplittingRule::find_best_split_value(const Data& data,
                                                       size_t node, size_t var,
                                                       size_t num_samples,
@@ -135,11 +142,9 @@ void InstrumentalSplittingRule::find_best_split_value(const Data& data,
                                                       size_t& best_var,
                                                       double& best_decrease,
                                                       bool& best_send_missing_left,
-                                                      const Eigen::ArrayXXd& responses_by_sample,
-                                                      const std::vector<std::vector<size_t>>& samples) {
-  std::vector<double> possible_split_values;
-  std::vector<size_t> sorted_samples;
-  data.get_all_values(possible_split_values, sorted_samples, samples[node], var);
+                                                      const ResponsesBySample& responses_by_sample,
+                                                      const NodeSamples& samples) {
+  get_all_values(data, possible_split_values, sorted_samples, index, samples[node], var);
 
   // Try next variable if all equal for this
   if (possible_split_values.size() < 2) {
@@ -165,9 +170,9 @@ void InstrumentalSplittingRule::find_best_split_value(const Data& data,
   for (size_t i = 0; i < num_samples - 1; i++) {
     size_t sample = sorted_samples[i];
     size_t next_sample = sorted_samples[i + 1];
-    double sample_value = data.get(sample, var);
+    double sample_value = data.get_bin_value(sample, var);
     double z = data.get_instrument(sample);
-    double sample_weight = data.get_weight(sample);
+    double sample_weight = weighted ? data.get_weight(sample) : 1.0;
 
     if (std::isnan(sample_value)) {
       weight_sum_missing += sample_weight;
@@ -191,7 +196,7 @@ void InstrumentalSplittingRule::find_best_split_value(const Data& data,
       }
     }
 
-    double next_sample_value = data.get(next_sample, var);
+    double next_sample_value = data.get_bin_value(next_sample, var);
     // if the next sample value is different, including the transition (..., NaN, Xij, ...)
     // then move on to the next bucket (all logical operators with NaN evaluates to false by default)
     if (sample_value != next_sample_value && !std::isnan(next_sample_value)) {
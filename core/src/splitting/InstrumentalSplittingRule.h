@@ -36,13 +36,14 @@ public:
   bool find_best_split(const Data& data,
                        size_t node,
                        const std::vector<size_t>& possible_split_vars,
-                       const Eigen::ArrayXXd& responses_by_sample,
-                       const std::vector<std::vector<size_t>>& samples,
+                       const ResponsesBySample& responses_by_sample,
+                       const NodeSamples& samples,
                        std::vector<size_t>& split_vars,
                        std::vector<double>& split_values,
                        std::vector<bool>& send_missing_left);
 
 private:
+  template <bool weighted>
   void find_best_split_value(const Data& data,
                              size_t node,
                              size_t var,
@@ -58,8 +59,8 @@ private:
                              size_t& best_var,
                              double& best_decrease,
                              bool& best_send_missing_left,
-                             const Eigen::ArrayXXd& responses_by_sample,
-                             const std::vector<std::vector<size_t>>& samples);
+                             const ResponsesBySample& responses_by_sample,
+                             const NodeSamples& samples);
 
   size_t* counter;
   double* weight_sums;
@@ -40,6 +40,11 @@ MultiCausalSplittingRule::MultiCausalSplittingRule(size_t max_num_unique_values,
   this->num_small_w = Eigen::ArrayXXi(max_num_unique_values, num_treatments);
   this->sums_w = Eigen::ArrayXXd(max_num_unique_values, num_treatments);
   this->sums_w_squared = Eigen::ArrayXXd(max_num_unique_values, num_treatments);
+  this->node_treatments = Eigen::ArrayXXd(max_num_unique_values, num_treatments);
+  this->sum_missing = Eigen::ArrayXd(response_length);
+  this->sum_w_missing = Eigen::ArrayXd(num_treatments);
+  this->sum_w_squared_missing = Eigen::ArrayXd(num_treatments);
+  this->num_small_w_missing = Eigen::ArrayXi(num_treatments);
 }
 
 MultiCausalSplittingRule::~MultiCausalSplittingRule() {
@@ -54,8 +59,8 @@ MultiCausalSplittingRule::~MultiCausalSplittingRule() {
 bool MultiCausalSplittingRule::find_best_split(const Data& data,
                                                size_t node,
                                                const std::vector<size_t>& possible_split_vars,
-                                               const Eigen::ArrayXXd& responses_by_sample,
-                                               const std::vector<std::vector<size_t>>& samples,
+                                               const ResponsesBySample& responses_by_sample,
+                                               const NodeSamples& samples,
                                                std::vector<size_t>& split_vars,
                                                std::vector<double>& split_values,
                                                std::vector<bool>& send_missing_left) {
@@ -66,8 +71,9 @@ bool MultiCausalSplittingRule::find_best_split(const Data& data,
   Eigen::ArrayXd sum_node = Eigen::ArrayXd::Zero(response_length);
   Eigen::ArrayXd sum_node_w = Eigen::ArrayXd::Zero(num_treatments);
   Eigen::ArrayXd sum_node_w_squared = Eigen::ArrayXd::Zero(num_treatments);
-  // Allocate W-array and re-use to avoid expensive copy-inducing calls to `data.get_treatments`
-  Eigen::ArrayXXd treatments = Eigen::ArrayXXd(num_samples, num_treatments);
+  // Gather the node's treatments into the first rows of one array, which `find_best_split_value`
+  // reads by position.
+  Eigen::ArrayXXd& treatments = node_treatments;
   for (size_t i = 0; i < num_samples; i++) {
     size_t sample = samples[node][i];
     double sample_weight = data.get_weight(sample);
@@ -96,9 +102,15 @@ bool MultiCausalSplittingRule::find_best_split(const Data& data,
 
   // For all possible split variables
   for (auto& var : possible_split_vars) {
-    find_best_split_value(data, node, var, num_samples, weight_sum_node, sum_node, mean_w_node, num_node_small_w,
-                          sum_node_w, sum_node_w_squared, min_child_size, treatments, best_value,
-                          best_var, best_decrease, best_send_missing_left, responses_by_sample, samples);
+    if (data.has_weights()) {
+      find_best_split_value<true>(data, node, var, num_samples, weight_sum_node, sum_node, mean_w_node, num_node_small_w,
+                                  sum_node_w, sum_node_w_squared, min_child_size, treatments, best_value,
+                                  best_var, best_decrease, best_send_missing_left, responses_by_sample, samples);
+    } else {
+      find_best_split_value<false>(data, node, var, num_samples, weight_sum_node, sum_node, mean_w_node, num_node_small_w,
+                                   sum_node_w, sum_node_w_squared, min_child_size, treatments, best_value,
+                                   best_var, best_decrease, best_send_missing_left, responses_by_sample, samples);
+    }
   }
 
   // Stop if no good split found
@@ -113,6 +125,7 @@ bool MultiCausalSplittingRule::find_best_split(const Data& data,
   return false;
 }
 
+template <bool weighted>
 void MultiCausalSplittingRule::find_best_split_value(const Data& data,
                                                      size_t node,
                                                      size_t var,
@@ -129,11 +142,9 @@ void MultiCausalSplittingRule::find_best_split_value(const Data& data,
                                                      size_t& best_var,
                                                      double& best_decrease,
                                                      bool& best_send_missing_left,
-                                                     const Eigen::ArrayXXd& responses_by_sample,
-                                                     const std::vector<std::vector<size_t>>& samples) {
-  std::vector<double> possible_split_values;
-  std::vector<size_t> sorted_samples;
-  std::vector<size_t> index = data.get_all_values(possible_split_values, sorted_samples, samples[node], var);
+                                                     const ResponsesBySample& responses_by_sample,
+                                                     const NodeSamples& samples) {
+  get_all_values(data, possible_split_values, sorted_samples, index, samples[node], var);
 
   // Try next variable if all equal for this
   if (possible_split_values.size() < 2) {
@@ -150,18 +161,18 @@ void MultiCausalSplittingRule::find_best_split_value(const Data& data,
   sums_w_squared.topRows(num_splits).setZero();
   size_t n_missing = 0;
   double weight_sum_missing = 0;
-  Eigen::ArrayXd sum_missing = Eigen::ArrayXd::Zero(response_length);
-  Eigen::ArrayXd sum_w_missing = Eigen::ArrayXd::Zero(num_treatments);
-  Eigen::ArrayXd sum_w_squared_missing = Eigen::ArrayXd::Zero(num_treatments);
-  Eigen::ArrayXi num_small_w_missing = Eigen::ArrayXi::Zero(num_treatments);
+  sum_missing.setZero();
+  sum_w_missing.setZero();
+  sum_w_squared_missing.setZero();
+  num_small_w_missing.setZero();
 
   size_t split_index = 0;
   for (size_t i = 0; i < num_samples - 1; i++) {
     size_t sample = sorted_samples[i];
     size_t next_sample = sorted_samples[i + 1];
     size_t sort_index = index[i];
-    double sample_value = data.get(sample, var);
-    double sample_weight = data.get_weight(sample);
+    double sample_value = data.get_bin_value(sample, var);
+    double sample_weight = weighted ? data.get_weight(sample) : 1.0;
 
     if (std::isnan(sample_value)) {
       weight_sum_missing += sample_weight;
@@ -181,7 +192,7 @@ void MultiCausalSplittingRule::find_best_split_value(const Data& data,
       num_small_w.row(split_index) += (treatments.row(sort_index).transpose() < mean_node_w).cast<int>();
     }
 
-    double next_sample_value = data.get(next_sample, var);
+    double next_sample_value = data.get_bin_value(next_sample, var);
     // if the next sample value is different, including the transition (..., NaN, Xij, ...)
     // then move on to the next bucket (all logical operators with NaN evaluates to false by default)
     if (sample_value != next_sample_value && !std::isnan(next_sample_value)) {
@@ -55,13 +55,14 @@ public:
   bool find_best_split(const Data& data,
                        size_t node,
                        const std::vector<size_t>& possible_split_vars,
-                       const Eigen::ArrayXXd& responses_by_sample,
-                       const std::vector<std::vector<size_t>>& samples,
+                       const ResponsesBySample& responses_by_sample,
+                       const NodeSamples& samples,
                        std::vector<size_t>& split_vars,
                        std::vector<double>& split_values,
                        std::vector<bool>& send_missing_left);
 
 private:
+  template <bool weighted>
   void find_best_split_value(const Data& data,
                              size_t node,
                              size_t var,
@@ -78,8 +79,8 @@ private:
                              size_t& best_var,
                              double& best_decrease,
                              bool& best_send_missing_left,
-                             const Eigen::ArrayXXd& responses_by_sample,
-                             const std::vector<std::vector<size_t>>& samples);
+                             const ResponsesBySample& responses_by_sample,
+                             const NodeSamples& samples);
 
   size_t* counter;
   double* weight_sums;
@@ -87,6 +88,11 @@ private:
   Eigen::ArrayXXi num_small_w;
   Eigen::ArrayXXd sums_w;
   Eigen::ArrayXXd sums_w_squared;
+  Eigen::ArrayXXd node_treatments;
+  Eigen::ArrayXd sum_missing;
+  Eigen::ArrayXd sum_w_missing;
+  Eigen::ArrayXd sum_w_squared_missing;
+  Eigen::ArrayXi num_small_w_missing;
 
   uint min_node_size;
   double alpha;
@@ -33,6 +33,7 @@ MultiRegressionSplittingRule::MultiRegressionSplittingRule(size_t max_num_unique
   this->counter = new size_t[max_num_unique_values];
   this->sums = Eigen::ArrayXXd(max_num_unique_values, num_outcomes);
   this->weight_sums = new double[max_num_unique_values];
+  this->sum_missing = Eigen::ArrayXd(num_outcomes);
 }
 
 MultiRegressionSplittingRule::~MultiRegressionSplittingRule() {
@@ -47,8 +48,8 @@ MultiRegressionSplittingRule::~MultiRegressionSplittingRule() {
 bool MultiRegressionSplittingRule::find_best_split(const Data& data,
                                                    size_t node,
                                                    const std::vector<size_t>& possible_split_vars,
-                                                   const Eigen::ArrayXXd& responses_by_sample,
-                                                   const std::vector<std::vector<size_t>>& samples,
+                                                   const ResponsesBySample& responses_by_sample,
+                                                   const NodeSamples& samples,
                                                    std::vector<size_t>& split_vars,
                                                    std::vector<double>& split_values,
                                                    std::vector<bool>& send_missing_left) {
@@ -63,6 +64,15 @@ bool MultiRegressionSplittingRule::find_best_split(const Data& data,
     double sample_weight = data.get_weight(sample);
     weight_sum_node += sample_weight;
     sum_node += sample_weight * responses_by_sample.row(sample);
+
+    if (node_histograms != nullptr) {
+      double* stats = node_histograms->get_sample_stats(sample);
+      stats[0] = 1;
+      stats[1] = sample_weight;
+      for (size_t j = 0; j < num_outcomes; j++) {
+        stats[2 + j] = sample_weight * responses_by_sample(sample, j);
+      }
+    }
   }
 
   // Initialize the variables to track the best split variable.
@@ -97,12 +107,16 @@ void MultiRegressionSplittingRule::find_best_split_value(const Data& data,
                                                     size_t min_child_size,
                                                     double& best_value, size_t& best_var,
                                                     double& best_decrease, bool& best_send_missing_left,
-                                                    const Eigen::ArrayXXd& responses_by_sample,
-                                                    const std::vector<std::vector<size_t>>& samples) {
+                                                    const ResponsesBySample& responses_by_sample,
+                                                    const NodeSamples& samples) {
   // sorted_samples: the node samples in increasing order (may contain duplicated Xij). Length: size_node
-  std::vector<double> possible_split_values;
-  std::vector<size_t> sorted_samples;
-  data.get_all_values(possible_split_values, sorted_samples, samples[node], var);
+  const double* histogram = nullptr;
+  if (node_histograms != nullptr) {
+    histogram = node_histograms->get_histogram(node, var, samples, possible_split_values, bins);
+  }
+  if (histogram == nullptr) {
+    get_all_values(data, possible_split_values, sorted_samples, index, samples[node], var);
+  }
 
   // Try next variable if all equal for this
   if (possible_split_values.size() < 2) {
@@ -115,31 +129,47 @@ void MultiRegressionSplittingRule::find_best_split_value(const Data& data,
   sums.topRows(num_splits).setZero(); // Sets the first num_splits rows to zeros.
   size_t n_missing = 0;
   double weight_sum_missing = 0;
-  Eigen::ArrayXd sum_missing = Eigen::ArrayXd::Zero(num_outcomes);
-
-  // Fill counter and sums buckets
-  size_t split_index = 0;
-  for (size_t i = 0; i < size_node - 1; i++) {
-    size_t sample = sorted_samples[i];
-    size_t next_sample = sorted_samples[i + 1];
-    double sample_value = data.get(sample, var);
-    double sample_weight = data.get_weight(sample);
-
-    if (std::isnan(sample_value)) {
-      weight_sum_missing += sample_weight;
-      sum_missing += sample_weight * responses_by_sample.row(sample);
-      ++n_missing;
-    } else {
-      weight_sums[split_index] += sample_weight;
-      sums.row(split_index) += sample_weight * responses_by_sample.row(sample);
-      ++counter[split_index];
+  sum_missing.setZero();
+
+  if (histogram != nullptr) {
+    // Fill counter and sums buckets with the non-empty bins, the first of which may hold the missing values.
+    for (size_t i = 0; i < num_splits; i++) {
+      const double* bin_stats = histogram + bins[i] * (2 + num_outcomes);
+      if (bins[i] == 0) {
+        n_missing = static_cast<size_t>(bin_stats[0]);
+        weight_sum_missing = bin_stats[1];
+        sum_missing = Eigen::Map<const Eigen::ArrayXd>(bin_stats + 2, num_outcomes);
+      } else {
+        counter[i] = static_cast<size_t>(bin_stats[0]);
+        weight_sums[i] = bin_stats[1];
+        sums.row(i) = Eigen::Map<const Eigen::ArrayXd>(bin_stats + 2, num_outcomes).transpose();
+      }
     }
+  } else {
+    // Fill counter and sums buckets
+    size_t split_index = 0;
+    for (size_t i = 0; i < size_node - 1; i++) {
+      size_t sample = sorted_samples[i];
+      size_t next_sample = sorted_samples[i + 1];
+      double sample_value = data.get_bin_value(sample, var);
+      double sample_weight = data.get_weight(sample);
+
+      if (std::isnan(sample_value)) {
+        weight_sum_missing += sample_weight;
+        sum_missing += sample_weight * responses_by_sample.row(sample);
+        ++n_missing;
+      } else {
+        weight_sums[split_index] += sample_weight;
+        sums.row(split_index) += sample_weight * responses_by_sample.row(sample);
+        ++counter[split_index];
+      }
 
-    double next_sample_value = data.get(next_sample, var);
-    // if the next sample value is different, including the transition (..., NaN, Xij, ...)
-    // then move on to the next bucket (all logical operators with NaN evaluates to false by default)
-    if (sample_value != next_sample_value && !std::isnan(next_sample_value)) {
-      ++split_index;
+      double next_sample_value = data.get_bin_value(next_sample, var);
+      // if the next sample value is different, including the transition (..., NaN, Xij, ...)
+      // then move on to the next bucket (all logical operators with NaN evaluates to false by default)
+      if (sample_value != next_sample_value && !std::isnan(next_sample_value)) {
+        ++split_index;
+      }
     }
   }
 
@@ -204,4 +234,8 @@ void MultiRegressionSplittingRule::find_best_split_value(const Data& data,
   }
 }
 
+size_t MultiRegressionSplittingRule::get_num_histogram_stats() const {
+  return 2 + num_outcomes;
+}
+
 } // namespace grf
@@ -43,12 +43,15 @@ public:
   bool find_best_split(const Data& data,
                        size_t node,
                        const std::vector<size_t>& possible_split_vars,
-                       const Eigen::ArrayXXd& responses_by_sample,
-                       const std::vector<std::vector<size_t>>& samples,
+                       const ResponsesBySample& responses_by_sample,
+                       const NodeSamples& samples,
                        std::vector<size_t>& split_vars,
                        std::vector<double>& split_values,
                        std::vector<bool>& send_missing_left);
 
+  // The sample count, weight and weighted responses.
+  size_t get_num_histogram_stats() const;
+
 private:
   void find_best_split_value(const Data& data,
                              size_t node,
@@ -61,12 +64,13 @@ private:
                              size_t& best_var,
                              double& best_decrease,
                              bool& best_send_missing_left,
-                             const Eigen::ArrayXXd& responses_by_sample,
-                             const std::vector<std::vector<size_t>>& samples);
+                             const ResponsesBySample& responses_by_sample,
+                             const NodeSamples& samples);
 
   size_t* counter;
   Eigen::ArrayXXd sums;
   double* weight_sums;
+  Eigen::ArrayXd sum_missing;
 
   double alpha;
   double imbalance_penalty;
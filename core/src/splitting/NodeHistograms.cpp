@@ -0,0 +1,185 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+
+#include <algorithm>
+
+#include "splitting/NodeHistograms.h"
+
+namespace grf {
+
+NodeHistograms::NodeHistograms(const Data& data,
+                               size_t num_stats):
+    data(data),
+    num_stats(num_stats),
+    sample_stats(data.get_num_rows() * num_stats),
+    parent(1, 0),
+    sibling(1, 0),
+    is_leaf_node(1, false) {}
+
+void NodeHistograms::reset() {
+  histograms.clear();
+  parent.assign(1, 0);
+  sibling.assign(1, 0);
+  is_leaf_node.assign(1, false);
+}
+
+double* NodeHistograms::get_sample_stats(size_t sample) {
+  return sample_stats.data() + sample * num_stats;
+}
+
+const double* NodeHistograms::get_histogram(size_t node,
+                                            size_t var,
+                                            const NodeSamples& samples,
+                                            std::vector<double>& all_values,
+                                            std::vector<size_t>& bins) {
+  if (find(node, var) == nullptr && samples[node].size() < data.get_num_bins(var)) {
+    return nullptr;
+  }
+  const std::vector<double>& histogram = compute_histogram(node, var, samples);
+
+  all_values.clear();
+  bins.clear();
+  size_t num_bins = data.get_num_bins(var);
+  for (size_t bin = 0; bin < num_bins; bin++) {
+    if (histogram[bin * num_stats] > 0) {
+      all_values.push_back(data.get_bin_upper_value(var, bin));
+      bins.push_back(bin);
+    }
+  }
+
+  return histogram.data();
+}
+
+void NodeHistograms::split_node(size_t node,
+                                size_t left_child,
+                                size_t right_child) {
+  size_t num_nodes = std::max(left_child, right_child) + 1;
+  parent.resize(num_nodes);
+  sibling.resize(num_nodes);
+  is_leaf_node.resize(num_nodes, false);
+
+  parent[left_child] = node;
+  parent[right_child] = node;
+  sibling[left_child] = right_child;
+  sibling[right_child] = left_child;
+}
+
+void NodeHistograms::finish_node(size_t node,
+                                 bool is_leaf) {
+  is_leaf_node[node] = is_leaf;
+  if (node == 0) {
+    if (is_leaf) {
+      histograms.clear();
+    }
+    return;
+  }
+
+  // Once the right child is done, both siblings have used the parent's histograms.
+  bool is_right_child = sibling[node] < node;
+  if (is_right_child) {
+    histograms.erase(parent[node]);
+    if (is_leaf_node[sibling[node]]) {
+      histograms.erase(sibling[node]);
+    }
+    if (is_leaf) {
+      histograms.erase(node);
+    }
+  }
+}
+
+const std::vector<double>& NodeHistograms::compute_histogram(size_t node,
+                                                             size_t var,
+                                                             const NodeSamples& samples) {
+  const std::vector<double>* kept_histogram = find(node, var);
+  if (kept_histogram != nullptr) {
+    return *kept_histogram;
+  }
+
+  std::vector<double>& histogram = should_keep(node, var, samples[node].size())
+      ? get_kept_histogram(node, var)
+      : histogram_buffer;
+
+  const std::vector<double>* parent_histogram = node > 0 ? find(parent[node], var) : nullptr;
+  if (parent_histogram != nullptr) {
+    size_t sibling_node = sibling[node];
+    const std::vector<double>* sibling_histogram = find(sibling_node, var);
+
+    // Build the histogram of the smaller sibling if its samples are still there (the
+    // samples of a node are cleared once it is split), and keep it for the sibling.
+    if (sibling_histogram == nullptr
+        && !samples[sibling_node].empty()
+        && samples[sibling_node].size() < samples[node].size()) {
+      std::vector<double>& new_sibling_histogram = should_keep(sibling_node, var, samples[sibling_node].size())
+          ? get_kept_histogram(sibling_node, var)
+          : sibling_histogram_buffer;
+      fill_histogram(new_sibling_histogram, samples[sibling_node], var);
+      sibling_histogram = &new_sibling_histogram;
+    }
+
+    if (sibling_histogram != nullptr) {
+      histogram.resize(parent_histogram->size());
+      for (size_t i = 0; i < histogram.size(); i++) {
+        histogram[i] = (*parent_histogram)[i] - (*sibling_histogram)[i];
+      }
+      return histogram;
+    }
+  }
+
+  fill_histogram(histogram, samples[node], var);
+  return histogram;
+}
+
+void NodeHistograms::fill_histogram(std::vector<double>& histogram,
+                                    SampleSpan samples,
+                                    size_t var) const {
+  histogram.assign(data.get_num_bins(var) * num_stats, 0);
+  for (auto& sample : samples) {
+    double* bin_stats = histogram.data() + data.get_bin(sample, var) * num_stats;
+    const double* stats = sample_stats.data() + sample * num_stats;
+    for (size_t i = 0; i < num_stats; i++) {
+      bin_stats[i] += stats[i];
+    }
+  }
+}
+
+const std::vector<double>* NodeHistograms::find(size_t node, size_t var) const {
+  auto it = histograms.find(node);
+  if (it == histograms.end() || it->second[var].empty()) {
+    return nullptr;
+  }
+  return &it->second[var];
+}
+
+bool NodeHistograms::should_keep(size_t node, size_t var, size_t num_samples) const {
+  // A node's histogram is kept for its own children if it is large enough, and always
+  // if its parent has one, since the sibling can then be derived from it.
+  return num_samples >= data.get_num_bins(var) * num_stats
+      || (node > 0 && find(parent[node], var) != nullptr);
+}
+
+std::vector<double>& NodeHistograms::get_kept_histogram(size_t node, size_t var) {
+  std::vector<std::vector<double>>& node_histograms = histograms[node];
+  if (node_histograms.empty()) {
+    node_histograms.resize(data.get_num_cols());
+  }
+  return node_histograms[var];
+}
+
+} // namespace grf
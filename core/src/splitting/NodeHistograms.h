@@ -0,0 +1,131 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+
+#ifndef GRF_NODEHISTOGRAMS_H
+#define GRF_NODEHISTOGRAMS_H
+
+#include <unordered_map>
+#include <vector>
+
+#include "commons/Data.h"
+#include "commons/NodeSamples.h"
+#include "commons/globals.h"
+
+namespace grf {
+
+/**
+ * Per-bin sums of sample statistics for the nodes of a tree, for binned covariates
+ * (see Data::set_max_bins).
+ *
+ * Every sample has a row of `num_stats` statistics filled in by the splitting rule, the
+ * first of which is always 1 so that the first column of a histogram counts the samples
+ * in each bin. If these statistics do not depend on the node a sample is in (see
+ * RelabelingStrategy::is_node_invariant), the histogram of a child is the histogram of
+ * its parent minus the one of its sibling: only the smaller sibling's histogram is built
+ * from its samples, and the larger one is derived from it in time proportional to the
+ * number of bins.
+ *
+ * A node only uses histograms if it has at least as many samples as bins, since smaller
+ * nodes are cheaper to sort. It keeps them for its children if it has at least as many
+ * samples as histogram entries, which bounds the histograms of all open nodes to one
+ * value per tree growing sample and covariate.
+ */
+class NodeHistograms {
+public:
+  NodeHistograms(const Data& data,
+                 size_t num_stats);
+
+  /**
+   * Drops the histograms of the previous tree, keeping the allocated buffers.
+   */
+  void reset();
+
+  /**
+   * The statistics of a sample, to be filled in by the splitting rule.
+   */
+  double* get_sample_stats(size_t sample);
+
+  /**
+   * Gets the histogram of `var` at a node: an array of num_stats values per bin, holding
+   * the summed statistics of the node's samples in that bin.
+   *
+   * @param node: the node ID in the tree.
+   * @param var: the (binned) covariate.
+   * @param samples: the samples of every node, as passed to the splitting rule.
+   * @param all_values: the output of the method, the values of the non-empty bins in
+   * increasing order (with NaN first), same as Data::get_all_values.
+   * @param bins: the output of the method, the non-empty bins matching `all_values`.
+   * @return a pointer to the histogram, valid until the next call, or nullptr if the
+   * node is too small for histograms and the samples should be sorted instead.
+   */
+  const double* get_histogram(size_t node,
+                              size_t var,
+                              const NodeSamples& samples,
+                              std::vector<double>& all_values,
+                              std::vector<size_t>& bins);
+
+  /**
+   * Records the children of a node that was split.
+   */
+  void split_node(size_t node,
+                  size_t left_child,
+                  size_t right_child);
+
+  /**
+   * Releases the histograms that are no longer needed once a node has been processed.
+   * Siblings are processed one after the other, left child first.
+   */
+  void finish_node(size_t node,
+                   bool is_leaf);
+
+private:
+  const std::vector<double>& compute_histogram(size_t node,
+                                               size_t var,
+                                               const NodeSamples& samples);
+
+  void fill_histogram(std::vector<double>& histogram,
+                      SampleSpan samples,
+                      size_t var) const;
+
+  const std::vector<double>* find(size_t node, size_t var) const;
+
+  bool should_keep(size_t node, size_t var, size_t num_samples) const;
+
+  std::vector<double>& get_kept_histogram(size_t node, size_t var);
+
+  const Data& data;
+  size_t num_stats;
+  std::vector<double> sample_stats;
+
+  // The histograms kept for each node, with an empty histogram for covariates that were not computed.
+  std::unordered_map<size_t, std::vector<std::vector<double>>> histograms;
+  std::vector<double> histogram_buffer;
+  std::vector<double> sibling_histogram_buffer;
+
+  std::vector<size_t> parent;
+  std::vector<size_t> sibling;
+  std::vector<bool> is_leaf_node;
+
+  DISALLOW_COPY_AND_ASSIGN(NodeHistograms);
+};
+
+} // namespace grf
+
+#endif //GRF_NODEHISTOGRAMS_H
@@ -35,6 +35,8 @@ ProbabilitySplittingRule::ProbabilitySplittingRule(size_t max_num_unique_values,
 
   this->counter = new size_t[max_num_unique_values];
   this->counter_per_class = new double[num_classes * max_num_unique_values];
+  this->node_class_counts = new double[num_classes];
+  this->class_counts_missing = new double[num_classes];
 }
 
 ProbabilitySplittingRule::~ProbabilitySplittingRule() {
@@ -44,25 +46,39 @@ ProbabilitySplittingRule::~ProbabilitySplittingRule() {
   if (counter_per_class != nullptr) {
     delete[] counter_per_class;
   }
+  if (node_class_counts != nullptr) {
+    delete[] node_class_counts;
+  }
+  if (class_counts_missing != nullptr) {
+    delete[] class_counts_missing;
+  }
 }
 
 bool ProbabilitySplittingRule::find_best_split(const Data& data,
                                                size_t node,
                                                const std::vector<size_t>& possible_split_vars,
-                                               const Eigen::ArrayXXd& responses_by_sample,
-                                               const std::vector<std::vector<size_t>>& samples,
+                                               const ResponsesBySample& responses_by_sample,
+                                               const NodeSamples& samples,
                                                std::vector<size_t>& split_vars,
                                                std::vector<double>& split_values,
                                                std::vector<bool>& send_missing_left) {
   size_t size_node = samples[node].size();
   size_t min_child_size = std::max<size_t>(static_cast<size_t>(std::ceil(size_node * alpha)), 1uL);
 
-  double* class_counts = new double[num_classes]();
+  double* class_counts = node_class_counts;
+  std::fill(class_counts, class_counts + num_classes, 0);
   for (size_t i = 0; i < size_node; ++i) {
     size_t sample = samples[node][i];
     uint sample_class = (uint) std::round(responses_by_sample(sample, 0));
     double sample_weight = data.get_weight(sample);
     class_counts[sample_class] += sample_weight;
+
+    if (node_histograms != nullptr) {
+      double* stats = node_histograms->get_sample_stats(sample);
+      stats[0] = 1;
+      std::fill(stats + 1, stats + 1 + num_classes, 0);
+      stats[1 + sample_class] = sample_weight;
+    }
   }
 
   // Initialize the variables to track the best split variable.
@@ -73,12 +89,15 @@ bool ProbabilitySplittingRule::find_best_split(const Data& data,
 
   // For all possible split variables
   for (size_t var : possible_split_vars) {
-    find_best_split_value(data, node, var, num_classes, class_counts, size_node, min_child_size,
-                          best_value, best_var, best_decrease, best_send_missing_left, responses_by_sample, samples);
+    if (data.has_weights()) {
+      find_best_split_value<true>(data, node, var, num_classes, class_counts, size_node, min_child_size,
+                                  best_value, best_var, best_decrease, best_send_missing_left, responses_by_sample, samples);
+    } else {
+      find_best_split_value<false>(data, node, var, num_classes, class_counts, size_node, min_child_size,
+                                   best_value, best_var, best_decrease, best_send_missing_left, responses_by_sample, samples);
+    }
   }
 
-  delete[] class_counts;
-
   // Stop if no good split found
   if (best_decrease <= 0.0) {
     return true;
@@ -92,6 +111,7 @@ bool ProbabilitySplittingRule::find_best_split(const Data& data,
   return false;
 }
 
+template <bool weighted>
 void ProbabilitySplittingRule::find_best_split_value(const Data& data,
                                                      size_t node, size_t var,
                                                      size_t num_classes,
@@ -102,11 +122,15 @@ void ProbabilitySplittingRule::find_best_split_value(const Data& data,
                                                      size_t& best_var,
                                                      double& best_decrease,
                                                      bool& best_send_missing_left,
-                                                     const Eigen::ArrayXXd& responses_by_sample,
-                                                     const std::vector<std::vector<size_t>>& samples) {
-  std::vector<double> possible_split_values;
-  std::vector<size_t> sorted_samples;
-  data.get_all_values(possible_split_values, sorted_samples, samples[node], var);
+                                                     const ResponsesBySample& responses_by_sample,
+                                                     const NodeSamples& samples) {
+  const double* histogram = nullptr;
+  if (node_histograms != nullptr) {
+    histogram = node_histograms->get_histogram(node, var, samples, possible_split_values, bins);
+  }
+  if (histogram == nullptr) {
+    get_all_values(data, possible_split_values, sorted_samples, index, samples[node], var);
+  }
 
   // Try next variable if all equal for this
   if (possible_split_values.size() < 2) {
@@ -118,29 +142,43 @@ void ProbabilitySplittingRule::find_best_split_value(const Data& data,
   std::fill(counter_per_class, counter_per_class + num_splits * num_classes, 0);
   std::fill(counter, counter + num_splits, 0);
   size_t n_missing = 0;
-  double* class_counts_missing = new double[num_classes]();
-
-  size_t split_index = 0;
-  for (size_t i = 0; i < size_node - 1; i++) {
-    size_t sample = sorted_samples[i];
-    size_t next_sample = sorted_samples[i + 1];
-    double sample_value = data.get(sample, var);
-    uint sample_class = static_cast<uint>(responses_by_sample(sample, 0));
-    double sample_weight = data.get_weight(sample);
-
-    if (std::isnan(sample_value)) {
-      class_counts_missing[sample_class] += sample_weight;
-      ++n_missing;
-    } else {
-      ++counter[split_index];
-      counter_per_class[split_index * num_classes + sample_class] += sample_weight;
+  std::fill(class_counts_missing, class_counts_missing + num_classes, 0);
+
+  if (histogram != nullptr) {
+    // Fill the buckets with the non-empty bins, the first of which may hold the missing values.
+    for (size_t i = 0; i < num_splits; i++) {
+      const double* bin_stats = histogram + bins[i] * (1 + num_classes);
+      if (bins[i] == 0) {
+        n_missing = static_cast<size_t>(bin_stats[0]);
+        std::copy(bin_stats + 1, bin_stats + 1 + num_classes, class_counts_missing);
+      } else {
+        counter[i] = static_cast<size_t>(bin_stats[0]);
+        std::copy(bin_stats + 1, bin_stats + 1 + num_classes, counter_per_class + i * num_classes);
+      }
     }
+  } else {
+    size_t split_index = 0;
+    for (size_t i = 0; i < size_node - 1; i++) {
+      size_t sample = sorted_samples[i];
+      size_t next_sample = sorted_samples[i + 1];
+      double sample_value = data.get_bin_value(sample, var);
+      uint sample_class = static_cast<uint>(responses_by_sample(sample, 0));
+      double sample_weight = weighted ? data.get_weight(sample) : 1.0;
+
+      if (std::isnan(sample_value)) {
+        class_counts_missing[sample_class] += sample_weight;
+        ++n_missing;
+      } else {
+        ++counter[split_index];
+        counter_per_class[split_index * num_classes + sample_class] += sample_weight;
+      }
 
-    double next_sample_value = data.get(next_sample, var);
-    // if the next sample value is different, including the transition (..., NaN, Xij, ...)
-    // then move on to the next bucket (all logical operators with NaN evaluates to false by default)
-    if (sample_value != next_sample_value && !std::isnan(next_sample_value)) {
-      ++split_index;
+      double next_sample_value = data.get_bin_value(next_sample, var);
+      // if the next sample value is different, including the transition (..., NaN, Xij, ...)
+      // then move on to the next bucket (all logical operators with NaN evaluates to false by default)
+      if (sample_value != next_sample_value && !std::isnan(next_sample_value)) {
+        ++split_index;
+      }
     }
   }
 
@@ -208,7 +246,10 @@ void ProbabilitySplittingRule::find_best_split_value(const Data& data,
       }
     }
   }
-  delete[] class_counts_missing;
+}
+
+size_t ProbabilitySplittingRule::get_num_histogram_stats() const {
+  return 1 + num_classes;
 }
 
 } // namespace grf
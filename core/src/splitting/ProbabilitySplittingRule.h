@@ -39,13 +39,17 @@ public:
   bool find_best_split(const Data& data,
                        size_t node,
                        const std::vector<size_t>& possible_split_vars,
-                       const Eigen::ArrayXXd& responses_by_sample,
-                       const std::vector<std::vector<size_t>>& samples,
+                       const ResponsesBySample& responses_by_sample,
+                       const NodeSamples& samples,
                        std::vector<size_t>& split_vars,
                        std::vector<double>& split_values,
                        std::vector<bool>& send_missing_left);
 
+  // The sample count and the sample weight for each class.
+  size_t get_num_histogram_stats() const;
+
 private:
+  template <bool weighted>
   void find_best_split_value(const Data& data,
                              size_t node, size_t var, size_t num_classes, double* class_counts,
                              size_t size_node,
@@ -54,8 +58,8 @@ private:
                              size_t& best_var,
                              double& best_decrease,
                              bool& best_send_missing_left,
-                             const Eigen::ArrayXXd& responses_by_sample,
-                             const std::vector<std::vector<size_t>>& samples);
+                             const ResponsesBySample& responses_by_sample,
+                             const NodeSamples& samples);
 
   size_t num_classes;
 
@@ -64,6 +68,8 @@ private:
 
   size_t* counter;
   double* counter_per_class;
+  double* node_class_counts;
+  double* class_counts_missing;
 
   DISALLOW_COPY_AND_ASSIGN(ProbabilitySplittingRule);
 };
@@ -48,8 +48,8 @@ RegressionSplittingRule::~RegressionSplittingRule() {
 bool RegressionSplittingRule::find_best_split(const Data& data,
                                               size_t node,
                                               const std::vector<size_t>& possible_split_vars,
-                                              const Eigen::ArrayXXd& responses_by_sample,
-                                              const std::vector<std::vector<size_t>>& samples,
+                                              const ResponsesBySample& responses_by_sample,
+                                              const NodeSamples& samples,
                                               std::vector<size_t>& split_vars,
                                               std::vector<double>& split_values,
                                               std::vector<bool>& send_missing_left) {
@@ -64,6 +64,13 @@ bool RegressionSplittingRule::find_best_split(const Data& data,
     double sample_weight = data.get_weight(sample);
     weight_sum_node += sample_weight;
     sum_node += sample_weight * responses_by_sample(sample, 0);
+
+    if (node_histograms != nullptr) {
+      double* stats = node_histograms->get_sample_stats(sample);
+      stats[0] = 1;
+      stats[1] = sample_weight;
+      stats[2] = sample_weight * responses_by_sample(sample, 0);
+    }
   }
 
   // Initialize the variables to track the best split variable.
@@ -74,8 +81,13 @@ bool RegressionSplittingRule::find_best_split(const Data& data,
 
   // For all possible split variables
   for (auto& var : possible_split_vars) {
-    find_best_split_value(data, node, var, weight_sum_node, sum_node, size_node, min_child_size,
-                          best_value, best_var, best_decrease, best_send_missing_left, responses_by_sample, samples);
+    if (data.has_weights()) {
+      find_best_split_value<true>(data, node, var, weight_sum_node, sum_node, size_node, min_child_size,
+                                  best_value, best_var, best_decrease, best_send_missing_left, responses_by_sample, samples);
+    } else {
+      find_best_split_value<false>(data, node, var, weight_sum_node, sum_node, size_node, min_child_size,
+                                   best_value, best_var, best_decrease, best_send_missing_left, responses_by_sample, samples);
+    }
   }
 
   // Stop if no good split found
@@ -90,6 +102,7 @@ bool RegressionSplittingRule::find_best_split(const Data& data,
   return false;
 }
 
+template <bool weighted>
 void RegressionSplittingRule::find_best_split_value(const Data& data,
                                                     size_t node, size_t var,
                                                     double weight_sum_node,
@@ -98,12 +111,16 @@ void RegressionSplittingRule::find_best_split_value(const Data& data,
                                                     size_t min_child_size,
                                                     double& best_value, size_t& best_var,
                                                     double& best_decrease, bool& best_send_missing_left,
-                                                    const Eigen::ArrayXXd& responses_by_sample,
-                                                    const std::vector<std::vector<size_t>>& samples) {
+                                                    const ResponsesBySample& responses_by_sample,
+                                                    const NodeSamples& samples) {
   // sorted_samples: the node samples in increasing order (may contain duplicated Xij). Length: size_node
-  std::vector<double> possible_split_values;
-  std::vector<size_t> sorted_samples;
-  data.get_all_values(possible_split_values, sorted_samples, samples[node], var);
+  const double* histogram = nullptr;
+  if (node_histograms != nullptr) {
+    histogram = node_histograms->get_histogram(node, var, samples, possible_split_values, bins);
+  }
+  if (histogram == nullptr) {
+    get_all_values(data, possible_split_values, sorted_samples, index, samples[node], var);
+  }
 
   // Try next variable if all equal for this
   if (possible_split_values.size() < 2) {
@@ -118,30 +135,46 @@ void RegressionSplittingRule::find_best_split_value(const Data& data,
   double weight_sum_missing = 0;
   double sum_missing = 0;
 
-  // Fill counter and sums buckets
-  size_t split_index = 0;
-  for (size_t i = 0; i < size_node - 1; i++) {
-    size_t sample = sorted_samples[i];
-    size_t next_sample = sorted_samples[i + 1];
-    double sample_value = data.get(sample, var);
-    double response = responses_by_sample(sample, 0);
-    double sample_weight = data.get_weight(sample);
-
-    if (std::isnan(sample_value)) {
-      weight_sum_missing += sample_weight;
-      sum_missing += sample_weight * response;
-      ++n_missing;
-    } else {
-      weight_sums[split_index] += sample_weight;
-      sums[split_index] += sample_weight * response;
-      ++counter[split_index];
+  if (histogram != nullptr) {
+    // Fill counter and sums buckets with the non-empty bins, the first of which may hold the missing values.
+    for (size_t i = 0; i < num_splits; i++) {
+      const double* bin_stats = histogram + bins[i] * 3;
+      if (bins[i] == 0) {
+        n_missing = static_cast<size_t>(bin_stats[0]);
+        weight_sum_missing = bin_stats[1];
+        sum_missing = bin_stats[2];
+      } else {
+        counter[i] = static_cast<size_t>(bin_stats[0]);
+        weight_sums[i] = bin_stats[1];
+        sums[i] = bin_stats[2];
+      }
     }
+  } else {
+    // Fill counter and sums buckets
+    size_t split_index = 0;
+    for (size_t i = 0; i < size_node - 1; i++) {
+      size_t sample = sorted_samples[i];
+      size_t next_sample = sorted_samples[i + 1];
+      double sample_value = data.get_bin_value(sample, var);
+      double response = responses_by_sample(sample, 0);
+      double sample_weight = weighted ? data.get_weight(sample) : 1.0;
+
+      if (std::isnan(sample_value)) {
+        weight_sum_missing += sample_weight;
+        sum_missing += sample_weight * response;
+        ++n_missing;
+      } else {
+        weight_sums[split_index] += sample_weight;
+        sums[split_index] += sample_weight * response;
+        ++counter[split_index];
+      }
 
-    double next_sample_value = data.get(next_sample, var);
-    // if the next sample value is different, including the transition (..., NaN, Xij, ...)
-    // then move on to the next bucket (all logical operators with NaN evaluates to false by default)
-    if (sample_value != next_sample_value && !std::isnan(next_sample_value)) {
-      ++split_index;
+      double next_sample_value = data.get_bin_value(next_sample, var);
+      // if the next sample value is different, including the transition (..., NaN, Xij, ...)
+      // then move on to the next bucket (all logical operators with NaN evaluates to false by default)
+      if (sample_value != next_sample_value && !std::isnan(next_sample_value)) {
+        ++split_index;
+      }
     }
   }
 
@@ -204,4 +237,8 @@ void RegressionSplittingRule::find_best_split_value(const Data& data,
   }
 }
 
+size_t RegressionSplittingRule::get_num_histogram_stats() const {
+  return 3;
+}
+
 } // namespace grf
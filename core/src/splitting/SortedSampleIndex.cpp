@@ -0,0 +1,187 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "splitting/SortedSampleIndex.h"
+
+namespace grf {
+
+const size_t SortedSampleIndex::DEFAULT_MAX_BYTES;
+
+SortedSampleIndex::SortedSampleIndex(const Data& data,
+                                     SampleSpan samples):
+    data(data),
+    var_index(data.get_num_cols(), data.get_num_cols()),
+    current_node(0),
+    current_samples(samples),
+    position(data.get_num_rows()),
+    goes_left(data.get_num_rows(), false) {
+  const std::set<size_t>& disallowed_split_variables = data.get_disallowed_split_variables();
+  size_t num_split_vars = 0;
+  for (size_t var = 0; var < data.get_num_cols(); var++) {
+    if (disallowed_split_variables.count(var) == 0) {
+      var_index[var] = num_split_vars++;
+    }
+  }
+  sorted_by_var.resize(num_split_vars);
+  reset(samples);
+}
+
+void SortedSampleIndex::reset(SampleSpan samples) {
+  node_begin.assign(1, 0);
+  node_end.assign(1, samples.size());
+  current_node = 0;
+  current_samples = samples;
+  for (size_t var = 0; var < data.get_num_cols(); var++) {
+    if (var_index[var] == data.get_num_cols()) {
+      continue;
+    }
+    std::vector<uint32_t>& sorted_samples = sorted_by_var[var_index[var]];
+    sorted_samples.assign(samples.begin(), samples.end());
+    // Same ordering as Data::get_all_values: NaNs first, ties kept in sample order.
+    std::stable_sort(sorted_samples.begin(), sorted_samples.end(), [&](uint32_t lhs, uint32_t rhs) {
+      double lhs_value = data.get(lhs, var);
+      double rhs_value = data.get(rhs, var);
+      return lhs_value < rhs_value || (std::isnan(lhs_value) && !std::isnan(rhs_value));
+    });
+  }
+}
+
+void SortedSampleIndex::set_node(size_t node,
+                                 SampleSpan samples) {
+  if (node >= node_begin.size() || node_end[node] - node_begin[node] != samples.size()) {
+    throw std::logic_error("The samples passed to SortedSampleIndex::set_node are not those of the node.");
+  }
+  current_node = node;
+  current_samples = samples;
+  for (size_t i = 0; i < samples.size(); i++) {
+    position[samples[i]] = static_cast<uint32_t>(i);
+  }
+}
+
+std::vector<size_t> SortedSampleIndex::get_all_values(std::vector<double>& all_values,
+                                                      std::vector<size_t>& sorted_samples,
+                                                      size_t var) const {
+  std::vector<size_t> index;
+  get_all_values(all_values, sorted_samples, index, var);
+  return index;
+}
+
+void SortedSampleIndex::get_all_values(std::vector<double>& all_values,
+                                       std::vector<size_t>& sorted_samples,
+                                       std::vector<size_t>& index,
+                                       size_t var) const {
+  if (var_index[var] == data.get_num_cols()) {
+    data.get_all_values(all_values, sorted_samples, index, current_samples, var);
+    return;
+  }
+
+  const std::vector<uint32_t>& sorted = sorted_by_var[var_index[var]];
+  size_t begin = node_begin[current_node];
+  size_t size = node_end[current_node] - begin;
+
+  sorted_samples.assign(sorted.begin() + begin, sorted.begin() + begin + size);
+  all_values.resize(size);
+  index.resize(size);
+  for (size_t i = 0; i < size; i++) {
+    size_t sample = sorted_samples[i];
+    all_values[i] = data.get(sample, var);
+    index[i] = position[sample];
+  }
+
+  all_values.erase(std::unique(all_values.begin(), all_values.end(), [&](const double& lhs, const double& rhs) {
+    return lhs == rhs || (std::isnan(lhs) && std::isnan(rhs));
+  }), all_values.end());
+}
+
+void SortedSampleIndex::split_node(size_t node,
+                                   size_t left_child,
+                                   size_t right_child,
+                                   SampleSpan left_samples) {
+  size_t begin = node_begin[node];
+  size_t end = node_end[node];
+  size_t num_nodes = std::max(left_child, right_child) + 1;
+  if (node_begin.size() < num_nodes) {
+    node_begin.resize(num_nodes);
+    node_end.resize(num_nodes);
+  }
+
+  for (auto& sample : left_samples) {
+    goes_left[sample] = true;
+  }
+
+  // Stable partition of each covariate's range: left samples are compacted in place,
+  // right samples are buffered and appended after them.
+  buffer.resize(end - begin - left_samples.size());
+  for (auto& sorted : sorted_by_var) {
+    size_t num_left = begin;
+    size_t num_right = 0;
+    for (size_t i = begin; i < end; i++) {
+      uint32_t sample = sorted[i];
+      if (goes_left[sample]) {
+        sorted[num_left++] = sample;
+      } else {
+        buffer[num_right++] = sample;
+      }
+    }
+    std::copy(buffer.begin(), buffer.end(), sorted.begin() + num_left);
+  }
+
+  for (auto& sample : left_samples) {
+    goes_left[sample] = false;
+  }
+
+  node_begin[left_child] = begin;
+  node_end[left_child] = begin + left_samples.size();
+  node_begin[right_child] = begin + left_samples.size();
+  node_end[right_child] = end;
+}
+
+bool SortedSampleIndex::is_current_node(SampleSpan samples) const {
+  return samples.begin() == current_samples.begin() && samples.size() == current_samples.size();
+}
+
+bool SortedSampleIndex::is_beneficial(const Data& data,
+                                      size_t num_samples,
+                                      uint mtry,
+                                      size_t max_bytes) {
+  // Binned covariates are already sorted in linear time.
+  if (num_samples < 2 || data.get_max_bins() > 0) {
+    return false;
+  }
+  size_t num_split_vars = data.get_num_cols() - data.get_disallowed_split_variables().size();
+  // The sorted orders and partition buffer, plus the per-row positions.
+  double bytes = ((num_split_vars + 1.0) * num_samples + data.get_num_rows()) * sizeof(uint32_t);
+  if (bytes > max_bytes) {
+    return false;
+  }
+  return num_split_vars <= mtry * std::log2(static_cast<double>(num_samples));
+}
+
+size_t SortedSampleIndex::get_max_bytes(const Data& data,
+                                        uint num_threads) {
+  double data_bytes = static_cast<double>(data.get_num_rows()) * data.get_num_cols() * sizeof(double);
+  double bytes_per_thread = data_bytes / std::max<uint>(num_threads, 1);
+  return std::max(DEFAULT_MAX_BYTES, static_cast<size_t>(bytes_per_thread));
+}
+
+} // namespace grf
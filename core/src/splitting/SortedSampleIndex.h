@@ -0,0 +1,148 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_SORTEDSAMPLEINDEX_H
+#define GRF_SORTEDSAMPLEINDEX_H
+
+#include <cstdint>
+#include <vector>
+
+#include "commons/Data.h"
+#include "commons/globals.h"
+
+namespace grf {
+
+/**
+ * A per-tree presorted index of the tree growing samples.
+ *
+ * Every splittable covariate is sorted once at the root, and the sorted order of a
+ * node is carried over to its children through a stable partition. Split search at
+ * a node is then a linear scan over the node's range instead of a fresh sort.
+ *
+ * The root order is sorted with the same (stable, NaN first) comparison as
+ * Data::get_all_values, and the samples of a child node always keep the relative
+ * order they had in the parent. A stable partition of the parent's sorted order
+ * therefore produces exactly the order a stable sort of the child's samples would,
+ * and the splitting rules see bit-identical input with or without this index.
+ *
+ * Sample IDs are stored in 32 bits, as the data has fewer than 2^32 rows (see
+ * ForestTrainer::train).
+ */
+class SortedSampleIndex {
+public:
+  SortedSampleIndex(const Data& data,
+                    SampleSpan samples);
+
+  /**
+   * Sorts the samples of a new tree, reusing the storage of the previous one.
+   */
+  void reset(SampleSpan samples);
+
+  /**
+   * Prepares the index for split search on a node.
+   *
+   * @param node: the node ID in the tree.
+   * @param samples: the samples in this node, in the order used by the tree trainer.
+   * The index only answers for this exact span of samples until the next call.
+   */
+  void set_node(size_t node,
+                SampleSpan samples);
+
+  /**
+   * Same output as Data::get_all_values for the samples of the node last passed
+   * to `set_node`.
+   */
+  std::vector<size_t> get_all_values(std::vector<double>& all_values,
+                                     std::vector<size_t>& sorted_samples,
+                                     size_t var) const;
+
+  void get_all_values(std::vector<double>& all_values,
+                      std::vector<size_t>& sorted_samples,
+                      std::vector<size_t>& index,
+                      size_t var) const;
+
+  /**
+   * Partitions the sorted order of `node` into its two children.
+   *
+   * @param node: the node ID that was split.
+   * @param left_child: the ID of the left child.
+   * @param right_child: the ID of the right child.
+   * @param left_samples: the samples sent to the left child.
+   */
+  void split_node(size_t node,
+                  size_t left_child,
+                  size_t right_child,
+                  SampleSpan left_samples);
+
+  /**
+   * Whether `samples` is the span of the node last passed to `set_node`: the same
+   * samples in the same storage, not merely a node of the same size.
+   */
+  bool is_current_node(SampleSpan samples) const;
+
+  /**
+   * Presorting costs one stable partition per splittable covariate at every split,
+   * while sorting on demand costs roughly mtry * log(n) per sample. Returns true if
+   * the former is expected to be cheaper and the sorted order of every splittable
+   * covariate fits in `max_bytes`.
+   *
+   * Each training thread holds one index, so the budget bounds the extra memory per
+   * thread: without it the index would grow as num_split_vars * num_samples.
+   */
+  static bool is_beneficial(const Data& data,
+                            size_t num_samples,
+                            uint mtry,
+                            size_t max_bytes = DEFAULT_MAX_BYTES);
+
+  /**
+   * The budget of the index of each of `num_threads` training threads: together the
+   * indexes may take as much memory as the data itself (in double precision), and each
+   * may take at least DEFAULT_MAX_BYTES.
+   */
+  static size_t get_max_bytes(const Data& data,
+                              uint num_threads);
+
+  // 256 MB, e.g. 100 covariates of 600,000 samples.
+  static const size_t DEFAULT_MAX_BYTES = 256 * 1024 * 1024;
+
+private:
+  const Data& data;
+
+  // The position of each covariate in `sorted_by_var`, or num_cols if it cannot be split on.
+  std::vector<size_t> var_index;
+  // For each splittable covariate, the samples of all open nodes in sorted order.
+  std::vector<std::vector<uint32_t>> sorted_by_var;
+
+  // The [begin, end) range of each node in `sorted_by_var`.
+  std::vector<size_t> node_begin;
+  std::vector<size_t> node_end;
+
+  size_t current_node;
+  SampleSpan current_samples;
+  // The position of each sample in the samples vector of the current node.
+  std::vector<uint32_t> position;
+  std::vector<bool> goes_left;
+  std::vector<uint32_t> buffer;
+
+  DISALLOW_COPY_AND_ASSIGN(SortedSampleIndex);
+};
+
+} // namespace grf
+
+#endif //GRF_SORTEDSAMPLEINDEX_H
@@ -20,10 +20,15 @@
 #ifndef GRF_SPLITTINGRULE_H
 #define GRF_SPLITTINGRULE_H
 
+#include <stdexcept>
 #include <vector>
 
 #include "Eigen/Dense"
 #include "commons/Data.h"
+#include "commons/NodeSamples.h"
+#include "commons/ResponsesBySample.h"
+#include "splitting/NodeHistograms.h"
+#include "splitting/SortedSampleIndex.h"
 
 namespace grf {
 
@@ -40,7 +45,7 @@ public:
    * @param node: the node id in the tree.
    * @param possible_split_vars: a vector of valid covariate IDs.
    * @param responses_by_sample: the response for each sample.
-   * @param samples: a vector of samples at the given node.
+   * @param samples: the samples of every node in the tree.
    * @param split_vars: the output of the method, the best split variable, stored at node.
    * @param split_values: the output of the method, the best split value, stored at node.
    * @return a boolean that will be true if no best split was found.
@@ -49,11 +54,79 @@ public:
   virtual bool find_best_split(const Data& data,
                                size_t node,
                                const std::vector<size_t>& possible_split_vars,
-                               const Eigen::ArrayXXd& responses_by_sample,
-                               const std::vector<std::vector<size_t>>& samples,
+                               const ResponsesBySample& responses_by_sample,
+                               const NodeSamples& samples,
                                std::vector<size_t>& split_vars,
                                std::vector<double>& split_values,
                                std::vector<bool>& send_missing_left) = 0;
+
+  /**
+   * Optionally sets a presorted index of the tree growing samples. If set, it has to
+   * be positioned on the node passed to `find_best_split`, and the sorted samples
+   * of a node are read from it instead of being sorted for every split variable.
+   * Asking for the sorted values of any other samples is an error.
+   */
+  void set_sorted_sample_index(const SortedSampleIndex* sorted_sample_index) {
+    this->sorted_sample_index = sorted_sample_index;
+  }
+
+  /**
+   * Optionally sets per-bin statistics of the node samples, for binned data. If set, the
+   * splitting rule fills in the statistics of the samples passed to `find_best_split`
+   * and reads the statistics of each bin from the histograms instead of sorting samples.
+   */
+  void set_node_histograms(NodeHistograms* node_histograms) {
+    this->node_histograms = node_histograms;
+  }
+
+  /**
+   * The number of statistics per sample if the splitting rule can split on node
+   * histograms, and 0 otherwise. The first statistic is the sample count.
+   */
+  virtual size_t get_num_histogram_stats() const { return 0; }
+
+  /**
+   * Appends the addresses of the split search buffers to `buffers`.
+   */
+  void get_buffers(std::vector<const void*>& buffers) const {
+    buffers.push_back(possible_split_values.data());
+    buffers.push_back(sorted_samples.data());
+    buffers.push_back(index.data());
+    buffers.push_back(bins.data());
+  }
+
+protected:
+  /**
+   * Sorts and gets the unique values in `samples` at variable `var`,
+   * see Data::get_all_values.
+   */
+  void get_all_values(const Data& data,
+                      std::vector<double>& all_values,
+                      std::vector<size_t>& sorted_samples,
+                      std::vector<size_t>& index,
+                      SampleSpan samples,
+                      size_t var) const {
+    if (sorted_sample_index != nullptr) {
+      if (!sorted_sample_index->is_current_node(samples)) {
+        throw std::logic_error("The presorted sample index is not positioned on the node being split.");
+      }
+      sorted_sample_index->get_all_values(all_values, sorted_samples, index, var);
+      return;
+    }
+    data.get_all_values(all_values, sorted_samples, index, samples, var);
+  }
+
+  // Split search buffers, refilled for every split variable. The splitting rule lives as
+  // long as the tree training workspace, so they are only allocated for the first trees.
+  std::vector<double> possible_split_values;
+  std::vector<size_t> sorted_samples;
+  std::vector<size_t> index;
+  std::vector<size_t> bins;
+
+  NodeHistograms* node_histograms = nullptr;
+
+private:
+  const SortedSampleIndex* sorted_sample_index = nullptr;
 };
 
 } // namespace grf
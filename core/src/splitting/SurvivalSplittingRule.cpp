@@ -30,12 +30,12 @@ SurvivalSplittingRule::SurvivalSplittingRule(size_t num_data_rows, double alpha)
 bool SurvivalSplittingRule::find_best_split(const Data& data,
                                             size_t node,
                                             const std::vector<size_t>& possible_split_vars,
-                                            const Eigen::ArrayXXd& responses_by_sample,
-                                            const std::vector<std::vector<size_t>>& samples_by_node,
+                                            const ResponsesBySample& responses_by_sample,
+                                            const NodeSamples& samples_by_node,
                                             std::vector<size_t>& split_vars,
                                             std::vector<double>& split_values,
                                             std::vector<bool>& send_missing_left) {
-  const std::vector<size_t>& samples = samples_by_node[node];
+  SampleSpan samples = samples_by_node[node];
 
   // The splitting rule output
   double best_value = 0;
@@ -60,8 +60,8 @@ bool SurvivalSplittingRule::find_best_split(const Data& data,
 
 void SurvivalSplittingRule::find_best_split_internal(const Data& data,
                                                      const std::vector<size_t>& possible_split_vars,
-                                                     const Eigen::ArrayXXd& responses_by_sample,
-                                                     const std::vector<size_t>& samples,
+                                                     const ResponsesBySample& responses_by_sample,
+                                                     SampleSpan samples,
                                                      double& best_value,
                                                      size_t& best_var,
                                                      bool& best_send_missing_left,
@@ -70,7 +70,7 @@ void SurvivalSplittingRule::find_best_split_internal(const Data& data,
   size_t min_child_size = std::max<size_t>(static_cast<size_t>(std::ceil(size_node * alpha)), 1uL);
 
   // Get the failure values t1, ..., tm in this node
-  std::vector<double> failure_values;
+  failure_values.clear();
   for (auto& sample : samples) {
     if (data.is_failure(sample)) {
       failure_values.push_back(responses_by_sample(sample, 0));
@@ -90,17 +90,17 @@ void SurvivalSplittingRule::find_best_split_internal(const Data& data,
 
   // The number of failures at each time in the parent node. Entry 0 will be zero.
   // (Entry 0 is for time k < t1)
-  std::vector<double> count_failure(num_failures + 1);
+  count_failure.assign(num_failures + 1, 0);
   // The number of censored observations at each time in the parent node.
-  std::vector<double> count_censor(num_failures + 1);
+  count_censor.assign(num_failures + 1, 0);
   // The number of samples in the parent node at risk at each time point, i.e. the count of observations
   // with observed time greater than or equal to the given failure time. Entry 0 will be equal to the number
   // of samples (and the entries will always be monotonically decreasing)
-  std::vector<double> at_risk(num_failures + 1);
+  at_risk.assign(num_failures + 1, 0);
   at_risk[0] = static_cast<double>(size_node);
 
-  std::vector<double> numerator_weights(num_failures + 1);
-  std::vector<double> denominator_weights(num_failures + 1);
+  numerator_weights.assign(num_failures + 1, 0);
+  denominator_weights.assign(num_failures + 1, 0);
 
   // Relabel the failure values to range from 0 to the number of failures in this node
   for (auto& sample : samples) {
@@ -132,8 +132,7 @@ void SurvivalSplittingRule::find_best_split_internal(const Data& data,
 
   for (auto& var : possible_split_vars) {
     find_best_split_value(data, var, size_node, min_child_size, num_failures_node, num_failures,
-                          best_value, best_var, best_logrank, best_send_missing_left, samples,
-                          count_failure, at_risk, numerator_weights, denominator_weights);
+                          best_value, best_var, best_logrank, best_send_missing_left, samples);
   }
 }
 
@@ -147,34 +146,28 @@ void SurvivalSplittingRule::find_best_split_value(const Data& data,
                                                   size_t& best_var,
                                                   double& best_logrank,
                                                   bool& best_send_missing_left,
-                                                  const std::vector<size_t>& samples,
-                                                  const std::vector<double>& count_failure,
-                                                  const std::vector<double>& at_risk,
-                                                  const std::vector<double>& numerator_weights,
-                                                  const std::vector<double>& denominator_weights) {
+                                                  SampleSpan samples) {
   // possible_split_values contains all the unique split values for this variable in increasing order
   // sorted_samples contains the samples in this node in increasing order
   // if there are missing values, these are placed first
   // (if all Xij's are continuous, these two vectors have the same length)
-  std::vector<double> possible_split_values;
-  std::vector<size_t> sorted_samples;
-  data.get_all_values(possible_split_values, sorted_samples, samples, var);
+  get_all_values(data, possible_split_values, sorted_samples, index, samples, var);
 
   // Try next variable if all equal for this
   if (possible_split_values.size() < 2) {
     return;
   }
 
-  std::vector<double> left_count_failure(num_failures + 1);
-  std::vector<double> left_count_censor(num_failures + 1);
-  std::vector<double> cum_sums(num_failures + 1);
+  left_count_failure.assign(num_failures + 1, 0);
+  left_count_censor.assign(num_failures + 1, 0);
+  cum_sums.assign(num_failures + 1, 0);
   size_t n_missing = 0;
   size_t num_failures_missing = 0;
 
   // Loop through all samples to scan for missing values
   for (size_t i = 0; i < size_node - 1; i++) {
     size_t sample = sorted_samples[i];
-    double sample_value = data.get(sample, var);
+    double sample_value = data.get_bin_value(sample, var);
     size_t sample_time = relabeled_failures[sample];
 
     if (std::isnan(sample_value)) {
@@ -213,8 +206,8 @@ void SurvivalSplittingRule::find_best_split_value(const Data& data,
     for (size_t i = start_sample; i < size_node - 1; i++) {
       size_t sample = sorted_samples[i];
       size_t next_sample = sorted_samples[i + 1];
-      double sample_value = data.get(sample, var);
-      double next_sample_value = data.get(next_sample, var);
+      double sample_value = data.get_bin_value(sample, var);
+      double next_sample_value = data.get_bin_value(next_sample, var);
       size_t sample_time = relabeled_failures[sample];
 
       // If there are missing values, we evaluate splitting on NaN when send_left is true
@@ -35,8 +35,8 @@ public:
   bool find_best_split(const Data& data,
                        size_t node,
                        const std::vector<size_t>& possible_split_vars,
-                       const Eigen::ArrayXXd& responses_by_sample,
-                       const std::vector<std::vector<size_t>>& samples_by_node,
+                       const ResponsesBySample& responses_by_sample,
+                       const NodeSamples& samples_by_node,
                        std::vector<size_t>& split_vars,
                        std::vector<double>& split_values,
                        std::vector<bool>& send_missing_left);
@@ -47,8 +47,8 @@ public:
   */
  void find_best_split_internal(const Data& data,
                                const std::vector<size_t>& possible_split_vars,
-                               const Eigen::ArrayXXd& responses_by_sample,
-                               const std::vector<size_t>& samples,
+                               const ResponsesBySample& responses_by_sample,
+                               SampleSpan samples,
                                double& best_value,
                                size_t& best_var,
                                bool& best_send_missing_left,
@@ -65,11 +65,7 @@ private:
                              size_t& best_var,
                              double& best_logrank,
                              bool& best_send_missing_left,
-                             const std::vector<size_t>& samples,
-                             const std::vector<double>& count_failure,
-                             const std::vector<double>& at_risk,
-                             const std::vector<double>& numerator_weights,
-                             const std::vector<double>& denominator_weights);
+                             SampleSpan samples);
 
   inline double compute_logrank(size_t num_failures,
                                 size_t n_left,
@@ -83,6 +79,17 @@ private:
   std::vector<size_t> relabeled_failures;
   double alpha;
 
+  // Per node and per split variable buffers, indexed by the relabeled failure times.
+  std::vector<double> failure_values;
+  std::vector<double> count_failure;
+  std::vector<double> count_censor;
+  std::vector<double> at_risk;
+  std::vector<double> numerator_weights;
+  std::vector<double> denominator_weights;
+  std::vector<double> left_count_failure;
+  std::vector<double> left_count_censor;
+  std::vector<double> cum_sums;
+
   DISALLOW_COPY_AND_ASSIGN(SurvivalSplittingRule);
 };
 
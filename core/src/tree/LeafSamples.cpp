@@ -0,0 +1,96 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <stdexcept>
+
+#include "LeafSamples.h"
+
+namespace grf {
+
+LeafSamples::LeafSamples() :
+    node_offsets(1, 0) {}
+
+LeafSamples::LeafSamples(const std::vector<std::vector<size_t>>& samples_by_node) :
+    node_offsets(1, 0) {
+  size_t num_samples = 0;
+  for (auto& node_samples : samples_by_node) {
+    num_samples += node_samples.size();
+    for (size_t sample : node_samples) {
+      if (sample > UINT32_MAX) {
+        throw std::runtime_error("The number of samples must be less than 2^32.");
+      }
+    }
+  }
+  if (num_samples > UINT32_MAX) {
+    throw std::runtime_error("The number of samples must be less than 2^32.");
+  }
+  samples.reserve(num_samples);
+  node_offsets.reserve(samples_by_node.size() + 1);
+  for (auto& node_samples : samples_by_node) {
+    samples.insert(samples.end(), node_samples.begin(), node_samples.end());
+    node_offsets.push_back(static_cast<uint32_t>(samples.size()));
+  }
+}
+
+LeafSamples::LeafSamples(std::initializer_list<std::vector<size_t>> samples_by_node) :
+    LeafSamples(std::vector<std::vector<size_t>>(samples_by_node)) {}
+
+LeafSamples::LeafSamples(const NodeSamples& node_samples) :
+    node_offsets(1, 0) {
+  size_t num_samples = 0;
+  for (size_t node = 0; node < node_samples.size(); node++) {
+    num_samples += node_samples[node].size();
+  }
+  samples.reserve(num_samples);
+  node_offsets.reserve(node_samples.size() + 1);
+  for (size_t node = 0; node < node_samples.size(); node++) {
+    SampleSpan span = node_samples[node];
+    samples.insert(samples.end(), span.begin(), span.end());
+    node_offsets.push_back(static_cast<uint32_t>(samples.size()));
+  }
+}
+
+LeafSamples::LeafSamples(size_t num_nodes,
+                         const std::vector<size_t>& samples,
+                         const std::vector<size_t>& leaf_nodes) :
+    samples(samples.size()),
+    node_offsets(num_nodes + 1, 0) {
+  // Count the samples of each node, then place every sample after the ones before it.
+  for (size_t sample : samples) {
+    node_offsets[leaf_nodes[sample] + 1]++;
+  }
+  for (size_t node = 0; node < num_nodes; node++) {
+    node_offsets[node + 1] += node_offsets[node];
+  }
+  std::vector<uint32_t> next_position(node_offsets.begin(), node_offsets.end() - 1);
+  for (size_t sample : samples) {
+    this->samples[next_position[leaf_nodes[sample]]++] = static_cast<uint32_t>(sample);
+  }
+}
+
+std::vector<std::vector<size_t>> LeafSamples::get_samples_by_node() const {
+  std::vector<std::vector<size_t>> samples_by_node(size());
+  for (size_t node = 0; node < size(); node++) {
+    LeafSampleSpan node_samples = (*this)[node];
+    samples_by_node[node].assign(node_samples.begin(), node_samples.end());
+  }
+  return samples_by_node;
+}
+
+} // namespace grf
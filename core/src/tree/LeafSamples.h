@@ -0,0 +1,94 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_LEAFSAMPLES_H_
+#define GRF_LEAFSAMPLES_H_
+
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+#include "commons/globals.h"
+#include "commons/NodeSamples.h"
+
+namespace grf {
+
+/**
+ * The samples of every node of a trained tree, stored in compressed sparse row form:
+ * the samples of all nodes in one array, in order of node ID, and for every node the
+ * offset of its first sample. Internal nodes take no space beyond their offset, and
+ * the samples of a leaf are read sequentially through a LeafSampleSpan.
+ *
+ * Sample IDs and offsets are stored in 32 bits, which halves the memory of a forest's
+ * samples. Forests are trained on fewer than 2^32 samples (see ForestTrainer::train).
+ */
+class LeafSamples {
+public:
+  LeafSamples();
+
+  /**
+   * The samples of every node given as one vector per node, for example when a tree is
+   * deserialized. Throws if the samples do not fit in 32 bits.
+   */
+  LeafSamples(const std::vector<std::vector<size_t>>& samples_by_node);
+
+  LeafSamples(std::initializer_list<std::vector<size_t>> samples_by_node);
+
+  /**
+   * The samples of every node of a tree being grown.
+   */
+  LeafSamples(const NodeSamples& node_samples);
+
+  /**
+   * Groups `samples` by their leaf in a tree with `num_nodes` nodes, where the leaf of
+   * sample s is leaf_nodes[s]. The samples of each node keep their order in `samples`.
+   */
+  LeafSamples(size_t num_nodes,
+              const std::vector<size_t>& samples,
+              const std::vector<size_t>& leaf_nodes);
+
+  LeafSampleSpan operator[](size_t node) const;
+
+  /**
+   * The number of nodes.
+   */
+  size_t size() const;
+
+  /**
+   * The samples of every node as one vector per node.
+   */
+  std::vector<std::vector<size_t>> get_samples_by_node() const;
+
+private:
+  std::vector<uint32_t> samples;
+  // The samples of node n are samples[node_offsets[n]], ..., samples[node_offsets[n + 1] - 1].
+  std::vector<uint32_t> node_offsets;
+};
+
+inline LeafSampleSpan LeafSamples::operator[](size_t node) const {
+  return LeafSampleSpan(samples.data() + node_offsets[node], samples.data() + node_offsets[node + 1]);
+}
+
+inline size_t LeafSamples::size() const {
+  return node_offsets.size() - 1;
+}
+
+} // namespace grf
+
+#endif /* GRF_LEAFSAMPLES_H_ */
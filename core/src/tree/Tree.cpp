@@ -17,6 +17,8 @@
   along with grf. If not, see <http://www.gnu.org/licenses/>.
  #-------------------------------------------------------------------------------*/
 
+#include <algorithm>
+#include <cmath>
 #include <iterator>
 #include "sampling/RandomSampler.h"
 
@@ -27,7 +29,7 @@ namespace grf {
 
 Tree::Tree(size_t root_node,
            const std::vector<std::vector<size_t>>& child_nodes,
-           const std::vector<std::vector<size_t>>& leaf_samples,
+           const LeafSamples& leaf_samples,
            const std::vector<size_t>& split_vars,
            const std::vector<double>& split_values,
            const std::vector<size_t>& drawn_samples,
@@ -40,7 +42,13 @@ Tree::Tree(size_t root_node,
     split_values(split_values),
     drawn_samples(drawn_samples),
     send_missing_left(send_missing_left),
-    prediction_values(prediction_values) {}
+    prediction_values(prediction_values) {
+  // Keep the drawn samples sorted so that the ones in a range of sample IDs can be found quickly.
+  if (!std::is_sorted(this->drawn_samples.begin(), this->drawn_samples.end())) {
+    std::sort(this->drawn_samples.begin(), this->drawn_samples.end());
+  }
+  flatten();
+}
 
 size_t Tree::get_root_node() const {
   return root_node;
@@ -50,7 +58,7 @@ const std::vector<std::vector<size_t>>& Tree::get_child_nodes() const {
   return child_nodes;
 }
 
-const std::vector<std::vector<size_t>>& Tree::get_leaf_samples() const {
+const LeafSamples& Tree::get_leaf_samples() const {
   return leaf_samples;
 }
 
@@ -74,11 +82,23 @@ const PredictionValues& Tree::get_prediction_values() const  {
   return prediction_values;
 }
 
+const SparsePredictionValues& Tree::get_sparse_prediction_values() const  {
+  return sparse_prediction_values;
+}
+
 std::vector<size_t> Tree::find_leaf_nodes(const Data& data,
                                           const std::vector<size_t>& samples) const  {
   std::vector<size_t> prediction_leaf_nodes;
   prediction_leaf_nodes.resize(data.get_num_rows());
 
+  if (!flat_nodes.empty()) {
+    for (size_t start = 0; start < samples.size(); start += SAMPLE_BLOCK_SIZE) {
+      size_t num_samples = samples.size() - start < SAMPLE_BLOCK_SIZE ? samples.size() - start : SAMPLE_BLOCK_SIZE;
+      find_flat_leaf_nodes(data, samples.data() + start, num_samples, 0, prediction_leaf_nodes.data());
+    }
+    return prediction_leaf_nodes;
+  }
+
   for (size_t sample : samples) {
     size_t node = find_leaf_node(data, sample);
     prediction_leaf_nodes[sample] = node;
@@ -88,23 +108,67 @@ std::vector<size_t> Tree::find_leaf_nodes(const Data& data,
 
 std::vector<size_t> Tree::find_leaf_nodes(const Data& data,
                                           const std::vector<bool>& valid_samples) const  {
-  size_t num_samples = data.get_num_rows();
+  return find_leaf_nodes(data, 0, valid_samples);
+}
+
+std::vector<size_t> Tree::find_leaf_nodes(const Data& data,
+                                          size_t start,
+                                          const std::vector<bool>& valid_samples) const {
+  size_t num_samples = valid_samples.size();
 
   std::vector<size_t> prediction_leaf_nodes;
   prediction_leaf_nodes.resize(num_samples);
 
-  for (size_t sample = 0; sample < num_samples; sample++) {
-    if (!valid_samples[sample]) {
+  if (!flat_nodes.empty()) {
+    size_t block[SAMPLE_BLOCK_SIZE];
+    size_t block_size = 0;
+    for (size_t i = 0; i < num_samples; i++) {
+      if (!valid_samples[i]) {
+        continue;
+      }
+      block[block_size++] = start + i;
+      if (block_size == SAMPLE_BLOCK_SIZE) {
+        find_flat_leaf_nodes(data, block, block_size, start, prediction_leaf_nodes.data());
+        block_size = 0;
+      }
+    }
+    find_flat_leaf_nodes(data, block, block_size, start, prediction_leaf_nodes.data());
+    return prediction_leaf_nodes;
+  }
+
+  for (size_t i = 0; i < num_samples; i++) {
+    if (!valid_samples[i]) {
       continue;
     }
 
-    size_t node = find_leaf_node(data, sample);
-    prediction_leaf_nodes[sample] = node;
+    size_t node = find_leaf_node(data, start + i);
+    prediction_leaf_nodes[i] = node;
   }
   return prediction_leaf_nodes;
 }
 
-void Tree::set_leaf_samples(const std::vector<std::vector<size_t>>& leaf_samples) {
+void Tree::find_leaf_nodes(const Data& data,
+                           size_t start,
+                           size_t num_samples,
+                           size_t* leaf_nodes) const {
+  if (!flat_nodes.empty()) {
+    size_t block[SAMPLE_BLOCK_SIZE];
+    for (size_t block_start = 0; block_start < num_samples; block_start += SAMPLE_BLOCK_SIZE) {
+      size_t block_size = num_samples - block_start < SAMPLE_BLOCK_SIZE ? num_samples - block_start : SAMPLE_BLOCK_SIZE;
+      for (size_t i = 0; i < block_size; i++) {
+        block[i] = start + block_start + i;
+      }
+      find_flat_leaf_nodes(data, block, block_size, start, leaf_nodes);
+    }
+    return;
+  }
+
+  for (size_t i = 0; i < num_samples; i++) {
+    leaf_nodes[i] = find_leaf_node(data, start + i);
+  }
+}
+
+void Tree::set_leaf_samples(const LeafSamples& leaf_samples) {
   this->leaf_samples = leaf_samples;
 }
 
@@ -112,6 +176,10 @@ void Tree::set_prediction_values(const PredictionValues& prediction_values) {
   this->prediction_values = prediction_values;
 }
 
+void Tree::set_sparse_prediction_values(const SparsePredictionValues& sparse_prediction_values) {
+  this->sparse_prediction_values = sparse_prediction_values;
+}
+
 
 size_t Tree::find_leaf_node(const Data& data,
                             size_t sample) const  {
@@ -142,6 +210,75 @@ size_t Tree::find_leaf_node(const Data& data,
   return node;
 };
 
+void Tree::find_flat_leaf_nodes(const Data& data,
+                                const size_t* samples,
+                                size_t num_samples,
+                                size_t offset,
+                                size_t* leaf_nodes) const {
+  const FlatNode* nodes = flat_nodes.data();
+  uint32_t position[SAMPLE_BLOCK_SIZE] = {0};
+  // A tree with a single leaf has no split variable to read.
+  bool any_split = (nodes[0].split_var & LEAF_FLAG) == 0;
+  while (any_split) {
+    uint32_t num_split = 0;
+    for (size_t i = 0; i < num_samples; i++) {
+      // A sample in a leaf reads the root's split variable and stays where it is. The conditions are
+      // combined with bitwise operators so that the compiler emits no branches.
+      const FlatNode& node = nodes[position[i]];
+      uint32_t is_split = (node.split_var & LEAF_FLAG) == 0;
+      uint32_t send_missing_left = (node.split_var & SEND_MISSING_LEFT_FLAG) != 0;
+      double value = data.get(samples[i], node.split_var & SPLIT_VAR_MASK);
+      uint32_t go_left = static_cast<uint32_t>(value <= node.split_value)
+          | (static_cast<uint32_t>(std::isnan(value)) & send_missing_left);
+      uint32_t next_position = node.child + (go_left ^ 1u);
+      position[i] = is_split ? next_position : position[i];
+      num_split += is_split;
+    }
+    any_split = num_split > 0;
+  }
+
+  for (size_t i = 0; i < num_samples; i++) {
+    leaf_nodes[samples[i] - offset] = nodes[position[i]].child;
+  }
+}
+
+void Tree::flatten() {
+  flat_nodes.clear();
+  size_t num_nodes = child_nodes.empty() ? 0 : child_nodes[0].size();
+  if (root_node >= num_nodes || num_nodes > UINT32_MAX) {
+    return;
+  }
+
+  // Nodes are appended in breadth first order, so the children of the node at position i
+  // are appended after all nodes up to i were visited.
+  std::vector<size_t> node_ids(1, root_node);
+  for (size_t i = 0; i < node_ids.size(); i++) {
+    size_t node = node_ids[i];
+    FlatNode flat_node;
+    if (is_leaf(node)) {
+      // Leaves keep the root's split variable, which is a covariate, since the traversal
+      // still reads a value for samples that have reached a leaf, and this keeps that read
+      // in the single precision copy of the covariates (see Data::set_single_precision).
+      flat_node.split_value = 0;
+      flat_node.split_var = LEAF_FLAG | (i == 0 ? 0 : flat_nodes[0].split_var & SPLIT_VAR_MASK);
+      flat_node.child = static_cast<uint32_t>(node);
+    } else {
+      if (split_vars[node] > SPLIT_VAR_MASK) {
+        flat_nodes.clear();
+        return;
+      }
+      // A NaN split value sends the missing values left, see TreeTrainer::split_node.
+      bool missing_left = send_missing_left[node] || std::isnan(split_values[node]);
+      flat_node.split_value = split_values[node];
+      flat_node.split_var = static_cast<uint32_t>(split_vars[node]) | (missing_left ? SEND_MISSING_LEFT_FLAG : 0);
+      flat_node.child = static_cast<uint32_t>(node_ids.size());
+      node_ids.push_back(child_nodes[0][node]);
+      node_ids.push_back(child_nodes[1][node]);
+    }
+    flat_nodes.push_back(flat_node);
+  }
+}
+
 void Tree::honesty_prune_leaves() {
   size_t num_nodes = leaf_samples.size();
   for (size_t n = num_nodes; n > root_node; n--) {
@@ -161,6 +298,7 @@ void Tree::honesty_prune_leaves() {
     }
   }
   prune_node(root_node);
+  flatten();
 }
 
 void Tree::prune_node(size_t& node) {
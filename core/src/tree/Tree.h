@@ -20,13 +20,16 @@
 #ifndef GRF_TREE_H_
 #define GRF_TREE_H_
 
+#include <cstdint>
 #include <vector>
 
 #include "commons/globals.h"
 #include "commons/Data.h"
 #include "sampling/RandomSampler.h"
 #include "prediction/PredictionValues.h"
+#include "prediction/SparsePredictionValues.h"
 #include "splitting/SplittingRule.h"
+#include "tree/LeafSamples.h"
 
 namespace grf {
 
@@ -34,7 +37,7 @@ class Tree {
 public:
   Tree(size_t root_node,
        const std::vector<std::vector<size_t>>& child_nodes,
-       const std::vector<std::vector<size_t>>& leaf_samples,
+       const LeafSamples& leaf_samples,
        const std::vector<size_t>& split_vars,
        const std::vector<double>& split_values,
        const std::vector<size_t>& drawn_samples,
@@ -68,6 +71,23 @@ public:
    */
   std::vector<size_t> find_leaf_nodes(const Data& data,
                                       const std::vector<bool>& valid_samples) const;
+
+  /**
+   * Same as above, for the block of samples start, ..., start + valid_samples.size() - 1
+   * only. Both `valid_samples` and the result are indexed by sample ID - start.
+   */
+  std::vector<size_t> find_leaf_nodes(const Data& data,
+                                      size_t start,
+                                      const std::vector<bool>& valid_samples) const;
+
+  /**
+   * Finds the leaf nodes of all samples start, ..., start + num_samples - 1 without
+   * allocating, and writes the node of sample start + i to leaf_nodes[i].
+   */
+  void find_leaf_nodes(const Data& data,
+                       size_t start,
+                       size_t num_samples,
+                       size_t* leaf_nodes) const;
   /**
    * Removes all empty leaf nodes.
    *
@@ -92,9 +112,9 @@ public:
 
   /**
    * Specifies the samples that each node contains. Note that only leaf nodes will contain
-   * a non-empty vector of sample IDs.
+   * a non-empty span of sample IDs.
    */
-  const std::vector<std::vector<size_t>>& get_leaf_samples() const;
+  const LeafSamples& get_leaf_samples() const;
 
   /**
    * For each split, the ID of the variable that was chosen to split on.
@@ -109,7 +129,8 @@ public:
   /**
    * The sample IDs that were not drawn in creating this tree. For honest trees,
    * this excludes both samples that went into growing the tree, as well as samples
-   * used to repopulate the leaves.
+   * used to repopulate the leaves. They are sorted in increasing order, so that the
+   * drawn samples in a range of IDs can be found by binary search.
    */
   const std::vector<size_t>& get_drawn_samples() const;
 
@@ -126,6 +147,13 @@ public:
    */
   const PredictionValues& get_prediction_values() const;
 
+  /**
+   * Optional summary values of varying length about the samples in each leaf. Like the
+   * prediction values, these are only non-empty if the tree was trained with an
+   * optimized prediction strategy, one whose leaf summaries are sparse.
+   */
+  const SparsePredictionValues& get_sparse_prediction_values() const;
+
   /**
    * Given a node ID, returns true if the node represents a leaf in this tree (in
    * particular, the node has no children).
@@ -136,7 +164,7 @@ public:
    * Sets the contents of this tree's leaf nodes. Please see
    * Tree::get_leaf_samples for a description of this variable.
    */
-  void set_leaf_samples(const std::vector<std::vector<size_t>>& leaf_samples);
+  void set_leaf_samples(const LeafSamples& leaf_samples);
 
   /**
    * Sets the contents of this tree's prediction values. Please see
@@ -144,21 +172,70 @@ public:
    */
   void set_prediction_values(const PredictionValues& prediction_values);
 
+  /**
+   * Sets the contents of this tree's sparse prediction values. Please see
+   * Tree::get_sparse_prediction_values for a description of this variable.
+   */
+  void set_sparse_prediction_values(const SparsePredictionValues& sparse_prediction_values);
+
 private:
+  /**
+   * A node of the compact form of the tree used to find leaves. The nodes reachable from
+   * the root are laid out breadth first with both children of a split next to each other,
+   * so that a lookup reads a single 16 byte node per level.
+   */
+  struct FlatNode {
+    double split_value;
+    // The split variable, with the flags below in the upper bits. Leaves hold the split
+    // variable of the root.
+    uint32_t split_var;
+    // For a split, the position of the left child (the right child follows it). For a
+    // leaf, its node ID in this tree.
+    uint32_t child;
+  };
+
+  static const uint32_t LEAF_FLAG = 1u << 31;
+  static const uint32_t SEND_MISSING_LEFT_FLAG = 1u << 30;
+  static const uint32_t SPLIT_VAR_MASK = SEND_MISSING_LEFT_FLAG - 1;
+  // The number of samples moved down the flattened tree together.
+  static const size_t SAMPLE_BLOCK_SIZE = 8;
+
   size_t find_leaf_node(const Data& data,
                         size_t sample) const;
+  /**
+   * Finds the leaves of up to SAMPLE_BLOCK_SIZE samples in the flattened tree, and writes
+   * them to `leaf_nodes` at sample ID - offset. All samples take one step per level, with
+   * branch free updates, so that the loads of one sample overlap with those of the others
+   * instead of waiting on a mispredicted branch.
+   */
+  void find_flat_leaf_nodes(const Data& data,
+                            const size_t* samples,
+                            size_t num_samples,
+                            size_t offset,
+                            size_t* leaf_nodes) const;
   void prune_node(size_t& node);
   bool is_empty_leaf(size_t node) const;
 
+  /**
+   * Builds `flat_nodes` from the node vectors. Must be called whenever the structure
+   * of the tree changes.
+   */
+  void flatten();
+
   size_t root_node;
   std::vector<std::vector<size_t>> child_nodes;
-  std::vector<std::vector<size_t>> leaf_samples;
+  LeafSamples leaf_samples;
   std::vector<size_t> split_vars;
   std::vector<double> split_values;
   std::vector<size_t> drawn_samples;
   std::vector<bool> send_missing_left;
 
+  // Empty if the tree is too large to be flattened, in which case leaves are found
+  // from the node vectors above.
+  std::vector<FlatNode> flat_nodes;
+
   PredictionValues prediction_values;
+  SparsePredictionValues sparse_prediction_values;
 };
 
 } // namespace grf
@@ -36,36 +36,92 @@ std::unique_ptr<Tree> TreeTrainer::train(const Data& data,
                                          RandomSampler& sampler,
                                          const std::vector<size_t>& clusters,
                                          const TreeOptions& options) const {
-  std::vector<std::vector<size_t>> child_nodes;
-  std::vector<std::vector<size_t>> nodes;
-  std::vector<size_t> split_vars;
-  std::vector<double> split_values;
-  std::vector<bool> send_missing_left;
-
-  child_nodes.emplace_back();
-  child_nodes.emplace_back();
+  TreeTrainingWorkspace workspace;
+  return train(data, sampler, clusters, options, workspace);
+}
+
+std::unique_ptr<Tree> TreeTrainer::train(const Data& data,
+                                         RandomSampler& sampler,
+                                         const std::vector<size_t>& clusters,
+                                         const TreeOptions& options,
+                                         TreeTrainingWorkspace& workspace) const {
+  std::vector<std::vector<size_t>>& child_nodes = workspace.child_nodes;
+  NodeSamples& nodes = workspace.nodes;
+  std::vector<size_t>& split_vars = workspace.split_vars;
+  std::vector<double>& split_values = workspace.split_values;
+  std::vector<bool>& send_missing_left = workspace.send_missing_left;
+
+  child_nodes.resize(2);
+  child_nodes[0].clear();
+  child_nodes[1].clear();
+  split_vars.clear();
+  split_values.clear();
+  send_missing_left.clear();
   create_empty_node(child_nodes, nodes, split_vars, split_values, send_missing_left);
 
-  std::vector<size_t> new_leaf_samples;
+  std::vector<size_t>& root_samples = workspace.root_samples;
+  std::vector<size_t>& new_leaf_samples = workspace.new_leaf_samples;
+  root_samples.clear();
+  new_leaf_samples.clear();
 
   if (options.get_honesty()) {
-    std::vector<size_t> tree_growing_clusters;
-    std::vector<size_t> new_leaf_clusters;
+    std::vector<size_t>& tree_growing_clusters = workspace.tree_growing_clusters;
+    std::vector<size_t>& new_leaf_clusters = workspace.new_leaf_clusters;
     sampler.subsample(clusters, options.get_honesty_fraction(), tree_growing_clusters, new_leaf_clusters);
 
-    sampler.sample_from_clusters(tree_growing_clusters, nodes[0]);
+    sampler.sample_from_clusters(tree_growing_clusters, root_samples);
     sampler.sample_from_clusters(new_leaf_clusters, new_leaf_samples);
   } else {
-    sampler.sample_from_clusters(clusters, nodes[0]);
+    sampler.sample_from_clusters(clusters, root_samples);
+  }
+  nodes.set_root_samples(root_samples);
+
+  // root_samples.size() is the number of samples subsampled for this tree. The rule of
+  // a previous tree can be reused as long as its buffers are large enough.
+  std::unique_ptr<SplittingRule>& splitting_rule = workspace.splitting_rule;
+  if (splitting_rule == nullptr || workspace.splitting_rule_capacity < root_samples.size()) {
+    splitting_rule = splitting_rule_factory->create(root_samples.size(), data, options);
+    workspace.splitting_rule_capacity = root_samples.size();
+  }
+
+  // Presort the tree growing samples once if it is cheaper than sorting them at every split.
+  SortedSampleIndex* sorted_sample_index = nullptr;
+  if (SortedSampleIndex::is_beneficial(data, root_samples.size(), options.get_mtry(),
+                                       workspace.sorted_sample_index_max_bytes)) {
+    if (workspace.sorted_sample_index == nullptr) {
+      workspace.sorted_sample_index.reset(new SortedSampleIndex(data, root_samples));
+    } else {
+      workspace.sorted_sample_index->reset(root_samples);
+    }
+    sorted_sample_index = workspace.sorted_sample_index.get();
+  }
+  splitting_rule->set_sorted_sample_index(sorted_sample_index);
+
+  // With binned covariates and responses that are the same in every node, the per-bin
+  // statistics of a child can be derived from its parent and sibling.
+  NodeHistograms* node_histograms = nullptr;
+  if (data.get_max_bins() > 0
+      && relabeling_strategy->is_node_invariant()
+      && splitting_rule->get_num_histogram_stats() > 0) {
+    if (workspace.node_histograms == nullptr) {
+      workspace.node_histograms.reset(new NodeHistograms(data, splitting_rule->get_num_histogram_stats()));
+    } else {
+      workspace.node_histograms->reset();
+    }
+    node_histograms = workspace.node_histograms.get();
   }
+  splitting_rule->set_node_histograms(node_histograms);
 
-  // nodes[0].size() is the number of samples subsampled for this tree.
-  std::unique_ptr<SplittingRule> splitting_rule = splitting_rule_factory->create(
-      nodes[0].size(), data, options);
+  if (workspace.responses_by_sample == nullptr) {
+    workspace.responses_by_sample.reset(new ResponsesBySample(
+        root_samples, data.get_num_rows(), relabeling_strategy->get_response_length()));
+  } else {
+    workspace.responses_by_sample->reset(root_samples);
+  }
+  ResponsesBySample& responses_by_sample = *workspace.responses_by_sample;
 
   size_t num_open_nodes = 1;
   size_t i = 0;
-  Eigen::ArrayXXd responses_by_sample(data.get_num_rows(), relabeling_strategy->get_response_length());
   while (num_open_nodes > 0) {
     bool is_leaf_node = split_node(i,
                                    data,
@@ -77,20 +133,29 @@ std::unique_ptr<Tree> TreeTrainer::train(const Data& data,
                                    split_values,
                                    send_missing_left,
                                    responses_by_sample,
+                                   sorted_sample_index,
+                                   workspace.possible_split_vars,
+                                   workspace.drawn_split_vars,
                                    options);
     if (is_leaf_node) {
       --num_open_nodes;
     } else {
-      nodes[i].clear();
       ++num_open_nodes;
     }
+    if (node_histograms != nullptr) {
+      if (!is_leaf_node) {
+        node_histograms->split_node(i, child_nodes[0][i], child_nodes[1][i]);
+      }
+      node_histograms->finish_node(i, is_leaf_node);
+    }
     ++i;
   }
 
-  std::vector<size_t> drawn_samples;
+  std::vector<size_t>& drawn_samples = workspace.drawn_samples;
+  drawn_samples.clear();
   sampler.get_samples_in_clusters(clusters, drawn_samples);
 
-  std::unique_ptr<Tree> tree(new Tree(0, child_nodes, nodes,
+  std::unique_ptr<Tree> tree(new Tree(0, child_nodes, LeafSamples(nodes),
       split_vars, split_values, drawn_samples, send_missing_left, PredictionValues()));
 
   if (!new_leaf_samples.empty()) {
@@ -98,10 +163,13 @@ std::unique_ptr<Tree> TreeTrainer::train(const Data& data,
   }
 
   PredictionValues prediction_values;
+  SparsePredictionValues sparse_prediction_values;
   if (prediction_strategy != nullptr) {
     prediction_values = prediction_strategy->precompute_prediction_values(tree->get_leaf_samples(), data);
+    sparse_prediction_values = prediction_strategy->precompute_sparse_prediction_values(tree->get_leaf_samples(), data);
   }
   tree->set_prediction_values(prediction_values);
+  tree->set_sparse_prediction_values(sparse_prediction_values);
 
   return tree;
 }
@@ -111,21 +179,15 @@ void TreeTrainer::repopulate_leaf_nodes(const std::unique_ptr<Tree>& tree,
                                         const std::vector<size_t>& leaf_samples,
                                         const bool honesty_prune_leaves) const {
   size_t num_nodes = tree->get_leaf_samples().size();
-  std::vector<std::vector<size_t>> new_leaf_nodes(num_nodes);
-
   std::vector<size_t> leaf_nodes = tree->find_leaf_nodes(data, leaf_samples);
-
-  for (auto& sample : leaf_samples) {
-    size_t leaf_node = leaf_nodes[sample];
-    new_leaf_nodes[leaf_node].push_back(sample);
-  }
-  tree->set_leaf_samples(new_leaf_nodes);
+  tree->set_leaf_samples(LeafSamples(num_nodes, leaf_samples, leaf_nodes));
   if (honesty_prune_leaves) {
     tree->honesty_prune_leaves();
   }
 }
 
 void TreeTrainer::create_split_variable_subset(std::vector<size_t>& result,
+                                               std::vector<bool>& drawn,
                                                RandomSampler& sampler,
                                                const Data& data,
                                                uint mtry) const {
@@ -138,7 +200,8 @@ void TreeTrainer::create_split_variable_subset(std::vector<size_t>& result,
   sampler.draw(result,
                data.get_num_cols(),
                data.get_disallowed_split_variables(),
-               split_mtry);
+               split_mtry,
+               drawn);
 }
 
 bool TreeTrainer::split_node(size_t node,
@@ -146,15 +209,17 @@ bool TreeTrainer::split_node(size_t node,
                              const std::unique_ptr<SplittingRule>& splitting_rule,
                              RandomSampler& sampler,
                              std::vector<std::vector<size_t>>& child_nodes,
-                             std::vector<std::vector<size_t>>& samples,
+                             NodeSamples& samples,
                              std::vector<size_t>& split_vars,
                              std::vector<double>& split_values,
                              std::vector<bool>& send_missing_left,
-                             Eigen::ArrayXXd& responses_by_sample,
+                             ResponsesBySample& responses_by_sample,
+                             SortedSampleIndex* sorted_sample_index,
+                             std::vector<size_t>& possible_split_vars,
+                             std::vector<bool>& drawn_split_vars,
                              const TreeOptions& options) const {
 
-  std::vector<size_t> possible_split_vars;
-  create_split_variable_subset(possible_split_vars, sampler, data, options.get_mtry());
+  create_split_variable_subset(possible_split_vars, drawn_split_vars, sampler, data, options.get_mtry());
 
   bool stop = split_node_internal(node,
                                   data,
@@ -165,6 +230,7 @@ bool TreeTrainer::split_node(size_t node,
                                   split_values,
                                   send_missing_left,
                                   responses_by_sample,
+                                  sorted_sample_index,
                                   options.get_min_node_size());
   if (stop) {
     return true;
@@ -184,17 +250,15 @@ bool TreeTrainer::split_node(size_t node,
 
   // For each sample in node, assign to left or right child
   // Ordered: left is <= splitval and right is > splitval
-  for (auto& sample : samples[node]) {
-  double value = data.get(sample, split_var);
-    if (
-        (value <= split_value) || // ordinary split
+  samples.split_node(node, left_child_node, right_child_node, [&](size_t sample) {
+    double value = data.get(sample, split_var);
+    return (value <= split_value) || // ordinary split
         (send_na_left && std::isnan(value)) || // are we sending NaN left
-        (std::isnan(split_value) && std::isnan(value)) // are we splitting on NaN, then always send NaNs left
-      ) {
-      samples[left_child_node].push_back(sample);
-    } else {
-      samples[right_child_node].push_back(sample);
-    }
+        (std::isnan(split_value) && std::isnan(value)); // are we splitting on NaN, then always send NaNs left
+  });
+
+  if (sorted_sample_index != nullptr) {
+    sorted_sample_index->split_node(node, left_child_node, right_child_node, samples[left_child_node]);
   }
 
   // No terminal node
@@ -205,11 +269,12 @@ bool TreeTrainer::split_node_internal(size_t node,
                                       const Data& data,
                                       const std::unique_ptr<SplittingRule>& splitting_rule,
                                       const std::vector<size_t>& possible_split_vars,
-                                      const std::vector<std::vector<size_t>>& samples,
+                                      const NodeSamples& samples,
                                       std::vector<size_t>& split_vars,
                                       std::vector<double>& split_values,
                                       std::vector<bool>& send_missing_left,
-                                      Eigen::ArrayXXd& responses_by_sample,
+                                      ResponsesBySample& responses_by_sample,
+                                      SortedSampleIndex* sorted_sample_index,
                                       uint min_node_size) const {
   // Check node size, stop if maximum reached
   if (samples[node].size() <= min_node_size) {
@@ -219,6 +284,10 @@ bool TreeTrainer::split_node_internal(size_t node,
 
   bool stop = relabeling_strategy->relabel(samples[node], data, responses_by_sample);
 
+  if (sorted_sample_index != nullptr) {
+    sorted_sample_index->set_node(node, samples[node]);
+  }
+
   if (stop || splitting_rule->find_best_split(data,
                                               node,
                                               possible_split_vars,
@@ -235,13 +304,13 @@ bool TreeTrainer::split_node_internal(size_t node,
 }
 
 void TreeTrainer::create_empty_node(std::vector<std::vector<size_t>>& child_nodes,
-                                    std::vector<std::vector<size_t>>& samples,
+                                    NodeSamples& samples,
                                     std::vector<size_t>& split_vars,
                                     std::vector<double>& split_values,
                                     std::vector<bool>& send_missing_left) const {
   child_nodes[0].push_back(0);
   child_nodes[1].push_back(0);
-  samples.emplace_back();
+  samples.add_node();
   split_vars.push_back(0);
   split_values.push_back(0);
   send_missing_left.push_back(true);
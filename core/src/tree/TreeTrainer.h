@@ -24,12 +24,16 @@
 
 #include "Eigen/Dense"
 #include "commons/Data.h"
+#include "commons/NodeSamples.h"
 #include "prediction/OptimizedPredictionStrategy.h"
 #include "relabeling/RelabelingStrategy.h"
 #include "sampling/RandomSampler.h"
+#include "splitting/NodeHistograms.h"
+#include "splitting/SortedSampleIndex.h"
 #include "splitting/factory/SplittingRuleFactory.h"
 #include "tree/Tree.h"
 #include "tree/TreeOptions.h"
+#include "tree/TreeTrainingWorkspace.h"
 
 namespace grf {
 
@@ -44,9 +48,19 @@ public:
                               const std::vector<size_t>& clusters,
                               const TreeOptions& options) const;
 
+  /**
+   * Same as above, but reuses the scratch buffers in `workspace` from the previous
+   * trees instead of allocating them for this tree.
+   */
+  std::unique_ptr<Tree> train(const Data& data,
+                              RandomSampler& sampler,
+                              const std::vector<size_t>& clusters,
+                              const TreeOptions& options,
+                              TreeTrainingWorkspace& workspace) const;
+
 private:
   void create_empty_node(std::vector<std::vector<size_t>>& child_nodes,
-                         std::vector<std::vector<size_t>>& samples,
+                         NodeSamples& samples,
                          std::vector<size_t>& split_vars,
                          std::vector<double>& split_values,
                          std::vector<bool>& send_missing_left) const;
@@ -57,6 +71,7 @@ private:
                              const bool honesty_prune_leaves) const;
 
   void create_split_variable_subset(std::vector<size_t>& result,
+                                    std::vector<bool>& drawn,
                                     RandomSampler& sampler,
                                     const Data& data,
                                     uint mtry) const;
@@ -66,22 +81,26 @@ private:
                   const std::unique_ptr<SplittingRule>& splitting_rule,
                   RandomSampler& sampler,
                   std::vector<std::vector<size_t>>& child_nodes,
-                  std::vector<std::vector<size_t>>& samples,
+                  NodeSamples& samples,
                   std::vector<size_t>& split_vars,
                   std::vector<double>& split_values,
                   std::vector<bool>& send_missing_left,
-                  Eigen::ArrayXXd& responses_by_sample,
+                  ResponsesBySample& responses_by_sample,
+                  SortedSampleIndex* sorted_sample_index,
+                  std::vector<size_t>& possible_split_vars,
+                  std::vector<bool>& drawn_split_vars,
                   const TreeOptions& tree_options) const;
 
   bool split_node_internal(size_t node,
                            const Data& data,
                            const std::unique_ptr<SplittingRule>& splitting_rule,
                            const std::vector<size_t>& possible_split_vars,
-                           const std::vector<std::vector<size_t>>& samples,
+                           const NodeSamples& samples,
                            std::vector<size_t>& split_vars,
                            std::vector<double>& split_values,
                            std::vector<bool>& send_missing_left,
-                           Eigen::ArrayXXd& responses_by_sample,
+                           ResponsesBySample& responses_by_sample,
+                           SortedSampleIndex* sorted_sample_index,
                            uint min_node_size) const ;
 
   std::set<size_t> disallowed_split_variables;
@@ -0,0 +1,116 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#ifndef GRF_TREETRAININGWORKSPACE_H
+#define GRF_TREETRAININGWORKSPACE_H
+
+#include <memory>
+#include <vector>
+
+#include "commons/NodeSamples.h"
+#include "commons/ResponsesBySample.h"
+#include "commons/globals.h"
+#include "splitting/NodeHistograms.h"
+#include "splitting/SortedSampleIndex.h"
+#include "splitting/SplittingRule.h"
+
+namespace grf {
+
+/**
+ * The scratch state of a TreeTrainer: the splitting rule's buffers, the node partition,
+ * the relabeled responses, the split search indexes, the sampled clusters and split
+ * variables, and the growing tree's structure, which the trained tree copies once.
+ *
+ * A workspace is created once per training thread and passed to every call to
+ * TreeTrainer::train, which resets it at the start of each tree instead of allocating
+ * it anew. It may only be reused for trees trained by the same TreeTrainer on the same
+ * data and tree options.
+ */
+class TreeTrainingWorkspace {
+public:
+  /**
+   * @param sorted_sample_index_max_bytes: the memory budget of the presorted sample index
+   * (see SortedSampleIndex::is_beneficial).
+   */
+  TreeTrainingWorkspace(size_t sorted_sample_index_max_bytes = SortedSampleIndex::DEFAULT_MAX_BYTES):
+      splitting_rule_capacity(0),
+      sorted_sample_index_max_bytes(sorted_sample_index_max_bytes) {}
+
+  const SplittingRule* get_splitting_rule() const { return splitting_rule.get(); }
+
+  const NodeSamples& get_nodes() const { return nodes; }
+
+  const ResponsesBySample* get_responses_by_sample() const { return responses_by_sample.get(); }
+
+  const SortedSampleIndex* get_sorted_sample_index() const { return sorted_sample_index.get(); }
+
+  const NodeHistograms* get_node_histograms() const { return node_histograms.get(); }
+
+  /**
+   * The addresses of the vectors owned by this workspace and of the splitting rule's split
+   * search buffers. A vector that is allocated or grown while training a tree changes its
+   * address, so comparing them before and after a tree counts the allocations it made.
+   */
+  std::vector<const void*> get_buffers() const {
+    std::vector<const void*> buffers = {
+        split_vars.data(), split_values.data(),
+        tree_growing_clusters.data(), new_leaf_clusters.data(),
+        root_samples.data(), new_leaf_samples.data(), drawn_samples.data(),
+        possible_split_vars.data()};
+    for (auto& nodes_by_child : child_nodes) {
+      buffers.push_back(nodes_by_child.data());
+    }
+    if (splitting_rule != nullptr) {
+      splitting_rule->get_buffers(buffers);
+    }
+    return buffers;
+  }
+
+private:
+  friend class TreeTrainer;
+
+  std::unique_ptr<SplittingRule> splitting_rule;
+  // The number of samples the splitting rule was created for.
+  size_t splitting_rule_capacity;
+
+  NodeSamples nodes;
+  std::unique_ptr<ResponsesBySample> responses_by_sample;
+  std::unique_ptr<SortedSampleIndex> sorted_sample_index;
+  size_t sorted_sample_index_max_bytes;
+  std::unique_ptr<NodeHistograms> node_histograms;
+
+  std::vector<std::vector<size_t>> child_nodes;
+  std::vector<size_t> split_vars;
+  std::vector<double> split_values;
+  std::vector<bool> send_missing_left;
+
+  std::vector<size_t> tree_growing_clusters;
+  std::vector<size_t> new_leaf_clusters;
+  std::vector<size_t> root_samples;
+  std::vector<size_t> new_leaf_samples;
+  std::vector<size_t> drawn_samples;
+  std::vector<size_t> possible_split_vars;
+  std::vector<bool> drawn_split_vars;
+
+  DISALLOW_COPY_AND_ASSIGN(TreeTrainingWorkspace);
+};
+
+} // namespace grf
+
+#endif //GRF_TREETRAININGWORKSPACE_H
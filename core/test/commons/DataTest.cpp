@@ -0,0 +1,213 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "commons/Data.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+TEST_CASE("binned data sorts samples by bin", "[data]") {
+  std::vector<double> data_vec = {
+    1, 2, 2, NAN, 3, 4, 5, 6, // X
+    0, 0, 0, 0, 0, 0, 0, 0 // Y
+  };
+  Data data(data_vec, 8, 2);
+  data.set_outcome_index(1);
+  data.set_max_bins(3);
+
+  // Three bins of (roughly) equal size, represented by their largest value.
+  REQUIRE(std::isnan(data.get_bin_value(3, 0)));
+  REQUIRE(data.get_bin_value(0, 0) == 2);
+  REQUIRE(data.get_bin_value(2, 0) == 2);
+  REQUIRE(data.get_bin_value(4, 0) == 4);
+  REQUIRE(data.get_bin_value(5, 0) == 4);
+  REQUIRE(data.get_bin_value(7, 0) == 6);
+  // Covariates that cannot be split on are not binned.
+  REQUIRE(data.get_bin_value(0, 1) == 0);
+
+  std::vector<double> values;
+  std::vector<size_t> sorted_samples;
+  std::vector<size_t> samples = {7, 0, 4, 3, 1, 6};
+  std::vector<size_t> index = data.get_all_values(values, sorted_samples, samples, 0);
+
+  REQUIRE(values.size() == 4);
+  REQUIRE(std::isnan(values[0]));
+  REQUIRE(std::vector<double>(values.begin() + 1, values.end()) == std::vector<double>({2, 4, 6}));
+  REQUIRE(sorted_samples == std::vector<size_t>({3, 0, 1, 4, 7, 6}));
+  REQUIRE(index == std::vector<size_t>({3, 1, 4, 2, 0, 5}));
+}
+
+TEST_CASE("binned data keeps every value if there are few enough", "[data]") {
+  std::vector<double> data_vec = {3, 1, 2, 1, 3, 2};
+  Data data(data_vec, 6, 1);
+  data.set_max_bins(UINT8_MAX + 1);
+
+  for (size_t row = 0; row < data.get_num_rows(); row++) {
+    REQUIRE(data.get_bin_value(row, 0) == data.get(row, 0));
+  }
+}
+
+TEST_CASE("single precision data rounds only the covariates", "[data]") {
+  std::vector<double> data_vec = {
+    0.1, -2.5, NAN, 1e10, // X1
+    1.0 / 3, 0, 7, -1, // Y
+    0.2, 0.3, 0.4, 0.5, // weights
+    1.0 / 7, 2, NAN, 4 // X2
+  };
+  Data data(data_vec, 4, 4);
+  data.set_outcome_index(1);
+  data.set_weight_index(2);
+  Data float_data = data;
+  float_data.set_single_precision(true);
+
+  REQUIRE(!data.is_single_precision());
+  REQUIRE(float_data.is_single_precision());
+  for (size_t row = 0; row < 4; row++) {
+    for (size_t col : {0, 3}) {
+      double expected = static_cast<float>(data.get(row, col));
+      if (std::isnan(expected)) {
+        REQUIRE(std::isnan(float_data.get(row, col)));
+      } else {
+        REQUIRE(float_data.get(row, col) == expected);
+      }
+    }
+    REQUIRE(float_data.get_outcome(row) == data.get_outcome(row));
+    REQUIRE(float_data.get_weight(row) == data.get_weight(row));
+    // Columns without a single precision copy are read in double precision.
+    REQUIRE(float_data.get(row, 1) == data.get(row, 1));
+  }
+
+  // Copies share the single precision storage.
+  Data copy = float_data;
+  REQUIRE(copy.get(0, 3) == static_cast<float>(1.0 / 7));
+
+  float_data.set_single_precision(false);
+  REQUIRE(!float_data.is_single_precision());
+  REQUIRE(float_data.get(0, 3) == 1.0 / 7);
+  REQUIRE(copy.is_single_precision());
+}
+
+TEST_CASE("data can wrap a single precision array", "[data]") {
+  std::vector<float> data_vec = {
+    0.1f, -2.5f, NAN, // X1
+    0.3f, 7, -1, // Y
+    0.25f, 1, 2, // weights
+    4, 5, 6 // X2
+  };
+  Data data(data_vec, 3, 4);
+  data.set_outcome_index(1);
+  data.set_weight_index(2);
+
+  REQUIRE(data.is_single_precision());
+  for (size_t row = 0; row < 3; row++) {
+    for (size_t col : {0, 3}) {
+      double expected = data_vec[col * 3 + row];
+      if (std::isnan(expected)) {
+        REQUIRE(std::isnan(data.get(row, col)));
+      } else {
+        REQUIRE(data.get(row, col) == expected);
+      }
+    }
+    REQUIRE(data.get_outcome(row) == static_cast<double>(data_vec[3 + row]));
+    REQUIRE(data.get_outcomes(row)(0) == static_cast<double>(data_vec[3 + row]));
+    REQUIRE(data.get_weight(row) == static_cast<double>(data_vec[6 + row]));
+  }
+
+  data.set_single_precision(true);
+  REQUIRE(data.is_single_precision());
+  REQUIRE_THROWS_AS(data.set_single_precision(false), std::runtime_error);
+}
+
+TEST_CASE("outcome and treatment views match the data columns", "[data]") {
+  std::vector<double> data_vec = {
+    1, 2, 3, // X
+    4, 5, 6, // Y1
+    7, 8, 9, // W1
+    10, 11, 12, // Y2
+    13, 14, 15, // W2
+    0.5, 1, 2 // sample weight
+  };
+  Data data(data_vec, 3, 6);
+  data.set_outcome_index({1, 3});
+  data.set_treatment_index({2, 4});
+  data.set_instrument_index(4);
+  data.set_weight_index(5);
+
+  for (size_t row = 0; row < 3; row++) {
+    Data::RowView outcomes = data.get_outcomes(row);
+    Data::RowView treatments = data.get_treatments(row);
+    REQUIRE(outcomes.size() == 2);
+    REQUIRE(outcomes(0) == data.get(row, 1));
+    REQUIRE(outcomes(1) == data.get(row, 3));
+    REQUIRE(treatments(0) == data.get(row, 2));
+    REQUIRE(treatments(1) == data.get(row, 4));
+    REQUIRE(data.get_outcome(row) == data.get(row, 1));
+    REQUIRE(data.get_treatment(row) == data.get(row, 2));
+    REQUIRE(data.get_instrument(row) == data.get(row, 4));
+    REQUIRE(data.get_weight(row) == data.get(row, 5));
+  }
+}
+
+TEST_CASE("single columns are read in place and several are copied into rows", "[data]") {
+  std::vector<double> data_vec = {
+    1, 2, 3, // X
+    4, 5, 6, // Y
+    7, 8, 9, // W1
+    10, 11, 12, // W2
+    13, 14, 15, // W3
+  };
+  Data data(data_vec, 3, 5);
+  data.set_outcome_index(1);
+  data.set_treatment_index({2, 3, 4});
+
+  // The values of a row are adjacent in the copy.
+  Data::RowView treatments = data.get_treatments(1);
+  REQUIRE(treatments.size() == 3);
+  REQUIRE(treatments.innerStride() == 1);
+  REQUIRE(data.get_treatments(2).data() == treatments.data() + 3);
+
+  data_vec[4] = -5;
+  data_vec[7] = -8;
+  REQUIRE(data.get_outcome(1) == -5);
+  REQUIRE(data.get_outcomes(1)(0) == -5);
+  REQUIRE(data.get_treatment(1) == 8);
+  REQUIRE(data.get_treatments(1)(0) == 8);
+  REQUIRE(data.get_treatments(1)(1) == 11);
+  REQUIRE(data.get_treatments(1)(2) == 14);
+}
+
+TEST_CASE("data without a weight index has unit weights", "[data]") {
+  std::vector<double> data_vec = {1, 2, 3, 4, 5, 6};
+  Data data(data_vec, 3, 2);
+
+  REQUIRE(!data.has_weights());
+  for (size_t row = 0; row < data.get_num_rows(); row++) {
+    REQUIRE(data.get_weight(row) == 1);
+  }
+
+  data.set_weight_index(1);
+  REQUIRE(data.has_weights());
+  REQUIRE(data.get_weight(0) == 4);
+  REQUIRE(data.get_weight(2) == 6);
+}
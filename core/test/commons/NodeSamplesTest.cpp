@@ -0,0 +1,56 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <vector>
+
+#include "commons/NodeSamples.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+TEST_CASE("splitting a node partitions its samples stably into its children", "[data]") {
+  NodeSamples samples;
+  samples.add_node();
+  samples.set_root_samples({7, 2, 9, 4, 1, 8, 3});
+
+  size_t left = samples.add_node();
+  size_t right = samples.add_node();
+  samples.split_node(0, left, right, [](size_t sample) { return sample % 2 == 0; });
+
+  std::vector<std::vector<size_t>> samples_by_node = samples.get_samples_by_node();
+  REQUIRE(samples_by_node.size() == 3);
+  REQUIRE(samples_by_node[0].empty());
+  REQUIRE(samples_by_node[1] == std::vector<size_t>({2, 4, 8}));
+  REQUIRE(samples_by_node[2] == std::vector<size_t>({7, 9, 1, 3}));
+
+  // The children are adjacent ranges of the same buffer.
+  REQUIRE(samples[left].end() == samples[right].begin());
+
+  size_t left_left = samples.add_node();
+  size_t left_right = samples.add_node();
+  samples.split_node(left, left_left, left_right, [](size_t sample) { return sample > 2; });
+  REQUIRE(samples[left_left].size() == 2);
+  REQUIRE(samples[left_left][0] == 4);
+  REQUIRE(samples[left_left][1] == 8);
+  REQUIRE(samples[left_right].size() == 1);
+  REQUIRE(samples[left_right][0] == 2);
+  REQUIRE(samples[left].empty());
+  REQUIRE(samples[right].size() == 4);
+}
@@ -0,0 +1,41 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <vector>
+
+#include "commons/ResponsesBySample.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+TEST_CASE("compact responses are stored by sample ID", "[data]") {
+  std::vector<size_t> samples = {8, 3, 5};
+  ResponsesBySample responses(samples, 10, 2);
+  for (auto& sample : samples) {
+    responses(sample, 0) = sample;
+    responses.row(sample)(1) = 2.0 * sample;
+  }
+
+  for (auto& sample : samples) {
+    REQUIRE(responses(sample, 0) == sample);
+    REQUIRE(responses(sample, 1) == 2.0 * sample);
+    REQUIRE(responses.row(sample).sum() == 3.0 * sample);
+  }
+}
@@ -0,0 +1,83 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include "commons/ThreadPool.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+TEST_CASE("thread pool runs every task once", "[commons]") {
+  for (uint num_threads : {1, 2, 8}) {
+    for (size_t num_tasks : {0, 1, 3, 100}) {
+      std::vector<std::atomic<size_t>> num_runs(num_tasks);
+      std::vector<std::atomic<bool>> worker_busy(num_threads);
+      std::atomic<bool> invalid_worker(false);
+      ThreadPool::get_instance().parallel_for(num_tasks, num_threads, [&](size_t task, size_t worker) {
+        // Two threads may never run tasks as the same worker at the same time.
+        if (worker >= num_threads || worker_busy[worker].exchange(true)) {
+          invalid_worker = true;
+          return;
+        }
+        num_runs[task]++;
+        worker_busy[worker] = false;
+      });
+
+      REQUIRE_FALSE(invalid_worker);
+      for (size_t task = 0; task < num_tasks; task++) {
+        REQUIRE(num_runs[task] == 1);
+      }
+    }
+  }
+}
+
+TEST_CASE("thread pool rethrows the exception of a failed task", "[commons]") {
+  REQUIRE_THROWS_AS(ThreadPool::get_instance().parallel_for(100, 4, [&](size_t task, size_t) {
+    if (task == 10) {
+      throw std::runtime_error("task failed");
+    }
+  }), std::runtime_error);
+
+  // The pool is still usable afterwards.
+  std::atomic<size_t> num_runs(0);
+  ThreadPool::get_instance().parallel_for(10, 4, [&](size_t, size_t) { num_runs++; });
+  REQUIRE(num_runs == 10);
+}
+
+TEST_CASE("thread pool can be used again after a shutdown", "[commons]") {
+  ThreadPool& pool = ThreadPool::get_instance();
+  for (size_t round = 0; round < 3; round++) {
+    std::atomic<size_t> num_runs(0);
+    pool.parallel_for(100, 4, [&](size_t, size_t) { num_runs++; });
+    REQUIRE(num_runs == 100);
+    pool.shutdown();
+  }
+  pool.shutdown();
+}
+
+TEST_CASE("chunks cover all items with a few chunks per thread", "[commons]") {
+  REQUIRE(ThreadPool::get_num_chunks(0, 4) == 1);
+  REQUIRE(ThreadPool::get_num_chunks(3, 4) == 3);
+  REQUIRE(ThreadPool::get_num_chunks(1000, 4) == 16);
+  REQUIRE(ThreadPool::get_num_chunks(1000, 0) == 4);
+}
@@ -22,6 +22,7 @@
 #include "forest/ForestPredictors.h"
 #include "forest/ForestTrainer.h"
 #include "forest/ForestTrainers.h"
+#include "prediction/InstrumentalPredictionStrategy.h"
 #include "utilities/ForestTestUtilities.h"
 
 #include "catch.hpp"
@@ -77,3 +78,56 @@ TEST_CASE("causal forests are invariant to rescaling of the sample weights", "[c
 
   REQUIRE(equal_doubles(delta / predictions.size(), 0, 1e-1));
 }
+
+TEST_CASE("causal forest variance estimates match the estimates from every tree's leaf values", "[causal, forest]") {
+  auto data_vec = load_data("test/forest/resources/causal_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+  data.set_treatment_index(11);
+  data.set_instrument_index(11);
+  size_t num_rows = data.get_num_rows();
+  size_t ci_group_size = 2;
+
+  Forest forest = instrumental_trainer(0, true).train(data, ForestTestUtilities::default_options(true, ci_group_size));
+  std::vector<Prediction> predictions = instrumental_predictor(4).predict(forest, data, data, true);
+  size_t num_trees = forest.get_trees().size();
+  size_t num_types = InstrumentalPredictionStrategy::NUM_TYPES;
+
+  std::vector<PredictionValues> leaf_values(num_rows, PredictionValues(num_trees, num_types));
+  std::vector<bool> all_samples(num_rows, true);
+  for (size_t tree_index = 0; tree_index < num_trees; tree_index++) {
+    const PredictionValues& prediction_values = forest.get_trees()[tree_index]->get_prediction_values();
+    std::vector<size_t> leaf_nodes = forest.get_trees()[tree_index]->find_leaf_nodes(data, all_samples);
+    for (size_t sample = 0; sample < num_rows; sample++) {
+      size_t node = leaf_nodes[sample];
+      if (prediction_values.empty(node)) {
+        continue;
+      }
+      double* values = leaf_values[sample].initialize_values(tree_index);
+      for (size_t type = 0; type < num_types; type++) {
+        values[type] = prediction_values.get(node, type);
+      }
+    }
+  }
+
+  InstrumentalPredictionStrategy strategy;
+  for (size_t sample = 0; sample < num_rows; sample++) {
+    std::vector<double> average(num_types, 0.0);
+    size_t num_leaves = 0;
+    for (size_t tree_index = 0; tree_index < num_trees; tree_index++) {
+      if (leaf_values[sample].empty(tree_index)) {
+        continue;
+      }
+      for (size_t type = 0; type < num_types; type++) {
+        average[type] += leaf_values[sample].get(tree_index, type);
+      }
+      num_leaves++;
+    }
+    for (double& value : average) {
+      value /= num_leaves;
+    }
+
+    double variance = strategy.compute_variance(average, leaf_values[sample], ci_group_size)[0];
+    REQUIRE(equal_doubles(predictions[sample].get_variance_estimates()[0], variance, 1e-10));
+  }
+}
@@ -17,11 +17,18 @@
   along with grf. If not, see <http://www.gnu.org/licenses/>.
  #-------------------------------------------------------------------------------*/
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 #include "commons/utility.h"
+#include "forest/CausalSurvivalNuisance.h"
 #include "forest/ForestPredictor.h"
 #include "forest/ForestPredictors.h"
 #include "forest/ForestTrainer.h"
 #include "forest/ForestTrainers.h"
+#include "prediction/SurvivalPredictionStrategy.h"
+#include "relabeling/CausalSurvivalScores.h"
 #include "utilities/ForestTestUtilities.h"
 
 #include "catch.hpp"
@@ -51,3 +58,226 @@ TEST_CASE("causal survival forests give positive variance estimates", "[causal s
     REQUIRE(variance_estimate > 0);
   }
 }
+
+/**
+ * Replaces the event times of the survival data with their indices into the failure
+ * times, the observed event times, and returns the failure times.
+ */
+std::vector<double> relabel_failure_times(std::pair<std::vector<double>, std::vector<size_t>>& data_vec,
+                                          size_t outcome_index,
+                                          size_t censor_index) {
+  Data data(data_vec);
+  size_t num_rows = data.get_num_rows();
+  std::vector<double> failure_times;
+  for (size_t sample = 0; sample < num_rows; ++sample) {
+    if (data.get(sample, censor_index) == 1) {
+      failure_times.push_back(data.get(sample, outcome_index));
+    }
+  }
+  std::sort(failure_times.begin(), failure_times.end());
+  failure_times.erase(std::unique(failure_times.begin(), failure_times.end()), failure_times.end());
+
+  for (size_t sample = 0; sample < num_rows; ++sample) {
+    double Y = data.get(sample, outcome_index);
+    size_t index = std::upper_bound(failure_times.begin(), failure_times.end(), Y) - failure_times.begin();
+    set_data(data_vec, sample, outcome_index, index);
+  }
+  return failure_times;
+}
+
+/**
+ * A survival curve at the failure times evaluated on the grid.
+ */
+std::vector<double> curve_on_grid(const std::vector<double>& curve,
+                                  const std::vector<double>& failure_times,
+                                  const std::vector<double>& grid) {
+  std::vector<double> result;
+  for (double time : grid) {
+    size_t index = std::upper_bound(failure_times.begin(), failure_times.end(), time) - failure_times.begin();
+    result.push_back(index == 0 ? 1 : curve[index - 1]);
+  }
+  return result;
+}
+
+TEST_CASE("causal survival nuisance estimates match estimates from dense survival curves", "[causal survival]") {
+  auto data_vec = load_data("test/forest/resources/survival_data.csv");
+  Data original_data(data_vec);
+  size_t num_rows = original_data.get_num_rows();
+  std::vector<double> Y;
+  std::vector<double> censor;
+  for (size_t sample = 0; sample < num_rows; ++sample) {
+    Y.push_back(original_data.get(sample, 5));
+    censor.push_back(original_data.get(sample, 6));
+  }
+  std::vector<double> grid = Y;
+  std::sort(grid.begin(), grid.end());
+  grid.erase(std::unique(grid.begin(), grid.end()), grid.end());
+
+  auto censor_data_vec = data_vec;
+  for (size_t sample = 0; sample < num_rows; ++sample) {
+    set_data(censor_data_vec, sample, 6, 1 - censor[sample]);
+  }
+  std::vector<double> failure_times = relabel_failure_times(data_vec, 5, 6);
+  std::vector<double> censor_failure_times = relabel_failure_times(censor_data_vec, 5, 6);
+  Data data(data_vec);
+  data.set_outcome_index(5);
+  data.set_censor_index(6);
+  Data censor_data(censor_data_vec);
+  censor_data.set_outcome_index(5);
+  censor_data.set_censor_index(6);
+
+  ForestTrainer trainer = survival_trainer(false);
+  Forest forest = trainer.train(data, ForestTestUtilities::default_options());
+  Forest censor_forest = trainer.train(censor_data, ForestTestUtilities::default_options());
+
+  int prediction_type = SurvivalPredictionStrategy::NELSON_AALEN;
+  std::vector<Prediction> curves = survival_predictor(4, failure_times.size(), prediction_type)
+      .predict_oob(forest, data, false);
+  std::vector<Prediction> censor_curves = survival_predictor(4, censor_failure_times.size(), prediction_type)
+      .predict_oob(censor_forest, censor_data, false);
+
+  std::vector<double> W_centered;
+  std::vector<size_t> Y_index;
+  for (size_t sample = 0; sample < num_rows; ++sample) {
+    W_centered.push_back(data.get(sample, 0));
+    Y_index.push_back(std::lower_bound(grid.begin(), grid.end(), Y[sample]) - grid.begin());
+  }
+
+  CausalSurvivalScores scores(grid, CausalSurvivalScores::RMST, grid.back());
+  std::vector<double> Y_hat = causal_survival_expected_outcomes_oob(
+      forest, data, failure_times, prediction_type, scores, 4);
+  std::vector<double> numerators;
+  std::vector<double> C_Y_hat;
+  causal_survival_numerators_oob(forest, data, failure_times, censor_forest, censor_data, censor_failure_times,
+                                 prediction_type, scores, Y_hat, W_centered, censor, Y, Y_index, 4,
+                                 numerators, C_Y_hat);
+  REQUIRE(Y_hat.size() == num_rows);
+  REQUIRE(numerators.size() == num_rows);
+  REQUIRE(C_Y_hat.size() == num_rows);
+
+  // The nuisance estimates as computed from the full survival curves, with
+  // Q(t) = t + (the area under S after t) / S(t) updated forwards over t.
+  size_t grid_length = grid.size();
+  for (size_t sample = 0; sample < num_rows; ++sample) {
+    const std::vector<double>& curve = curves[sample].get_predictions();
+    double expected_Y_hat = failure_times[0];
+    for (size_t k = 0; k + 1 < failure_times.size(); ++k) {
+      expected_Y_hat += curve[k] * (failure_times[k + 1] - failure_times[k]);
+    }
+    REQUIRE(equal_doubles(Y_hat[sample], expected_Y_hat, 1e-10));
+
+    std::vector<double> S = curve_on_grid(curve, failure_times, grid);
+    std::vector<double> C = curve_on_grid(censor_curves[sample].get_predictions(), censor_failure_times, grid);
+    std::vector<double> Q(grid_length);
+    double area = 0;
+    for (size_t t = 0; t + 1 < grid_length; ++t) {
+      area += S[t] * (grid[t + 1] - grid[t]);
+    }
+    for (size_t t = 0; t + 1 < grid_length; ++t) {
+      Q[t] = grid[t] + area / S[t];
+      area -= S[t] * (grid[t + 1] - grid[t]);
+    }
+    Q[grid_length - 1] = grid.back();
+
+    size_t index = Y_index[sample];
+    double numerator_one = (censor[sample] * (Y[sample] - Y_hat[sample]) +
+        (1 - censor[sample]) * (Q[index] - Y_hat[sample])) * W_centered[sample] / C[index];
+    double numerator_two = 0;
+    for (size_t t = 0; t <= index; ++t) {
+      double dlambda = -std::log(C[t]) + (t == 0 ? 0 : std::log(C[t - 1]));
+      numerator_two += dlambda / C[t] * (Q[t] - Y_hat[sample]);
+    }
+    numerator_two *= W_centered[sample];
+
+    REQUIRE(C_Y_hat[sample] == C[index]);
+    REQUIRE(equal_doubles(numerators[sample], numerator_one - numerator_two, 1e-8));
+  }
+}
+
+TEST_CASE("causal survival nuisance estimates are close from forests with leaf events", "[causal survival]") {
+  auto data_vec = load_data("test/forest/resources/survival_data.csv");
+  Data original_data(data_vec);
+  size_t num_rows = original_data.get_num_rows();
+  auto censor_data_vec = data_vec;
+  std::vector<double> Y;
+  std::vector<double> censor;
+  for (size_t sample = 0; sample < num_rows; ++sample) {
+    Y.push_back(original_data.get(sample, 5));
+    censor.push_back(original_data.get(sample, 6));
+    set_data(censor_data_vec, sample, 6, 1 - censor[sample]);
+  }
+  std::vector<double> grid = Y;
+  std::sort(grid.begin(), grid.end());
+  grid.erase(std::unique(grid.begin(), grid.end()), grid.end());
+
+  std::vector<double> failure_times = relabel_failure_times(data_vec, 5, 6);
+  std::vector<double> censor_failure_times = relabel_failure_times(censor_data_vec, 5, 6);
+  Data data(data_vec);
+  data.set_outcome_index(5);
+  data.set_censor_index(6);
+  Data censor_data(censor_data_vec);
+  censor_data.set_outcome_index(5);
+  censor_data.set_censor_index(6);
+
+  ForestOptions options = ForestTestUtilities::default_options();
+  Forest forest = survival_trainer(false).train(data, options);
+  Forest censor_forest = survival_trainer(false).train(censor_data, options);
+  Forest optimized_forest = optimized_survival_trainer(false, failure_times.size()).train(data, options);
+  Forest optimized_censor_forest = optimized_survival_trainer(false, censor_failure_times.size())
+      .train(censor_data, options);
+  REQUIRE(optimized_forest.has_sparse_prediction_values());
+
+  std::vector<double> W_centered;
+  std::vector<size_t> Y_index;
+  for (size_t sample = 0; sample < num_rows; ++sample) {
+    W_centered.push_back(data.get(sample, 0));
+    Y_index.push_back(std::lower_bound(grid.begin(), grid.end(), Y[sample]) - grid.begin());
+  }
+
+  int prediction_type = SurvivalPredictionStrategy::NELSON_AALEN;
+  CausalSurvivalScores scores(grid, CausalSurvivalScores::RMST, grid.back());
+  std::vector<double> Y_hat = causal_survival_expected_outcomes_oob(
+      forest, data, failure_times, prediction_type, scores, 4);
+  std::vector<double> optimized_Y_hat = causal_survival_expected_outcomes_oob(
+      optimized_forest, data, failure_times, prediction_type, scores, 4);
+  for (size_t sample = 0; sample < num_rows; ++sample) {
+    REQUIRE(equal_doubles(optimized_Y_hat[sample], Y_hat[sample], 1e-10));
+  }
+
+  std::vector<double> numerators;
+  std::vector<double> C_Y_hat;
+  causal_survival_numerators_oob(forest, data, failure_times, censor_forest, censor_data, censor_failure_times,
+                                 prediction_type, scores, Y_hat, W_centered, censor, Y, Y_index, 4,
+                                 numerators, C_Y_hat);
+  std::vector<double> optimized_numerators;
+  std::vector<double> optimized_C_Y_hat;
+  causal_survival_numerators_oob(optimized_forest, data, failure_times, optimized_censor_forest, censor_data,
+                                 censor_failure_times, prediction_type, scores, Y_hat, W_centered, censor, Y,
+                                 Y_index, 4, optimized_numerators, optimized_C_Y_hat);
+  for (size_t sample = 0; sample < num_rows; ++sample) {
+    REQUIRE(equal_doubles(optimized_numerators[sample], numerators[sample], 1e-8));
+    REQUIRE(equal_doubles(optimized_C_Y_hat[sample], C_Y_hat[sample], 1e-10));
+  }
+}
+
+TEST_CASE("OOB predictions of a range of samples match OOB predictions", "[causal survival], [forest]") {
+  auto data_vec = load_data("test/forest/resources/survival_data.csv");
+  std::vector<double> failure_times = relabel_failure_times(data_vec, 5, 6);
+  Data data(data_vec);
+  data.set_outcome_index(5);
+  data.set_censor_index(6);
+  size_t num_rows = data.get_num_rows();
+
+  Forest forest = survival_trainer(false).train(data, ForestTestUtilities::default_options());
+  ForestPredictor predictor = survival_predictor(4, failure_times.size(), SurvivalPredictionStrategy::KAPLAN_MEIER);
+  std::vector<Prediction> predictions = predictor.predict_oob(forest, data, false);
+
+  size_t start = 123;
+  size_t num_samples = 456;
+  std::vector<Prediction> range_predictions = predictor.predict_oob(forest, data, start, num_samples, false);
+  REQUIRE(range_predictions.size() == num_samples);
+  for (size_t i = 0; i < num_samples; ++i) {
+    REQUIRE(range_predictions[i].get_predictions() == predictions[start + i].get_predictions());
+  }
+  REQUIRE(predictor.predict_oob(forest, data, num_rows, 0, false).empty());
+}
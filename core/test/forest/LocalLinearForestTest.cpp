@@ -205,3 +205,101 @@ TEST_CASE("LLF causal predictions are unaffected by shifts in Y", "[local linear
 
   REQUIRE(delta / predictions.size() < 1e-1);
 }
+
+void require_same_ll_predictions(const std::vector<Prediction>& predictions,
+                                 const std::vector<Prediction>& optimized_predictions) {
+  REQUIRE(predictions.size() == optimized_predictions.size());
+  for (size_t i = 0; i < predictions.size(); i++) {
+    const std::vector<double>& expected = predictions[i].get_predictions();
+    const std::vector<double>& actual = optimized_predictions[i].get_predictions();
+    REQUIRE(expected.size() == actual.size());
+    for (size_t j = 0; j < expected.size(); j++) {
+      REQUIRE(equal_doubles(expected[j], actual[j], 1e-6 * std::max(1.0, std::abs(expected[j]))));
+    }
+  }
+}
+
+TEST_CASE("LLF predictions from precomputed moments match the default predictions", "[local linear], [forest]") {
+  auto data_vec = load_data("test/forest/resources/friedman.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+  std::vector<size_t> linear_correction_variables = {0, 1, 3, 4};
+  std::vector<double> lambdas = {0.01, 0.1, 1};
+
+  ForestTrainer trainer = regression_trainer();
+  ForestOptions options = ForestTestUtilities::default_honest_options();
+  Forest forest = trainer.train(data, options);
+  uint num_threads = 4;
+
+  for (bool weight_penalty : {false, true}) {
+    ForestPredictor predictor = ll_regression_predictor(
+        num_threads, lambdas, weight_penalty, linear_correction_variables);
+    std::vector<Prediction> predictions = predictor.predict(forest, data, data, false);
+    std::vector<Prediction> oob_predictions = predictor.predict_oob(forest, data, false);
+
+    precompute_ll_regression_moments(forest, data, linear_correction_variables, num_threads);
+    ForestPredictor optimized_predictor = optimized_ll_regression_predictor(
+        num_threads, lambdas, weight_penalty, linear_correction_variables);
+    require_same_ll_predictions(predictions, optimized_predictor.predict(forest, data, data, false));
+    require_same_ll_predictions(oob_predictions, optimized_predictor.predict_oob(forest, data, false));
+  }
+}
+
+TEST_CASE("LLF predictions from precomputed moments keep their precision far from the mean", "[local linear], [forest]") {
+  auto data_vec = load_data("test/forest/resources/friedman.csv");
+  // Move the upper half of the first variable far away, so that every neighborhood is far
+  // from the mean of the variable over the training data.
+  Data original_data(data_vec);
+  for (size_t row = 0; row < original_data.get_num_rows(); row++) {
+    double value = original_data.get(row, 0);
+    if (value > 0.5) {
+      set_data(data_vec, row, 0, value + 1e6);
+    }
+  }
+  Data data(data_vec);
+  data.set_outcome_index(10);
+  std::vector<size_t> linear_correction_variables = {0, 1, 3, 4};
+  std::vector<double> lambdas = {0.01, 0.1, 1};
+
+  ForestTrainer trainer = regression_trainer();
+  Forest forest = trainer.train(data, ForestTestUtilities::default_honest_options());
+  uint num_threads = 4;
+  bool weight_penalty = false;
+
+  ForestPredictor predictor = ll_regression_predictor(
+      num_threads, lambdas, weight_penalty, linear_correction_variables);
+  std::vector<Prediction> predictions = predictor.predict(forest, data, data, false);
+
+  precompute_ll_regression_moments(forest, data, linear_correction_variables, num_threads);
+  ForestPredictor optimized_predictor = optimized_ll_regression_predictor(
+      num_threads, lambdas, weight_penalty, linear_correction_variables);
+  require_same_ll_predictions(predictions, optimized_predictor.predict(forest, data, data, false));
+}
+
+TEST_CASE("LLF causal predictions from precomputed moments match the default predictions", "[local linear], [forest]") {
+  auto data_vec = load_data("test/forest/resources/causal_data_ll.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+  data.set_treatment_index(11);
+  data.set_instrument_index(11);
+  std::vector<size_t> linear_correction_variables = {0, 3};
+  std::vector<double> lambdas = {0.01, 0.1, 1};
+
+  ForestTrainer trainer = instrumental_trainer(0.0, false);
+  ForestOptions options = ForestTestUtilities::default_options();
+  Forest forest = trainer.train(data, options);
+  uint num_threads = 4;
+
+  for (bool weight_penalty : {false, true}) {
+    ForestPredictor predictor = ll_causal_predictor(
+        num_threads, lambdas, weight_penalty, linear_correction_variables);
+    std::vector<Prediction> predictions = predictor.predict(forest, data, data, false);
+    std::vector<Prediction> oob_predictions = predictor.predict_oob(forest, data, false);
+
+    precompute_ll_causal_moments(forest, data, linear_correction_variables, num_threads);
+    ForestPredictor optimized_predictor = optimized_ll_causal_predictor(
+        num_threads, lambdas, weight_penalty, linear_correction_variables);
+    require_same_ll_predictions(predictions, optimized_predictor.predict(forest, data, data, false));
+    require_same_ll_predictions(oob_predictions, optimized_predictor.predict_oob(forest, data, false));
+  }
+}
@@ -0,0 +1,108 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "commons/utility.h"
+#include "forest/ForestPredictor.h"
+#include "forest/ForestPredictors.h"
+#include "forest/ForestTrainer.h"
+#include "forest/ForestTrainers.h"
+#include "utilities/ForestTestUtilities.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+void require_same_or_tied_quantiles(const std::vector<Prediction>& predictions,
+                                    const std::vector<Prediction>& expected_predictions,
+                                    const std::vector<Prediction>& expected_lower_predictions,
+                                    const std::vector<Prediction>& expected_upper_predictions) {
+  for (size_t i = 0; i < predictions.size(); i++) {
+    const std::vector<double>& prediction = predictions[i].get_predictions();
+    const std::vector<double>& expected = expected_predictions[i].get_predictions();
+    for (size_t q = 0; q < prediction.size(); q++) {
+      if (prediction[q] == expected[q]) {
+        continue;
+      }
+      // The cumulative weight reaches the quantile exactly between two outcomes, so the
+      // cutoff depends on how the weights round: it must be one of the two outcomes.
+      double lower = expected_lower_predictions[i].get_predictions()[q];
+      double upper = expected_upper_predictions[i].get_predictions()[q];
+      REQUIRE(lower < upper);
+      REQUIRE((prediction[q] == lower || prediction[q] == upper));
+    }
+  }
+}
+
+void check_optimized_quantile_predictions(const std::string& file_name,
+                                          size_t outcome_index,
+                                          bool use_outcome_grid) {
+  std::vector<double> quantiles({0.1, 0.5, 0.9});
+  double epsilon = 1e-10;
+  std::vector<double> lower_quantiles;
+  std::vector<double> upper_quantiles;
+  for (double quantile : quantiles) {
+    lower_quantiles.push_back(quantile - epsilon);
+    upper_quantiles.push_back(quantile + epsilon);
+  }
+
+  auto data_vec = load_data(file_name);
+  Data data(data_vec);
+  data.set_outcome_index(outcome_index);
+
+  // A grid of every distinct outcome leaves the outcomes unchanged.
+  std::vector<double> outcome_grid;
+  if (use_outcome_grid) {
+    for (size_t row = 0; row < data.get_num_rows(); row++) {
+      outcome_grid.push_back(data.get_outcome(row));
+    }
+    std::sort(outcome_grid.begin(), outcome_grid.end());
+    outcome_grid.erase(std::unique(outcome_grid.begin(), outcome_grid.end()), outcome_grid.end());
+  }
+
+  ForestTrainer trainer = optimized_quantile_trainer(quantiles, outcome_grid);
+  Forest forest = trainer.train(data, ForestTestUtilities::default_options());
+
+  ForestPredictor optimized_predictor = optimized_quantile_predictor(4, quantiles);
+  ForestPredictor predictor = quantile_predictor(4, quantiles);
+  ForestPredictor lower_predictor = quantile_predictor(4, lower_quantiles);
+  ForestPredictor upper_predictor = quantile_predictor(4, upper_quantiles);
+
+  require_same_or_tied_quantiles(optimized_predictor.predict_oob(forest, data, false),
+                                 predictor.predict_oob(forest, data, false),
+                                 lower_predictor.predict_oob(forest, data, false),
+                                 upper_predictor.predict_oob(forest, data, false));
+  require_same_or_tied_quantiles(optimized_predictor.predict(forest, data, data, false),
+                                 predictor.predict(forest, data, data, false),
+                                 lower_predictor.predict(forest, data, data, false),
+                                 upper_predictor.predict(forest, data, data, false));
+}
+
+TEST_CASE("optimized quantile predictions match quantile predictions", "[quantile], [forest]") {
+  check_optimized_quantile_predictions("test/forest/resources/quantile_data.csv", 10, false);
+  check_optimized_quantile_predictions("test/forest/resources/quantile_data.csv", 10, true);
+}
+
+TEST_CASE("optimized quantile predictions of a continuous outcome match quantile predictions", "[quantile], [forest]") {
+  check_optimized_quantile_predictions("test/forest/resources/regression_data.csv", 10, false);
+  check_optimized_quantile_predictions("test/forest/resources/regression_data.csv", 10, true);
+}
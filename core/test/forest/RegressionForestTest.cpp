@@ -17,11 +17,16 @@
   along with grf. If not, see <http://www.gnu.org/licenses/>.
  #-------------------------------------------------------------------------------*/
 
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
 #include "commons/utility.h"
 #include "forest/ForestPredictor.h"
 #include "forest/ForestPredictors.h"
 #include "forest/ForestTrainer.h"
 #include "forest/ForestTrainers.h"
+#include "prediction/RegressionPredictionStrategy.h"
 #include "utilities/ForestTestUtilities.h"
 
 #include "catch.hpp"
@@ -127,3 +132,329 @@ TEST_CASE("regression error estimates are shift invariant", "[regression, forest
 
   REQUIRE(equal_doubles(delta / predictions.size(), 0, 1e-1));
 }
+
+TEST_CASE("regression forests with a bin for every value match exact split search", "[regression, forest]") {
+  // The covariates take at most 201 distinct values.
+  auto data_vec = load_data("test/forest/resources/regression_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  ForestTrainer trainer = regression_trainer();
+  Forest forest = trainer.train(data, ForestTestUtilities::default_options(true, 1, 0));
+  Forest binned_forest = trainer.train(data, ForestTestUtilities::default_options(true, 1, 255));
+
+  ForestPredictor predictor = regression_predictor(4);
+  std::vector<Prediction> predictions = predictor.predict(forest, data, data, false);
+  std::vector<Prediction> binned_predictions = predictor.predict(binned_forest, data, data, false);
+
+  REQUIRE(predictions.size() == binned_predictions.size());
+  for (size_t i = 0; i < predictions.size(); i++) {
+    REQUIRE(predictions[i].get_predictions()[0] == binned_predictions[i].get_predictions()[0]);
+  }
+}
+
+TEST_CASE("binned regression forests give accurate predictions", "[regression, forest]") {
+  auto data_vec = load_data("test/forest/resources/regression_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  ForestTrainer trainer = regression_trainer();
+  Forest forest = trainer.train(data, ForestTestUtilities::default_options(true, 1, 0));
+  Forest binned_forest = trainer.train(data, ForestTestUtilities::default_options(true, 1, 16));
+
+  ForestPredictor predictor = regression_predictor(4);
+  std::vector<Prediction> predictions = predictor.predict_oob(forest, data, false);
+  std::vector<Prediction> binned_predictions = predictor.predict_oob(binned_forest, data, false);
+
+  double mse = 0;
+  double binned_mse = 0;
+  for (size_t i = 0; i < predictions.size(); i++) {
+    double outcome = data.get_outcome(i);
+    mse += std::pow(predictions[i].get_predictions()[0] - outcome, 2);
+    binned_mse += std::pow(binned_predictions[i].get_predictions()[0] - outcome, 2);
+  }
+
+  REQUIRE(binned_mse / mse < 1.1);
+}
+
+TEST_CASE("single precision regression forests match double precision forests", "[regression, forest]") {
+  auto data_vec = load_data("test/forest/resources/regression_data.csv");
+  // Double precision data holding exactly the covariate values that single precision storage
+  // rounds to. The outcome (column 10) is not rounded.
+  auto rounded_data_vec = data_vec;
+  size_t num_rows = data_vec.second.at(0);
+  for (size_t i = 0; i < 10 * num_rows; i++) {
+    rounded_data_vec.first[i] = static_cast<float>(rounded_data_vec.first[i]);
+  }
+  Data data(rounded_data_vec);
+  data.set_outcome_index(10);
+  Data float_data(data_vec);
+  float_data.set_outcome_index(10);
+  float_data.set_single_precision(true);
+
+  ForestTrainer trainer = regression_trainer();
+  ForestOptions options = ForestTestUtilities::default_options();
+  Forest forest = trainer.train(data, options);
+  Forest float_forest = trainer.train(float_data, options);
+
+  ForestPredictor predictor = regression_predictor(4);
+  std::vector<Prediction> predictions = predictor.predict_oob(forest, data, false);
+  std::vector<Prediction> float_predictions = predictor.predict_oob(float_forest, float_data, false);
+
+  REQUIRE(!forest.is_single_precision());
+  REQUIRE(float_forest.is_single_precision());
+  REQUIRE_THROWS_AS(predictor.predict_oob(float_forest, data, false), std::runtime_error);
+  REQUIRE(predictions.size() == float_predictions.size());
+  for (size_t i = 0; i < predictions.size(); i++) {
+    REQUIRE(predictions[i].get_predictions()[0] == float_predictions[i].get_predictions()[0]);
+  }
+
+  // The training data is not passed down the trees, so it can stay double precision.
+  Data train_data(data_vec);
+  train_data.set_outcome_index(10);
+  std::vector<Prediction> test_predictions = predictor.predict(float_forest, train_data, float_data, false);
+  std::vector<Prediction> float_test_predictions = predictor.predict(float_forest, float_data, float_data, false);
+  for (size_t i = 0; i < test_predictions.size(); i++) {
+    REQUIRE(test_predictions[i].get_predictions()[0] == float_test_predictions[i].get_predictions()[0]);
+  }
+}
+
+TEST_CASE("regression forests on single precision arrays match double precision forests", "[regression, forest]") {
+  auto data_vec = load_data("test/forest/resources/regression_data.csv");
+  size_t num_rows = data_vec.second.at(0);
+  size_t num_cols = data_vec.second.at(1);
+  std::vector<float> float_vec(data_vec.first.begin(), data_vec.first.end());
+  // Double precision data holding exactly the values of the single precision array.
+  std::vector<double> rounded_vec(float_vec.begin(), float_vec.end());
+  Data data(rounded_vec, num_rows, num_cols);
+  data.set_outcome_index(10);
+  Data float_data(float_vec, num_rows, num_cols);
+  float_data.set_outcome_index(10);
+
+  ForestTrainer trainer = regression_trainer();
+  ForestOptions options = ForestTestUtilities::default_options();
+  Forest forest = trainer.train(data, options);
+  Forest float_forest = trainer.train(float_data, options);
+
+  ForestPredictor predictor = regression_predictor(4);
+  std::vector<Prediction> predictions = predictor.predict_oob(forest, data, false);
+  std::vector<Prediction> float_predictions = predictor.predict_oob(float_forest, float_data, false);
+
+  REQUIRE(float_forest.is_single_precision());
+  REQUIRE(predictions.size() == float_predictions.size());
+  for (size_t i = 0; i < predictions.size(); i++) {
+    REQUIRE(predictions[i].get_predictions()[0] == float_predictions[i].get_predictions()[0]);
+  }
+}
+
+TEST_CASE("single precision regression forests give accurate predictions", "[regression, forest]") {
+  auto data_vec = load_data("test/forest/resources/regression_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+  Data float_data(data_vec);
+  float_data.set_outcome_index(10);
+  float_data.set_single_precision(true);
+
+  // Rounding can break near-ties between splits differently, so the trees are not identical.
+  ForestTrainer trainer = regression_trainer();
+  Forest forest = trainer.train(data, ForestTestUtilities::default_options());
+  Forest float_forest = trainer.train(float_data, ForestTestUtilities::default_options());
+
+  ForestPredictor predictor = regression_predictor(4);
+  std::vector<Prediction> predictions = predictor.predict_oob(forest, data, false);
+  std::vector<Prediction> float_predictions = predictor.predict_oob(float_forest, float_data, false);
+
+  double mse = 0;
+  double float_mse = 0;
+  for (size_t i = 0; i < predictions.size(); i++) {
+    double outcome = data.get_outcome(i);
+    mse += std::pow(predictions[i].get_predictions()[0] - outcome, 2);
+    float_mse += std::pow(float_predictions[i].get_predictions()[0] - outcome, 2);
+  }
+
+  REQUIRE(std::abs(float_mse / mse - 1) < 0.05);
+}
+
+TEST_CASE("single precision regression forests can have the outcome in the first column", "[regression, forest]") {
+  auto data_vec = load_data("test/forest/resources/regression_data.csv");
+  size_t num_rows = data_vec.second.at(0);
+  size_t num_cols = data_vec.second.at(1);
+  // Move the outcome (column 10) to column 0, which then has no single precision copy.
+  std::vector<double> outcome_first(data_vec.first.begin() + 10 * num_rows,
+                                    data_vec.first.begin() + 11 * num_rows);
+  outcome_first.insert(outcome_first.end(), data_vec.first.begin(), data_vec.first.begin() + 10 * num_rows);
+  Data data(outcome_first, num_rows, num_cols);
+  data.set_outcome_index(0);
+  data.set_single_precision(true);
+
+  ForestTrainer trainer = regression_trainer();
+  Forest forest = trainer.train(data, ForestTestUtilities::default_options());
+
+  ForestPredictor predictor = regression_predictor(4);
+  std::vector<Prediction> oob_predictions = predictor.predict_oob(forest, data, false);
+  std::vector<Prediction> predictions = predictor.predict(forest, data, data, false);
+
+  REQUIRE(oob_predictions.size() == num_rows);
+  REQUIRE(predictions.size() == num_rows);
+  for (size_t i = 0; i < num_rows; i++) {
+    REQUIRE(std::isfinite(predictions[i].get_predictions()[0]));
+  }
+}
+
+TEST_CASE("regression forests with unit sample weights match unweighted forests", "[regression, forest]") {
+  auto data_vec = load_data("test/forest/resources/regression_data.csv");
+  size_t num_rows = data_vec.second[0];
+  size_t num_cols = data_vec.second[1];
+  // Append a column of unit sample weights.
+  auto weighted_data_vec = data_vec;
+  weighted_data_vec.first.resize(num_rows * (num_cols + 1), 1.0);
+  weighted_data_vec.second[1] = num_cols + 1;
+  Data data(data_vec);
+  data.set_outcome_index(10);
+  Data weighted_data(weighted_data_vec);
+  weighted_data.set_outcome_index(10);
+  weighted_data.set_weight_index(num_cols);
+
+  ForestTrainer trainer = regression_trainer();
+  ForestOptions options = ForestTestUtilities::default_options();
+  Forest forest = trainer.train(data, options);
+  Forest weighted_forest = trainer.train(weighted_data, options);
+
+  ForestPredictor predictor = regression_predictor(4);
+  std::vector<Prediction> predictions = predictor.predict_oob(forest, data, false);
+  std::vector<Prediction> weighted_predictions = predictor.predict_oob(weighted_forest, weighted_data, false);
+
+  REQUIRE(predictions.size() == weighted_predictions.size());
+  for (size_t i = 0; i < predictions.size(); i++) {
+    REQUIRE(predictions[i].get_predictions()[0] == weighted_predictions[i].get_predictions()[0]);
+  }
+}
+
+TEST_CASE("regression forests do not depend on the number of threads", "[regression, forest]") {
+  auto data_vec = load_data("test/forest/resources/regression_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  ForestTrainer trainer = regression_trainer();
+  std::vector<size_t> empty_clusters;
+  ForestOptions options(50, 2, 0.35, 3, 1, true, 0.5, true, 0.0, 0.0, 1, 42, false, empty_clusters, 0, 0);
+  ForestOptions threaded_options(50, 2, 0.35, 3, 1, true, 0.5, true, 0.0, 0.0, 4, 42, false, empty_clusters, 0, 0);
+  Forest forest = trainer.train(data, options);
+  Forest threaded_forest = trainer.train(data, threaded_options);
+
+  std::vector<Prediction> predictions = regression_predictor(1).predict_oob(forest, data, true);
+  std::vector<Prediction> threaded_predictions = regression_predictor(4).predict_oob(threaded_forest, data, true);
+
+  REQUIRE(predictions.size() == threaded_predictions.size());
+  for (size_t i = 0; i < predictions.size(); i++) {
+    REQUIRE(predictions[i].get_predictions()[0] == threaded_predictions[i].get_predictions()[0]);
+    REQUIRE(predictions[i].get_variance_estimates()[0] == threaded_predictions[i].get_variance_estimates()[0]);
+  }
+}
+
+TEST_CASE("regression predictions do not depend on the other samples predicted", "[regression, forest]") {
+  auto data_vec = load_data("test/forest/resources/regression_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+  size_t num_rows = data.get_num_rows();
+  size_t num_cols = data.get_num_cols();
+
+  ForestTrainer trainer = regression_trainer();
+  Forest forest = trainer.train(data, ForestTestUtilities::default_options());
+  ForestPredictor predictor = regression_predictor(4);
+  std::vector<Prediction> predictions = predictor.predict(forest, data, data, false);
+  REQUIRE(predictions.size() == num_rows);
+
+  for (size_t row = 0; row < num_rows; row += 37) {
+    std::vector<double> row_vec(num_cols);
+    for (size_t col = 0; col < num_cols; col++) {
+      row_vec[col] = data.get(row, col);
+    }
+    Data row_data(row_vec, 1, num_cols);
+    std::vector<Prediction> row_predictions = predictor.predict(forest, data, row_data, false);
+    REQUIRE(row_predictions[0].get_predictions()[0] == predictions[row].get_predictions()[0]);
+  }
+}
+
+TEST_CASE("out-of-bag regression predictions average the trees that did not draw each sample", "[regression, forest]") {
+  auto data_vec = load_data("test/forest/resources/regression_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+  size_t num_rows = data.get_num_rows();
+
+  Forest forest = regression_trainer().train(data, ForestTestUtilities::default_options());
+  std::vector<Prediction> predictions = regression_predictor(4).predict_oob(forest, data, false);
+  REQUIRE(predictions.size() == num_rows);
+
+  std::vector<double> outcome_sums(num_rows, 0.0);
+  std::vector<double> weight_sums(num_rows, 0.0);
+  std::vector<bool> all_samples(num_rows, true);
+  for (const std::unique_ptr<Tree>& tree : forest.get_trees()) {
+    const std::vector<size_t>& drawn_samples = tree->get_drawn_samples();
+    const PredictionValues& prediction_values = tree->get_prediction_values();
+    std::vector<size_t> leaf_nodes = tree->find_leaf_nodes(data, all_samples);
+    for (size_t sample = 0; sample < num_rows; sample++) {
+      size_t node = leaf_nodes[sample];
+      if (std::binary_search(drawn_samples.begin(), drawn_samples.end(), sample) || prediction_values.empty(node)) {
+        continue;
+      }
+      outcome_sums[sample] += prediction_values.get(node, 0);
+      weight_sums[sample] += prediction_values.get(node, 1);
+    }
+  }
+
+  for (size_t sample = 0; sample < num_rows; sample++) {
+    REQUIRE(predictions[sample].get_predictions()[0] == Approx(outcome_sums[sample] / weight_sums[sample]));
+  }
+}
+
+TEST_CASE("regression variance and error estimates match the estimates from every tree's leaf values", "[regression, forest]") {
+  auto data_vec = load_data("test/forest/resources/regression_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+  size_t num_rows = data.get_num_rows();
+  size_t ci_group_size = 2;
+
+  Forest forest = regression_trainer().train(data, ForestTestUtilities::default_options(false, ci_group_size));
+  std::vector<Prediction> predictions = regression_predictor(4).predict_oob(forest, data, true);
+  size_t num_trees = forest.get_trees().size();
+
+  std::vector<PredictionValues> leaf_values(num_rows, PredictionValues(num_trees, 2));
+  std::vector<bool> all_samples(num_rows, true);
+  for (size_t tree_index = 0; tree_index < num_trees; tree_index++) {
+    const std::unique_ptr<Tree>& tree = forest.get_trees()[tree_index];
+    const std::vector<size_t>& drawn_samples = tree->get_drawn_samples();
+    const PredictionValues& prediction_values = tree->get_prediction_values();
+    std::vector<size_t> leaf_nodes = tree->find_leaf_nodes(data, all_samples);
+    for (size_t sample = 0; sample < num_rows; sample++) {
+      size_t node = leaf_nodes[sample];
+      if (std::binary_search(drawn_samples.begin(), drawn_samples.end(), sample) || prediction_values.empty(node)) {
+        continue;
+      }
+      double* values = leaf_values[sample].initialize_values(tree_index);
+      values[0] = prediction_values.get(node, 0);
+      values[1] = prediction_values.get(node, 1);
+    }
+  }
+
+  RegressionPredictionStrategy strategy;
+  for (size_t sample = 0; sample < num_rows; sample++) {
+    std::vector<double> average(2, 0.0);
+    size_t num_leaves = 0;
+    for (size_t tree_index = 0; tree_index < num_trees; tree_index++) {
+      if (!leaf_values[sample].empty(tree_index)) {
+        average[0] += leaf_values[sample].get(tree_index, 0);
+        average[1] += leaf_values[sample].get(tree_index, 1);
+        num_leaves++;
+      }
+    }
+    average[0] /= num_leaves;
+    average[1] /= num_leaves;
+
+    double variance = strategy.compute_variance(average, leaf_values[sample], ci_group_size)[0];
+    std::pair<double, double> error = strategy.compute_error(sample, average, leaf_values[sample], data)[0];
+    REQUIRE(equal_doubles(predictions[sample].get_variance_estimates()[0], variance, 1e-10));
+    REQUIRE(equal_doubles(predictions[sample].get_error_estimates()[0], error.first, 1e-10));
+    REQUIRE(equal_doubles(predictions[sample].get_excess_error_estimates()[0], error.second, 1e-10));
+  }
+}
@@ -0,0 +1,137 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+#include "commons/utility.h"
+#include "forest/ForestPredictors.h"
+#include "forest/ForestTrainers.h"
+#include "utilities/ForestTestUtilities.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+TEST_CASE("row predictions match forest predictions", "[regression, forest]") {
+  auto data_vec = load_data("test/forest/resources/regression_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+  size_t num_rows = data.get_num_rows();
+  size_t num_cols = data.get_num_cols();
+  // Make some covariates missing so that rows are sent down both missing value directions.
+  for (size_t row = 0; row < num_rows; row += 11) {
+    set_data(data_vec, row, row % 10, NAN);
+  }
+
+  Forest forest = regression_trainer().train(data, ForestTestUtilities::default_options());
+  std::vector<Prediction> expected = regression_predictor(4).predict(forest, data, data, false);
+  RowPredictor predictor = regression_row_predictor();
+  REQUIRE(predictor.prediction_length() == 1);
+
+  SECTION("one row at a time") {
+    std::vector<double> row_vec(num_cols);
+    for (size_t row = 0; row < num_rows; row++) {
+      for (size_t col = 0; col < num_cols; col++) {
+        row_vec[col] = data.get(row, col);
+      }
+      Data row_data(row_vec, 1, num_cols);
+      double prediction;
+      predictor.predict_row(forest, row_data, 0, &prediction);
+      REQUIRE(prediction == expected[row].get_predictions()[0]);
+    }
+  }
+
+  SECTION("small batches") {
+    size_t batch_size = 7;
+    std::vector<double> predictions(batch_size);
+    for (size_t start = 0; start + batch_size <= num_rows; start += batch_size) {
+      predictor.predict_small_batch(forest, data, start, batch_size, predictions.data());
+      for (size_t i = 0; i < batch_size; i++) {
+        REQUIRE(predictions[i] == expected[start + i].get_predictions()[0]);
+      }
+    }
+  }
+}
+
+TEST_CASE("row predictions of multi regression forests match forest predictions", "[regression, forest]") {
+  auto data_vec = load_data("test/forest/resources/regression_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index({9, 10});
+  size_t num_rows = data.get_num_rows();
+
+  Forest forest = multi_regression_trainer(2).train(data, ForestTestUtilities::default_options());
+  std::vector<Prediction> expected = multi_regression_predictor(4, 2).predict(forest, data, data, false);
+  RowPredictor predictor = multi_regression_row_predictor(2);
+
+  std::vector<double> predictions(2 * num_rows);
+  predictor.predict_small_batch(forest, data, 0, num_rows, predictions.data());
+  for (size_t row = 0; row < num_rows; row++) {
+    REQUIRE(predictions[2 * row] == expected[row].get_predictions()[0]);
+    REQUIRE(predictions[2 * row + 1] == expected[row].get_predictions()[1]);
+  }
+}
+
+TEST_CASE("benchmark single row prediction latency", "[.benchmark]") {
+  auto data_vec = load_data("test/forest/resources/regression_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+  size_t num_rows = data.get_num_rows();
+  size_t num_cols = data.get_num_cols();
+
+  ForestOptions options = ForestTestUtilities::default_options();
+  Forest forest = regression_trainer().train(data, options);
+  size_t num_trees = forest.get_trees().size();
+  ForestPredictor forest_predictor = regression_predictor(1);
+  RowPredictor row_predictor = regression_row_predictor();
+
+  size_t num_repetitions = 10000;
+  std::vector<double> row_vec(num_cols);
+  std::vector<double> forest_latencies;
+  std::vector<double> row_latencies;
+  for (size_t rep = 0; rep < num_repetitions; rep++) {
+    size_t row = rep % num_rows;
+    for (size_t col = 0; col < num_cols; col++) {
+      row_vec[col] = data.get(row, col);
+    }
+    Data row_data(row_vec, 1, num_cols);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<Prediction> forest_prediction = forest_predictor.predict(forest, data, row_data, false);
+    auto middle = std::chrono::steady_clock::now();
+    double row_prediction;
+    row_predictor.predict_row(forest, row_data, 0, &row_prediction);
+    auto end = std::chrono::steady_clock::now();
+
+    REQUIRE(row_prediction == forest_prediction[0].get_predictions()[0]);
+    forest_latencies.push_back(std::chrono::duration<double, std::micro>(middle - start).count());
+    row_latencies.push_back(std::chrono::duration<double, std::micro>(end - middle).count());
+  }
+
+  std::sort(forest_latencies.begin(), forest_latencies.end());
+  std::sort(row_latencies.begin(), row_latencies.end());
+  size_t p50 = num_repetitions / 2;
+  size_t p99 = num_repetitions * 99 / 100;
+  WARN("ForestPredictor::predict on " << num_trees << " trees: p50 " << forest_latencies[p50]
+       << " us, p99 " << forest_latencies[p99] << " us");
+  WARN("RowPredictor::predict_row on " << num_trees << " trees: p50 " << row_latencies[p50]
+       << " us, p99 " << row_latencies[p99] << " us");
+}
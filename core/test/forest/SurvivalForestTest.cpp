@@ -0,0 +1,108 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "commons/utility.h"
+#include "forest/ForestPredictor.h"
+#include "forest/ForestPredictors.h"
+#include "forest/ForestTrainer.h"
+#include "forest/ForestTrainers.h"
+#include "forest/RowPredictor.h"
+#include "prediction/OptimizedSurvivalPredictionStrategy.h"
+#include "prediction/SurvivalPredictionStrategy.h"
+#include "utilities/ForestTestUtilities.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+void require_close_predictions(const std::vector<Prediction>& predictions,
+                              const std::vector<Prediction>& expected_predictions) {
+  REQUIRE(predictions.size() == expected_predictions.size());
+  for (size_t i = 0; i < predictions.size(); i++) {
+    const std::vector<double>& prediction = predictions[i].get_predictions();
+    const std::vector<double>& expected = expected_predictions[i].get_predictions();
+    REQUIRE(prediction.size() == expected.size());
+    for (size_t j = 0; j < prediction.size(); j++) {
+      if (std::isnan(expected[j])) {
+        REQUIRE(std::isnan(prediction[j]));
+      } else {
+        REQUIRE(equal_doubles(prediction[j], expected[j], 1e-10));
+      }
+    }
+  }
+}
+
+void check_optimized_survival_predictions(const std::string& file_name) {
+  size_t num_failures = 149;
+  auto data_vec = load_data(file_name);
+  Data data(data_vec);
+  data.set_outcome_index(5);
+  data.set_censor_index(6);
+
+  bool fast_logrank = false;
+  ForestTrainer trainer = optimized_survival_trainer(fast_logrank, num_failures);
+  Forest forest = trainer.train(data, ForestTestUtilities::default_options());
+  REQUIRE(forest.has_sparse_prediction_values());
+
+  for (int prediction_type : {SurvivalPredictionStrategy::KAPLAN_MEIER, SurvivalPredictionStrategy::NELSON_AALEN}) {
+    ForestPredictor predictor = survival_predictor(4, num_failures, prediction_type);
+    ForestPredictor optimized_predictor = optimized_survival_predictor(4, num_failures, prediction_type);
+
+    require_close_predictions(optimized_predictor.predict_oob(forest, data, false),
+                             predictor.predict_oob(forest, data, false));
+    require_close_predictions(optimized_predictor.predict(forest, data, data, false),
+                             predictor.predict(forest, data, data, false));
+  }
+}
+
+TEST_CASE("optimized survival predictions match survival predictions", "[survival], [forest]") {
+  check_optimized_survival_predictions("test/forest/resources/survival_data.csv");
+}
+
+TEST_CASE("optimized survival predictions with NaNs match survival predictions", "[NaN], [survival], [forest]") {
+  check_optimized_survival_predictions("test/forest/resources/survival_data_MIA.csv");
+}
+
+TEST_CASE("optimized survival predictions require a forest with sparse prediction values", "[survival], [forest]") {
+  size_t num_failures = 149;
+  auto data_vec = load_data("test/forest/resources/survival_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(5);
+  data.set_censor_index(6);
+
+  bool fast_logrank = false;
+  ForestTrainer trainer = survival_trainer(fast_logrank);
+  Forest forest = trainer.train(data, ForestTestUtilities::default_options());
+  REQUIRE(!forest.has_sparse_prediction_values());
+
+  int prediction_type = SurvivalPredictionStrategy::KAPLAN_MEIER;
+  ForestPredictor predictor = optimized_survival_predictor(4, num_failures, prediction_type);
+  REQUIRE_THROWS_AS(predictor.predict_oob(forest, data, false), std::runtime_error);
+
+  RowPredictor row_predictor(std::unique_ptr<OptimizedPredictionStrategy>(
+    new OptimizedSurvivalPredictionStrategy(num_failures, prediction_type)));
+  std::vector<double> predictions(num_failures);
+  REQUIRE_THROWS_AS(row_predictor.predict_row(forest, data, 0, predictions.data()), std::runtime_error);
+}
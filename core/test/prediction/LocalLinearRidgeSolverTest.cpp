@@ -0,0 +1,110 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <vector>
+
+#include "Eigen/Dense"
+#include "commons/utility.h"
+#include "prediction/LocalLinearRidgeSolver.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+Eigen::MatrixXd penalized_gram_matrix(const Eigen::MatrixXd& M,
+                                      const std::vector<size_t>& penalized,
+                                      bool weight_penalty,
+                                      double lambda) {
+  Eigen::MatrixXd M_penalized = M;
+  double normalization = M.trace() / M.rows();
+  for (size_t j : penalized) {
+    M_penalized(j, j) += lambda * (weight_penalty ? M(j, j) : normalization);
+  }
+  return M_penalized;
+}
+
+void check_ridge_solutions(const Eigen::MatrixXd& M,
+                           const std::vector<size_t>& penalized,
+                           size_t index) {
+  Eigen::MatrixXd rhs = Eigen::MatrixXd::Zero(M.rows(), 2);
+  for (Eigen::Index j = 0; j < M.rows(); ++j) {
+    rhs(j, 0) = 0.5 * j - 1.0;
+  }
+  rhs(index, 1) = 1.0;
+  std::vector<double> lambdas = {0, 0.001, 0.01, 0.03, 0.1, 0.3, 1, 10, 100};
+
+  for (bool weight_penalty : {false, true}) {
+    LocalLinearRidgeSolver solver(M, penalized, weight_penalty);
+    std::vector<double> path = solver.solve_path(lambdas, rhs.col(0), index);
+    REQUIRE(path.size() == lambdas.size());
+
+    for (size_t i = 0; i < lambdas.size(); ++i) {
+      Eigen::MatrixXd expected = penalized_gram_matrix(M, penalized, weight_penalty, lambdas[i]).ldlt().solve(rhs);
+      Eigen::MatrixXd actual = solver.solve(lambdas[i], rhs);
+      REQUIRE(equal_doubles(expected(index, 0), path[i], 1e-8));
+      for (Eigen::Index j = 0; j < M.rows(); ++j) {
+        REQUIRE(equal_doubles(expected(j, 0), actual(j, 0), 1e-8));
+        REQUIRE(equal_doubles(expected(j, 1), actual(j, 1), 1e-8));
+      }
+    }
+  }
+}
+
+Eigen::MatrixXd random_gram_matrix(size_t num_samples, size_t dim) {
+  Eigen::MatrixXd X = Eigen::MatrixXd::Random(num_samples, dim);
+  X.col(0).setOnes();
+  Eigen::VectorXd weights = Eigen::VectorXd::Random(num_samples).cwiseAbs() / num_samples;
+  return X.transpose() * weights.asDiagonal() * X;
+}
+
+TEST_CASE("local linear ridge solutions match direct solves", "[local linear], [prediction]") {
+  Eigen::MatrixXd M = random_gram_matrix(50, 5);
+  check_ridge_solutions(M, {1, 2, 3, 4}, 0);
+}
+
+TEST_CASE("local linear ridge solutions match direct solves with an unpenalized treatment", "[local linear], [prediction]") {
+  Eigen::MatrixXd M = random_gram_matrix(50, 6);
+  check_ridge_solutions(M, {1, 2, 4, 5}, 3);
+}
+
+TEST_CASE("local linear ridge solutions match direct solves for a penalized coefficient", "[local linear], [prediction]") {
+  Eigen::MatrixXd M = random_gram_matrix(50, 5);
+  check_ridge_solutions(M, {1, 2, 3, 4}, 2);
+}
+
+TEST_CASE("local linear ridge solutions match direct solves for singular regressors", "[local linear], [prediction]") {
+  // The last regressor is constant, so the Gram matrix is singular without a penalty,
+  // and the covariance penalty of that regressor is zero.
+  Eigen::MatrixXd X = Eigen::MatrixXd::Random(20, 4);
+  X.col(0).setOnes();
+  X.col(3).setZero();
+  Eigen::MatrixXd M = X.transpose() * X / 20;
+  Eigen::VectorXd rhs = Eigen::VectorXd::Ones(4);
+  std::vector<size_t> penalized = {1, 2, 3};
+  std::vector<double> lambdas = {0, 0.001, 0.01, 0.03, 0.1, 0.3, 1, 10, 100};
+
+  for (bool weight_penalty : {false, true}) {
+    LocalLinearRidgeSolver solver(M, penalized, weight_penalty);
+    std::vector<double> path = solver.solve_path(lambdas, rhs, 0);
+    for (size_t i = 0; i < lambdas.size(); ++i) {
+      Eigen::MatrixXd expected = penalized_gram_matrix(M, penalized, weight_penalty, lambdas[i]).ldlt().solve(rhs);
+      REQUIRE(equal_doubles(expected(0), path[i], 1e-8));
+    }
+  }
+}
@@ -57,8 +57,8 @@ TEST_CASE("multi causal predictions with one treatment is identical to causal fo
     if (prediction_values.empty(i)) {
       REQUIRE(multi_prediction_values.empty(i));
     } else {
-      std::vector<double> prediction = prediction_strategy.predict(prediction_values.get_values(i));
-      std::vector<double> prediction_multi = multi_prediction_strategy.predict(multi_prediction_values.get_values(i));
+      std::vector<double> prediction = prediction_strategy.predict(prediction_values.get_all_values()[i]);
+      std::vector<double> prediction_multi = multi_prediction_strategy.predict(multi_prediction_values.get_all_values()[i]);
       REQUIRE(prediction.size() == prediction_multi.size());
       REQUIRE(equal_doubles(prediction[0], prediction_multi[0], 1e-5));
     }
@@ -97,8 +97,8 @@ TEST_CASE("multi causal predictions with one continuous treatment is identical t
     if (prediction_values.empty(i)) {
       REQUIRE(multi_prediction_values.empty(i));
     } else {
-      std::vector<double> prediction = prediction_strategy.predict(prediction_values.get_values(i));
-      std::vector<double> prediction_multi = multi_prediction_strategy.predict(multi_prediction_values.get_values(i));
+      std::vector<double> prediction = prediction_strategy.predict(prediction_values.get_all_values()[i]);
+      std::vector<double> prediction_multi = multi_prediction_strategy.predict(multi_prediction_values.get_all_values()[i]);
       REQUIRE(prediction.size() == prediction_multi.size());
       REQUIRE(equal_doubles(prediction[0], prediction_multi[0], 1e-5));
     }
@@ -144,8 +144,8 @@ TEST_CASE("multi causal predictions with one continuous treatment and sample wei
     if (prediction_values.empty(i)) {
       REQUIRE(multi_prediction_values.empty(i));
     } else {
-      std::vector<double> prediction = prediction_strategy.predict(prediction_values.get_values(i));
-      std::vector<double> prediction_multi = multi_prediction_strategy.predict(multi_prediction_values.get_values(i));
+      std::vector<double> prediction = prediction_strategy.predict(prediction_values.get_all_values()[i]);
+      std::vector<double> prediction_multi = multi_prediction_strategy.predict(multi_prediction_values.get_all_values()[i]);
       REQUIRE(prediction.size() == prediction_multi.size());
       if (std::isinf(prediction[0]) && std::isinf(prediction_multi[0])) {
         continue;
@@ -186,8 +186,8 @@ TEST_CASE("multi causal variance estimates with one continuous treatment is iden
     if (prediction_values.empty(i)) {
       REQUIRE(multi_prediction_values.empty(i));
     } else {
-      std::vector<double> prediction = prediction_strategy.compute_variance(prediction_values.get_values(i), prediction_values, 2);
-      std::vector<double> prediction_multi = multi_prediction_strategy.compute_variance(multi_prediction_values.get_values(i), multi_prediction_values, 2);
+      std::vector<double> prediction = prediction_strategy.compute_variance(prediction_values.get_all_values()[i], prediction_values, 2);
+      std::vector<double> prediction_multi = multi_prediction_strategy.compute_variance(multi_prediction_values.get_all_values()[i], multi_prediction_values, 2);
       REQUIRE(prediction.size() == prediction_multi.size());
       REQUIRE(equal_doubles(prediction[0], prediction_multi[0], 1e-5));
     }
@@ -232,8 +232,8 @@ TEST_CASE("sample weighted multi causal variance estimates with one continuous t
     if (prediction_values.empty(i)) {
       REQUIRE(multi_prediction_values.empty(i));
     } else {
-      std::vector<double> prediction = prediction_strategy.compute_variance(prediction_values.get_values(i), prediction_values, 2);
-      std::vector<double> prediction_multi = multi_prediction_strategy.compute_variance(multi_prediction_values.get_values(i), multi_prediction_values, 2);
+      std::vector<double> prediction = prediction_strategy.compute_variance(prediction_values.get_all_values()[i], prediction_values, 2);
+      std::vector<double> prediction_multi = multi_prediction_strategy.compute_variance(multi_prediction_values.get_all_values()[i], multi_prediction_values, 2);
       REQUIRE(prediction.size() == prediction_multi.size());
       REQUIRE(equal_doubles(prediction[0], prediction_multi[0], 1e-5));
     }
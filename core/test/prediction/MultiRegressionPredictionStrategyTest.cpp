@@ -52,8 +52,8 @@ TEST_CASE("multi regression predictions with one outcome is identical to regress
     if (reg_prediction_values.empty(i)) {
       REQUIRE(multi_reg_prediction_values.empty(i));
     } else {
-      std::vector<double> prediction = prediction_strategy.predict(reg_prediction_values.get_values(i));
-      std::vector<double> prediction_multi = multi_prediction_strategy.predict(multi_reg_prediction_values.get_values(i));
+      std::vector<double> prediction = prediction_strategy.predict(reg_prediction_values.get_all_values()[i]);
+      std::vector<double> prediction_multi = multi_prediction_strategy.predict(multi_reg_prediction_values.get_all_values()[i]);
       REQUIRE(prediction.size() == prediction_multi.size());
       REQUIRE(equal_doubles(prediction[0], prediction_multi[0], 1e-10));
     }
@@ -0,0 +1,76 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <stdexcept>
+#include <vector>
+
+#include "prediction/PredictionValues.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+TEST_CASE("prediction values keep the values of non-empty nodes", "[prediction]") {
+  std::vector<std::vector<double>> values = {{}, {1.5, 2.0}, {}, {-3.0, 4.25}};
+  PredictionValues prediction_values(values, 2);
+
+  REQUIRE(prediction_values.get_num_nodes() == 4);
+  REQUIRE(prediction_values.get_num_types() == 2);
+  REQUIRE(prediction_values.empty(0));
+  REQUIRE(!prediction_values.empty(1));
+  REQUIRE(prediction_values.empty(2));
+  REQUIRE(prediction_values.get(1, 1) == 2.0);
+  REQUIRE(prediction_values.get(3, 0) == -3.0);
+  REQUIRE(prediction_values.get_values(3)[1] == 4.25);
+  REQUIRE(prediction_values.get_all_values() == values);
+}
+
+TEST_CASE("prediction values can be filled in node by node", "[prediction]") {
+  PredictionValues prediction_values(3, 2);
+  REQUIRE(prediction_values.empty(0));
+  REQUIRE(prediction_values.empty(2));
+
+  double* node_values = prediction_values.initialize_values(2);
+  REQUIRE(node_values[0] == 0.0);
+  node_values[1] = 7.0;
+
+  REQUIRE(!prediction_values.empty(2));
+  REQUIRE(prediction_values.get(2, 1) == 7.0);
+  REQUIRE(prediction_values.get_all_values() == std::vector<std::vector<double>>({{}, {}, {0.0, 7.0}}));
+}
+
+TEST_CASE("cleared prediction values can be filled in again", "[prediction]") {
+  PredictionValues prediction_values(2, 2);
+  prediction_values.initialize_values(0)[0] = 3.0;
+  prediction_values.initialize_values(1)[1] = 5.0;
+
+  prediction_values.clear();
+  REQUIRE(prediction_values.empty(0));
+  REQUIRE(prediction_values.empty(1));
+
+  double* node_values = prediction_values.initialize_values(1);
+  REQUIRE(node_values[0] == 0.0);
+  REQUIRE(node_values[1] == 0.0);
+  REQUIRE(prediction_values.empty(0));
+}
+
+TEST_CASE("prediction values of the wrong length are rejected", "[prediction]") {
+  std::vector<std::vector<double>> values = {{1.0, 2.0}, {3.0}};
+  REQUIRE_THROWS_AS(PredictionValues(values, 2), std::runtime_error);
+}
@@ -17,7 +17,11 @@
   along with grf. If not, see <http://www.gnu.org/licenses/>.
  #-------------------------------------------------------------------------------*/
 
+#include <algorithm>
+#include <stdexcept>
+
 #include "prediction/DefaultPredictionStrategy.h"
+#include "prediction/OptimizedQuantilePredictionStrategy.h"
 #include "prediction/QuantilePredictionStrategy.h"
 
 
@@ -26,7 +30,7 @@
 using namespace grf;
 
 TEST_CASE("simple quantile prediction", "[quantile, prediction]") {
-  std::unordered_map<size_t, double> weights_by_sample = {
+  std::vector<std::pair<size_t, double>> weights_by_sample = {
       {0, 0.0}, {1, 0.1}, {2, 0.2}, {3, 0.1}, {4, 0.1},
       {5, 0.1}, {6, 0.2}, {7, 0.1}, {8, 0.0}, {9, 0.1}};
 
@@ -43,7 +47,7 @@ TEST_CASE("simple quantile prediction", "[quantile, prediction]") {
 }
 
 TEST_CASE("prediction with skewed quantiles", "[quantile, prediction]") {
-  std::unordered_map<size_t, double> weights_by_sample = {
+  std::vector<std::pair<size_t, double>> weights_by_sample = {
       {0, 0.0}, {1, 0.1}, {2, 0.2}, {3, 0.1}, {4, 0.1},
       {5, 0.1}, {6, 0.2}, {7, 0.1}, {8, 0.0}, {9, 0.1}};
 
@@ -63,7 +67,7 @@ TEST_CASE("prediction with skewed quantiles", "[quantile, prediction]") {
 }
 
 TEST_CASE("prediction with repeated quantiles", "[quantile, prediction]") {
-  std::unordered_map<size_t, double> weights_by_sample = {
+  std::vector<std::pair<size_t, double>> weights_by_sample = {
       {0, 0.0}, {1, 0.1}, {2, 0.2}, {3, 0.1}, {4, 0.1},
       {5, 0.1}, {6, 0.2}, {7, 0.1}, {8, 0.0}, {9, 0.1}};
 
@@ -84,3 +88,70 @@ TEST_CASE("prediction with repeated quantiles", "[quantile, prediction]") {
     REQUIRE(prediction == first_predictions[0]);
   }
 }
+
+TEST_CASE("quantile prediction from sorted leaf outcomes matches quantile prediction", "[quantile, prediction]") {
+  std::vector<double> outcomes = { -9.99984, -7.36924, 5.11211, -0.826997, 0.655345,
+                                   -5.62082, -9.05911, 3.57729, 3.58593, 8.69386 };
+  Data data(outcomes, 10, 1);
+  data.set_outcome_index(0);
+
+  std::vector<std::pair<size_t, double>> weights_by_sample;
+  for (size_t sample = 0; sample < 10; sample++) {
+    weights_by_sample.emplace_back(sample, 0.1);
+  }
+  // Two leaves that hold the samples 0, ..., 4 and 5, ..., 9.
+  LeafSamples leaf_samples(std::vector<std::vector<size_t>>{{0, 1, 2, 3, 4}, {5, 6, 7, 8, 9}});
+
+  std::vector<double> quantiles = {0.15, 0.25, 0.55, 0.75, 0.95};
+  OptimizedQuantilePredictionStrategy prediction_strategy(quantiles);
+  SparsePredictionValues prediction_values = prediction_strategy.precompute_sparse_prediction_values(leaf_samples, data);
+
+  SparsePredictionWorkspace workspace;
+  std::vector<double> expected_predictions = QuantilePredictionStrategy(quantiles).predict(
+      0, weights_by_sample, data, data);
+  REQUIRE(prediction_strategy.predict_sparse({prediction_values.get_entries(0), prediction_values.get_entries(1)},
+                                             workspace) == expected_predictions);
+}
+
+TEST_CASE("leaves keep one run per distinct outcome in increasing order", "[quantile, prediction]") {
+  std::vector<double> outcomes = {3.0, 1.0, 3.0, 2.0};
+  Data data(outcomes, 4, 1);
+  data.set_outcome_index(0);
+  LeafSamples leaf_samples(std::vector<std::vector<size_t>>{{0, 1, 2, 3}, {}});
+
+  OptimizedQuantilePredictionStrategy prediction_strategy({0.5});
+  SparsePredictionValues prediction_values = prediction_strategy.precompute_sparse_prediction_values(leaf_samples, data);
+
+  REQUIRE(prediction_values.get_all_values() == std::vector<std::vector<double>>({{1.0, 0.25, 2.0, 0.25, 3.0, 0.5}, {}}));
+}
+
+TEST_CASE("quantile prediction from leaf outcomes rounds up to the outcome grid", "[quantile, prediction]") {
+  std::vector<double> outcomes = { -9.99984, -7.36924, 5.11211, -0.826997, 0.655345,
+                                   -5.62082, -9.05911, 3.57729, 3.58593, 8.69386 };
+  Data data(outcomes, 10, 1);
+  data.set_outcome_index(0);
+
+  std::vector<size_t> samples;
+  for (size_t sample = 0; sample < 10; sample++) {
+    samples.push_back(sample);
+  }
+  LeafSamples leaf_samples(std::vector<std::vector<size_t>>{samples});
+
+  OptimizedQuantilePredictionStrategy prediction_strategy({0.25, 0.45, 0.75}, {-5.0, 0.0, 5.0, 10.0});
+  SparsePredictionValues prediction_values = prediction_strategy.precompute_sparse_prediction_values(leaf_samples, data);
+
+  // The exact quantiles are -7.36924, -0.826997 and 3.58593.
+  std::vector<double> expected_predictions = {-5.0, 0.0, 5.0};
+  SparsePredictionWorkspace workspace;
+  REQUIRE(prediction_strategy.predict_sparse({prediction_values.get_entries(0)}, workspace) == expected_predictions);
+}
+
+TEST_CASE("outcomes above the outcome grid are rejected", "[quantile, prediction]") {
+  std::vector<double> outcomes = {1.0, 12.0};
+  Data data(outcomes, 2, 1);
+  data.set_outcome_index(0);
+  LeafSamples leaf_samples(std::vector<std::vector<size_t>>{{0, 1}});
+
+  OptimizedQuantilePredictionStrategy prediction_strategy({0.5}, {0.0, 5.0, 10.0});
+  REQUIRE_THROWS_AS(prediction_strategy.precompute_sparse_prediction_values(leaf_samples, data), std::runtime_error);
+}
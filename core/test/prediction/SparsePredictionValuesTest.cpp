@@ -0,0 +1,56 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <stdexcept>
+#include <vector>
+
+#include "prediction/SparsePredictionValues.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+TEST_CASE("sparse prediction values keep a variable number of entries per node", "[prediction]") {
+  std::vector<std::vector<double>> values = {{1.0, 2.0, 3.0, 4.0}, {}, {5.0, 6.0}};
+  SparsePredictionValues prediction_values(values, 2);
+
+  REQUIRE(prediction_values.get_num_nodes() == 3);
+  REQUIRE(prediction_values.get_entry_length() == 2);
+  REQUIRE(!prediction_values.empty(0));
+  REQUIRE(prediction_values.empty(1));
+  REQUIRE(prediction_values.get_num_entries(0) == 2);
+  REQUIRE(prediction_values.get_num_entries(2) == 1);
+
+  SparseEntries entries = prediction_values.get_entries(0);
+  REQUIRE(entries.num_entries == 2);
+  REQUIRE(entries.values[3] == 4.0);
+  REQUIRE(prediction_values.get_entries(2).values[0] == 5.0);
+  REQUIRE(prediction_values.get_all_values() == values);
+}
+
+TEST_CASE("default sparse prediction values have no nodes", "[prediction]") {
+  SparsePredictionValues prediction_values;
+  REQUIRE(prediction_values.get_num_nodes() == 0);
+  REQUIRE(prediction_values.get_all_values().empty());
+}
+
+TEST_CASE("sparse prediction values of the wrong length are rejected", "[prediction]") {
+  std::vector<std::vector<double>> values = {{1.0, 2.0}, {3.0, 4.0, 5.0}};
+  REQUIRE_THROWS_AS(SparsePredictionValues(values, 2), std::runtime_error);
+}
@@ -17,8 +17,11 @@
   along with grf. If not, see <http://www.gnu.org/licenses/>.
  #-------------------------------------------------------------------------------*/
 
+#include <algorithm>
+
 #include "commons/Data.h"
 #include "commons/utility.h"
+#include "prediction/OptimizedSurvivalPredictionStrategy.h"
 #include "prediction/SurvivalPredictionStrategy.h"
 
 #include "catch.hpp"
@@ -54,9 +57,9 @@ TEST_CASE("Kaplan-Meier survival estimates are correct", "[survival], [predictio
   data.set_outcome_index(outcome_index);
   data.set_censor_index(outcome_index + 1);
 
-  std::unordered_map<size_t, double> weights_by_sample;
+  std::vector<std::pair<size_t, double>> weights_by_sample;
   for (size_t i = 0; i < num_rows; i++) {
-    weights_by_sample[i] = 1.0;
+    weights_by_sample.emplace_back(i, 1.0);
   }
 
   int prediction_type = 0; // Kaplan-Meier
@@ -68,6 +71,72 @@ TEST_CASE("Kaplan-Meier survival estimates are correct", "[survival], [predictio
   }
 }
 
+TEST_CASE("Kaplan-Meier estimates from precomputed leaf entries are correct", "[survival], [prediction]") {
+  size_t num_failures = 24;
+  size_t num_rows = 50;
+  size_t num_cols = 2;
+  size_t outcome_index = 0;
+
+  std::vector<double> data_matrix = {
+    10L, 22L, 19L, 0L, 18L, 7L, 6L, 13L, 4L, 14L, 5L, 10L, 24L,
+    4L, 9L, 23L, 4L, 3L, 16L, 11L, 11L, 7L, 20L, 7L, 21L, 1L, 23L,
+    10L, 24L, 7L, 15L, 2L, 12L, 8L, 17L, 14L, 9L, 10L, 2L, 11L, 23L,
+    20L, 16L, 8L, 8L, 10L, 24L, 23L, 22L, 10L, 0L, 1L, 1L, 0L, 1L,
+    1L, 1L, 1L, 0L, 0L, 1L, 0L, 0L, 1L, 0L, 0L, 0L, 1L, 1L, 0L, 1L,
+    0L, 0L, 0L, 1L, 1L, 0L, 0L, 0L, 0L, 1L, 0L, 1L, 0L, 1L, 1L, 1L,
+    1L, 1L, 0L, 1L, 1L, 0L, 0L, 1L, 0L, 1L, 0L, 0L, 0L
+  };
+
+  std::vector<double> expected_predictions = {
+    0.979591836734694, 0.959183673469388, 0.938331854480923, 0.917480035492458,
+    0.895635272742637, 0.873790509992817, 0.851945747242997, 0.828280587597358,
+    0.803181175851983, 0.77727210566321, 0.746181221436681, 0.712263893189559,
+    0.678346564942438, 0.644429236695316, 0.608627612434465, 0.572825988173614,
+    0.53463758896204, 0.496449189750465, 0.458260790538891, 0.420072391327317,
+    0.378065152194585, 0.336057913061853, 0.288049639767303, 0.192033093178202
+  };
+
+  Data data(data_matrix, num_rows, num_cols);
+  data.set_outcome_index(outcome_index);
+  data.set_censor_index(outcome_index + 1);
+
+  std::vector<size_t> samples(num_rows);
+  for (size_t i = 0; i < num_rows; i++) {
+    samples[i] = i;
+  }
+  LeafSamples leaf_samples(std::vector<std::vector<size_t>>{samples});
+
+  int prediction_type = 0; // Kaplan-Meier
+  OptimizedSurvivalPredictionStrategy prediction_strategy(num_failures, prediction_type);
+  SparsePredictionValues prediction_values = prediction_strategy.precompute_sparse_prediction_values(leaf_samples, data);
+
+  // One run for each event time in the leaf, in increasing order of time, with counts
+  // that sum to one as every sample weight is one.
+  SparseEntries entries = prediction_values.get_entries(0);
+  REQUIRE(entries.num_entries <= num_failures + 1);
+  double total_count = 0;
+  for (size_t i = 0; i < entries.num_entries; i++) {
+    const double* run = entries.values + i * OptimizedSurvivalPredictionStrategy::NUM_TYPES;
+    if (i > 0) {
+      const double* previous_run = run - OptimizedSurvivalPredictionStrategy::NUM_TYPES;
+      REQUIRE(run[OptimizedSurvivalPredictionStrategy::TIME] > previous_run[OptimizedSurvivalPredictionStrategy::TIME]);
+    }
+    total_count += run[OptimizedSurvivalPredictionStrategy::FAILURE] + run[OptimizedSurvivalPredictionStrategy::CENSOR];
+  }
+  REQUIRE(equal_doubles(total_count, 1.0, 1e-10));
+
+  // The same leaf twice gives the same counts, once scaled by the number of leaves.
+  SparsePredictionWorkspace workspace;
+  std::vector<double> predictions = prediction_strategy.predict_sparse({entries}, workspace);
+  std::vector<double> predictions_two_leaves = prediction_strategy.predict_sparse({entries, entries}, workspace);
+  REQUIRE(predictions_two_leaves == predictions);
+
+  REQUIRE(predictions.size() == num_failures);
+  for (size_t i = 0; i < predictions.size(); i++) {
+    REQUIRE(equal_doubles(predictions[i], expected_predictions[i], 1e-10));
+  }
+}
+
 TEST_CASE("Kaplan-Meier estimates on duplicated data is the same as with sample weights equal to two", "[survival], [prediction]") {
   size_t num_failures = 24;
   size_t num_rows = 50;
@@ -116,16 +185,16 @@ TEST_CASE("Kaplan-Meier estimates on duplicated data is the same as with sample
   data_duplicated.set_outcome_index(outcome_index);
   data_duplicated.set_censor_index(outcome_index + 1);
 
-  std::unordered_map<size_t, double> weights_by_sample;
+  std::vector<std::pair<size_t, double>> weights_by_sample;
   for (size_t i = 0; i < num_rows; i++) {
-    weights_by_sample[i] = 1.0;
+    weights_by_sample.emplace_back(i, 1.0);
   }
 
   int prediction_type = 0;
   SurvivalPredictionStrategy prediction_strategy(num_failures, prediction_type);
   std::vector<double> predictions_weighted = prediction_strategy.predict(0, weights_by_sample, data, data);
   for (size_t i = num_rows; i < num_rows + num_duplicates; i++) {
-    weights_by_sample[i] = 1.0;
+    weights_by_sample.emplace_back(i, 1.0);
   }
   std::vector<double> predictions_duplicated = prediction_strategy.predict(0, weights_by_sample, data_duplicated, data_duplicated);
 
@@ -163,9 +232,9 @@ TEST_CASE("Nelson-Aalen survival estimates are correct", "[survival], [predictio
   data.set_outcome_index(outcome_index);
   data.set_censor_index(outcome_index + 1);
 
-  std::unordered_map<size_t, double> weights_by_sample;
+  std::vector<std::pair<size_t, double>> weights_by_sample;
   for (size_t i = 0; i < num_rows; i++) {
-    weights_by_sample[i] = 1.0;
+    weights_by_sample.emplace_back(i, 1.0);
   }
 
   int prediction_type = 1; // Nelson-Aalen
@@ -225,16 +294,16 @@ TEST_CASE("Nelson-Aalen estimates on duplicated data is the same as with sample
   data_duplicated.set_outcome_index(outcome_index);
   data_duplicated.set_censor_index(outcome_index + 1);
 
-  std::unordered_map<size_t, double> weights_by_sample;
+  std::vector<std::pair<size_t, double>> weights_by_sample;
   for (size_t i = 0; i < num_rows; i++) {
-    weights_by_sample[i] = 1.0;
+    weights_by_sample.emplace_back(i, 1.0);
   }
 
   int prediction_type = 1;
   SurvivalPredictionStrategy prediction_strategy(num_failures, prediction_type);
   std::vector<double> predictions_weighted = prediction_strategy.predict(0, weights_by_sample, data, data);
   for (size_t i = num_rows; i < num_rows + num_duplicates; i++) {
-    weights_by_sample[i] = 1.0;
+    weights_by_sample.emplace_back(i, 1.0);
   }
   std::vector<double> predictions_duplicated = prediction_strategy.predict(0, weights_by_sample, data_duplicated, data_duplicated);
 
@@ -0,0 +1,93 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "catch.hpp"
+#include "commons/utility.h"
+#include "relabeling/CausalSurvivalScores.h"
+
+using namespace grf;
+
+TEST_CASE("causal survival scores evaluate curves on the grid", "[causal survival, relabeling]") {
+  CausalSurvivalScores scores({1, 2, 4}, CausalSurvivalScores::RMST, 4);
+
+  std::vector<size_t> expected_indices = {0, 1, 2};
+  REQUIRE(scores.get_grid_indices({1.5, 4}) == expected_indices);
+  expected_indices = {1, 2, 3};
+  REQUIRE(scores.get_grid_indices({1, 2, 4}) == expected_indices);
+}
+
+TEST_CASE("causal survival expected outcomes", "[causal survival, relabeling]") {
+  std::vector<double> failure_times = {1, 2, 4};
+  std::vector<double> survival = {0.8, 0.5, 0.25};
+
+  CausalSurvivalScores rmst(failure_times, CausalSurvivalScores::RMST, 4);
+  REQUIRE(equal_doubles(rmst.expected_outcome(survival, failure_times), 1 + 0.8 * 1 + 0.5 * 2, 1e-10));
+
+  CausalSurvivalScores survival_probability(failure_times, CausalSurvivalScores::SURVIVAL_PROBABILITY, 3);
+  REQUIRE(equal_doubles(survival_probability.expected_outcome(survival, failure_times), 0.5, 1e-10));
+  REQUIRE(survival_probability.expected_outcome(survival, {3.5, 4}) == 1);
+}
+
+TEST_CASE("causal survival RMST score numerator", "[causal survival, relabeling]") {
+  CausalSurvivalScores scores({1, 2, 4}, CausalSurvivalScores::RMST, 4);
+  std::vector<double> survival = {0.8, 0.5, 0.25};
+  std::vector<double> censoring = {0.9, 0.6, 0.3};
+  std::vector<double> Q;
+
+  // Q = (1 + (0.8 * 1 + 0.5 * 2) / 0.8, 2 + 0.5 * 2 / 0.5, 4) = (3.25, 4, 4).
+  double Y_hat = 2.5;
+  double W_centered = 0.5;
+  double numerator = scores.compute_numerator(survival, censoring, Y_hat, W_centered, 0, 2, 1, Q);
+
+  double numerator_one = (4 - Y_hat) * W_centered / 0.6;
+  double integral = -std::log(0.9) / 0.9 * (3.25 - Y_hat) + std::log(0.9 / 0.6) / 0.6 * (4 - Y_hat);
+  REQUIRE(equal_doubles(numerator, numerator_one - integral * W_centered, 1e-10));
+
+  // An observed event only enters through its outcome, and the last grid time has Q = max(grid).
+  numerator = scores.compute_numerator(survival, censoring, Y_hat, W_centered, 1, 4, 2, Q);
+  numerator_one = (4 - Y_hat) * W_centered / 0.3;
+  integral += std::log(0.6 / 0.3) / 0.3 * (4 - Y_hat);
+  REQUIRE(equal_doubles(numerator, numerator_one - integral * W_centered, 1e-10));
+}
+
+TEST_CASE("causal survival probability score numerator", "[causal survival, relabeling]") {
+  CausalSurvivalScores scores({1, 2, 4}, CausalSurvivalScores::SURVIVAL_PROBABILITY, 3);
+  std::vector<double> survival = {0.8, 0.5, 0.25};
+  std::vector<double> censoring = {0.9, 0.6, 0.3};
+  std::vector<double> Q;
+
+  // Q = (0.5 / 0.8, 1, 1), as S(horizon) = S(2).
+  double Y_hat = 0.4;
+  double W_centered = -0.5;
+  double numerator = scores.compute_numerator(survival, censoring, Y_hat, W_centered, 1, 0, 1, Q);
+
+  double numerator_one = (0 - Y_hat) * W_centered / 0.6;
+  double integral = -std::log(0.9) / 0.9 * (0.625 - Y_hat) + std::log(0.9 / 0.6) / 0.6 * (1 - Y_hat);
+  REQUIRE(equal_doubles(numerator, numerator_one - integral * W_centered, 1e-10));
+}
+
+TEST_CASE("causal survival scores need a horizon after the first event", "[causal survival, relabeling]") {
+  REQUIRE_THROWS_AS(CausalSurvivalScores({1, 2, 4}, CausalSurvivalScores::SURVIVAL_PROBABILITY, 0.5),
+                    std::runtime_error);
+  REQUIRE_THROWS_AS(CausalSurvivalScores({2, 1}, CausalSurvivalScores::RMST, 4), std::runtime_error);
+}
@@ -41,7 +41,7 @@ std::vector<double> get_relabeled_outcomes(
 
   std::unique_ptr<RelabelingStrategy> relabeling_strategy(new InstrumentalRelabelingStrategy());
 
-  Eigen::ArrayXXd relabeled_observations(num_samples, 1);
+  ResponsesBySample relabeled_observations(num_samples, 1);
   bool stop = relabeling_strategy->relabel(samples, data, relabeled_observations);
   if (stop) {
     return std::vector<double>();
@@ -50,7 +50,7 @@ std::vector<double> get_relabeled_outcomes(
   std::vector<double> relabeled_outcomes;
   relabeled_outcomes.reserve(samples.size());
   for (auto& sample : samples) {
-    relabeled_outcomes.push_back(relabeled_observations(sample));
+    relabeled_outcomes.push_back(relabeled_observations(sample, 0));
   }
   return relabeled_outcomes;
 }
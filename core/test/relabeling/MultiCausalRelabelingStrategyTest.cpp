@@ -40,13 +40,17 @@ Eigen::ArrayXXd get_relabeled_outcomes(
 
   std::unique_ptr<RelabelingStrategy> relabeling_strategy(new MultiCausalRelabelingStrategy(num_treatments, gradient_weights));
 
-  Eigen::ArrayXXd relabeled_observations(num_samples, num_treatments);
+  ResponsesBySample relabeled_observations(num_samples, num_treatments);
   bool stop = relabeling_strategy->relabel(samples, data, relabeled_observations);
   if (stop) {
     return Eigen::ArrayXXd(0, 0);
   }
 
-  return relabeled_observations;
+  Eigen::ArrayXXd rho(num_samples, num_treatments);
+  for (size_t i = 0; i < num_samples; ++i) {
+    rho.row(i) = relabeled_observations.row(i);
+  }
+  return rho;
 }
 
 TEST_CASE("multi causal relabeling calculations are correct", "[multi causal, relabeling]") {
@@ -0,0 +1,193 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "commons/Data.h"
+#include "commons/utility.h"
+#include "forest/ForestPredictors.h"
+#include "forest/ForestTrainer.h"
+#include "forest/ForestTrainers.h"
+#include "prediction/RegressionPredictionStrategy.h"
+#include "relabeling/NoopRelabelingStrategy.h"
+#include "splitting/NodeHistograms.h"
+#include "splitting/factory/RegressionSplittingRuleFactory.h"
+#include "utilities/ForestTestUtilities.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+// Leaves the outcomes as they are, but without declaring them node invariant, so
+// that trees are grown without histogram subtraction.
+class NodeDependentNoopRelabelingStrategy final: public RelabelingStrategy {
+public:
+  bool relabel(SampleSpan samples,
+               const Data& data,
+               ResponsesBySample& responses_by_sample) const {
+    return relabeling_strategy.relabel(samples, data, responses_by_sample);
+  }
+
+private:
+  NoopRelabelingStrategy relabeling_strategy;
+};
+
+ForestTrainer regression_trainer_without_histograms() {
+  return ForestTrainer(std::unique_ptr<RelabelingStrategy>(new NodeDependentNoopRelabelingStrategy()),
+                       std::unique_ptr<SplittingRuleFactory>(new RegressionSplittingRuleFactory()),
+                       std::unique_ptr<OptimizedPredictionStrategy>(new RegressionPredictionStrategy()));
+}
+
+TEST_CASE("node histograms match the statistics of every node", "[NaN], [splitting]") {
+  // Covariates rounded to two digits with missing values, so there are both ties and NaNs.
+  auto data_vec = load_data("test/forest/resources/quantile_data_MIA.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+  data.set_max_bins(32);
+
+  std::vector<size_t> root_samples;
+  for (size_t sample = 0; sample < data.get_num_rows(); sample += 2) {
+    root_samples.push_back(sample);
+  }
+
+  NodeHistograms node_histograms(data, 2);
+  for (auto& sample : root_samples) {
+    double* stats = node_histograms.get_sample_stats(sample);
+    stats[0] = 1;
+    stats[1] = data.get_outcome(sample);
+  }
+  std::vector<std::vector<size_t>> samples = {root_samples};
+
+  // Grow a few levels breadth-first like the tree trainer, splitting each node on a
+  // variable at its median sample and clearing the samples of split nodes.
+  for (size_t node = 0; node < 31; node++) {
+    for (size_t var = 0; var < 10; var++) {
+      std::vector<double> values;
+      std::vector<size_t> bins;
+      const double* histogram = node_histograms.get_histogram(node, var, samples, values, bins);
+      if (histogram == nullptr) {
+        // The node is too small for histograms.
+        REQUIRE(samples[node].size() < data.get_num_bins(var));
+        continue;
+      }
+
+      std::vector<double> expected_values;
+      std::vector<size_t> sorted_samples;
+      data.get_all_values(expected_values, sorted_samples, samples[node], var);
+      REQUIRE(values.size() == expected_values.size());
+
+      std::vector<double> expected_histogram(data.get_num_bins(var) * 2, 0);
+      for (auto& sample : samples[node]) {
+        expected_histogram[data.get_bin(sample, var) * 2] += 1;
+        expected_histogram[data.get_bin(sample, var) * 2 + 1] += data.get_outcome(sample);
+      }
+      for (size_t bin = 0; bin < data.get_num_bins(var); bin++) {
+        REQUIRE(histogram[bin * 2] == expected_histogram[bin * 2]);
+        REQUIRE(equal_doubles(histogram[bin * 2 + 1], expected_histogram[bin * 2 + 1], 1e-8));
+      }
+    }
+
+    size_t split_var = node % 10;
+    double split_value = data.get(samples[node][samples[node].size() / 2], split_var);
+    std::vector<size_t> left_samples;
+    std::vector<size_t> right_samples;
+    for (auto& sample : samples[node]) {
+      double value = data.get(sample, split_var);
+      if (value <= split_value || std::isnan(value)) {
+        left_samples.push_back(sample);
+      } else {
+        right_samples.push_back(sample);
+      }
+    }
+
+    bool is_leaf = left_samples.empty() || right_samples.empty();
+    if (!is_leaf) {
+      size_t left_child = samples.size();
+      size_t right_child = samples.size() + 1;
+      samples.push_back(left_samples);
+      samples.push_back(right_samples);
+      samples[node].clear();
+      node_histograms.split_node(node, left_child, right_child);
+    }
+    node_histograms.finish_node(node, is_leaf);
+  }
+}
+
+TEST_CASE("binned regression forests are the same with and without histogram subtraction", "[regression, forest]") {
+  auto data_vec = load_data("test/forest/resources/regression_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+  ForestOptions options = ForestTestUtilities::default_options(true, 1, 64);
+
+  Forest forest = regression_trainer().train(data, options);
+  Forest forest_without_histograms = regression_trainer_without_histograms().train(data, options);
+
+  ForestPredictor predictor = regression_predictor(4);
+  std::vector<Prediction> predictions = predictor.predict_oob(forest, data, false);
+  std::vector<Prediction> predictions_without_histograms = predictor.predict_oob(forest_without_histograms, data, false);
+
+  for (size_t i = 0; i < predictions.size(); i++) {
+    REQUIRE(equal_doubles(predictions[i].get_predictions()[0],
+                          predictions_without_histograms[i].get_predictions()[0], 1e-6));
+  }
+}
+
+TEST_CASE("benchmark histogram subtraction in deep honest regression forests", "[.benchmark]") {
+  size_t num_rows = 200000;
+  size_t num_cols = 10;
+  std::mt19937_64 random_number_generator(42);
+  std::normal_distribution<double> normal(0, 1);
+  std::vector<double> data_vec((num_cols + 1) * num_rows);
+  for (size_t row = 0; row < num_rows; row++) {
+    double outcome = 0;
+    for (size_t col = 0; col < num_cols; col++) {
+      double value = normal(random_number_generator);
+      data_vec[col * num_rows + row] = value;
+      outcome += col < 3 ? value : 0;
+    }
+    data_vec[num_cols * num_rows + row] = outcome + normal(random_number_generator);
+  }
+  Data data(data_vec, num_rows, num_cols + 1);
+  data.set_outcome_index(num_cols);
+
+  uint num_trees = 10;
+  uint mtry = num_cols;
+  uint min_node_size = 5;
+  double alpha = 0;
+  double imbalance_penalty = 0;
+  uint num_threads = 1;
+  uint seed = 42;
+  uint max_bins = 255;
+  ForestOptions options(num_trees, 1, 0.5, mtry, min_node_size, true, 0.5, true, alpha, imbalance_penalty,
+                        num_threads, seed, false, std::vector<size_t>(), 0, max_bins);
+
+  auto start = std::chrono::steady_clock::now();
+  regression_trainer_without_histograms().train(data, options);
+  auto middle = std::chrono::steady_clock::now();
+  regression_trainer().train(data, options);
+  auto end = std::chrono::steady_clock::now();
+
+  WARN("training without histogram subtraction: "
+       << std::chrono::duration_cast<std::chrono::milliseconds>(middle - start).count() << " ms");
+  WARN("training with histogram subtraction: "
+       << std::chrono::duration_cast<std::chrono::milliseconds>(end - middle).count() << " ms");
+}
@@ -0,0 +1,143 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "commons/Data.h"
+#include "commons/utility.h"
+#include "splitting/SortedSampleIndex.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+void check_same_values(const Data& data,
+                       const SortedSampleIndex& sorted_sample_index,
+                       const std::vector<size_t>& samples) {
+  for (size_t var = 0; var < data.get_num_cols(); var++) {
+    std::vector<double> expected_values;
+    std::vector<size_t> expected_sorted_samples;
+    std::vector<size_t> expected_index = data.get_all_values(expected_values, expected_sorted_samples, samples, var);
+
+    std::vector<double> values;
+    std::vector<size_t> sorted_samples;
+    std::vector<size_t> index = sorted_sample_index.get_all_values(values, sorted_samples, var);
+
+    REQUIRE(sorted_samples == expected_sorted_samples);
+    REQUIRE(index == expected_index);
+    REQUIRE(values.size() == expected_values.size());
+    for (size_t i = 0; i < values.size(); i++) {
+      REQUIRE((values[i] == expected_values[i] || (std::isnan(values[i]) && std::isnan(expected_values[i]))));
+    }
+  }
+}
+
+TEST_CASE("presorted samples match sorting at every node", "[NaN], [splitting]") {
+  // Covariates rounded to two digits with missing values, so there are both ties and NaNs.
+  auto data_vec = load_data("test/forest/resources/quantile_data_MIA.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  // Use a sample order that differs from the row order, as the tree trainer does.
+  std::vector<size_t> root_samples;
+  for (size_t sample = 0; sample < data.get_num_rows(); sample += 3) {
+    root_samples.push_back(sample);
+  }
+  for (size_t sample = data.get_num_rows() - 1; sample > 0; sample--) {
+    if (sample % 3 != 0 && sample % 7 != 0) {
+      root_samples.push_back(sample);
+    }
+  }
+
+  SortedSampleIndex sorted_sample_index(data, root_samples);
+  std::vector<std::vector<size_t>> samples = {root_samples};
+
+  // Grow a few levels breadth-first, splitting each node on a variable at its median sample.
+  for (size_t node = 0; node < 15; node++) {
+    sorted_sample_index.set_node(node, samples[node]);
+    check_same_values(data, sorted_sample_index, samples[node]);
+
+    size_t split_var = node % 10;
+    double split_value = data.get(samples[node][samples[node].size() / 2], split_var);
+    std::vector<size_t> left_samples;
+    std::vector<size_t> right_samples;
+    for (auto& sample : samples[node]) {
+      double value = data.get(sample, split_var);
+      if (value <= split_value || std::isnan(value)) {
+        left_samples.push_back(sample);
+      } else {
+        right_samples.push_back(sample);
+      }
+    }
+
+    size_t left_child = samples.size();
+    size_t right_child = samples.size() + 1;
+    samples.push_back(left_samples);
+    samples.push_back(right_samples);
+    sorted_sample_index.split_node(node, left_child, right_child, left_samples);
+  }
+}
+
+TEST_CASE("presorted samples only answer for the node they are set to", "[splitting]") {
+  auto data_vec = load_data("test/forest/resources/quantile_data_MIA.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  std::vector<size_t> root_samples = {0, 1, 2, 3, 4, 5, 6, 7};
+  SortedSampleIndex sorted_sample_index(data, root_samples);
+  sorted_sample_index.set_node(0, root_samples);
+  REQUIRE(sorted_sample_index.is_current_node(root_samples));
+
+  std::vector<size_t> left_samples = {0, 2, 4, 6};
+  std::vector<size_t> right_samples = {1, 3, 5, 7};
+  sorted_sample_index.split_node(0, 1, 2, left_samples);
+  sorted_sample_index.set_node(1, left_samples);
+  REQUIRE(sorted_sample_index.is_current_node(left_samples));
+  // A node of the same size is not the current node.
+  REQUIRE_FALSE(sorted_sample_index.is_current_node(right_samples));
+
+  std::vector<size_t> too_few_samples = {1, 3, 5};
+  REQUIRE_THROWS_AS(sorted_sample_index.set_node(2, too_few_samples), std::logic_error);
+}
+
+TEST_CASE("presorting is only used when the index fits in the memory budget", "[splitting]") {
+  auto data_vec = load_data("test/forest/resources/quantile_data_MIA.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+  size_t num_samples = data.get_num_rows();
+  size_t index_bytes = ((10 + 1) * num_samples + data.get_num_rows()) * sizeof(uint32_t);
+
+  REQUIRE(SortedSampleIndex::is_beneficial(data, num_samples, 3));
+  REQUIRE(SortedSampleIndex::is_beneficial(data, num_samples, 3, index_bytes));
+  REQUIRE_FALSE(SortedSampleIndex::is_beneficial(data, num_samples, 3, index_bytes - 1));
+}
+
+TEST_CASE("the presorting budget of a thread scales with the data", "[splitting]") {
+  size_t num_rows = 10000000;
+  std::vector<double> data_vec(1);
+  Data data(data_vec.data(), num_rows, 11);
+  size_t data_bytes = num_rows * 11 * sizeof(double);
+
+  REQUIRE(SortedSampleIndex::get_max_bytes(data, 1) == data_bytes);
+  REQUIRE(SortedSampleIndex::get_max_bytes(data, 2) == data_bytes / 2);
+  REQUIRE(SortedSampleIndex::get_max_bytes(data, 64) == SortedSampleIndex::DEFAULT_MAX_BYTES);
+}
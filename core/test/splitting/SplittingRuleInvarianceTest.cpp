@@ -47,7 +47,7 @@ void run_one_split(const Data& data,
   std::iota(possible_split_vars.begin(), possible_split_vars.end(), 0);
   size_t node = 0;
   size_t size_node = data.get_num_rows();
-  Eigen::ArrayXXd responses_by_sample(size_node, 1);
+  ResponsesBySample responses_by_sample(size_node, 1);
   std::vector<std::vector<size_t>> samples(1);
   for (size_t sample = 0; sample < size_node; ++sample) {
     samples[node].push_back(sample);
@@ -0,0 +1,75 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "tree/LeafSamples.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+TEST_CASE("leaf samples keep the samples of every node", "[tree, unit]") {
+  std::vector<std::vector<size_t>> samples_by_node = {{}, {}, {4, 1}, {}, {0, 3, 2}};
+  LeafSamples leaf_samples(samples_by_node);
+
+  REQUIRE(leaf_samples.size() == 5);
+  REQUIRE(leaf_samples[0].empty());
+  REQUIRE(leaf_samples[2].size() == 2);
+  REQUIRE(leaf_samples[2][0] == 4);
+  REQUIRE(leaf_samples[2][1] == 1);
+  REQUIRE(leaf_samples[4].size() == 3);
+  REQUIRE(leaf_samples.get_samples_by_node() == samples_by_node);
+
+  // The leaves are adjacent ranges of one array.
+  REQUIRE(leaf_samples[2].end() == leaf_samples[4].begin());
+
+  LeafSamples empty;
+  REQUIRE(empty.size() == 0);
+}
+
+TEST_CASE("leaf samples reject sample IDs that do not fit in 32 bits", "[tree, unit]") {
+  std::vector<std::vector<size_t>> samples_by_node = {{UINT32_MAX}};
+  REQUIRE(LeafSamples(samples_by_node)[0][0] == UINT32_MAX);
+
+  samples_by_node[0][0] = static_cast<size_t>(UINT32_MAX) + 1;
+  REQUIRE_THROWS_AS(LeafSamples(samples_by_node), std::runtime_error);
+}
+
+TEST_CASE("leaf samples group samples by leaf in their original order", "[tree, unit]") {
+  std::vector<size_t> samples = {5, 0, 3, 6, 1};
+  std::vector<size_t> leaf_nodes = {4, 1, 0, 2, 0, 4, 2};
+  LeafSamples leaf_samples(5, samples, leaf_nodes);
+
+  std::vector<std::vector<size_t>> expected = {{}, {1}, {3, 6}, {}, {5, 0}};
+  REQUIRE(leaf_samples.get_samples_by_node() == expected);
+}
+
+TEST_CASE("leaf samples can be taken from the nodes of a growing tree", "[tree, unit]") {
+  NodeSamples node_samples;
+  node_samples.set_root_samples({7, 2, 9, 4});
+  size_t left = node_samples.add_node();
+  size_t right = node_samples.add_node();
+  node_samples.split_node(0, left, right, [](size_t sample) { return sample < 5; });
+
+  LeafSamples leaf_samples(node_samples);
+  REQUIRE(leaf_samples.get_samples_by_node() == node_samples.get_samples_by_node());
+}
@@ -0,0 +1,143 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "commons/Data.h"
+#include "commons/utility.h"
+#include "forest/ForestTrainers.h"
+#include "prediction/collector/TreeTraverser.h"
+#include "tree/Tree.h"
+#include "utilities/ForestTestUtilities.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+TEST_CASE("leaf lookup follows splits and missing value directions", "[tree, unit]") {
+  /*
+   *               0: X1 <= 0.5, NaN right
+   *              /    \
+   *   1: X2 is NaN     2
+   *     /    \
+   *    3      4
+   */
+  double nan = NAN;
+  std::vector<std::vector<size_t>> child_nodes = {{1, 3, 0, 0, 0}, {2, 4, 0, 0, 0}};
+  std::vector<std::vector<size_t>> leaf_samples = {{}, {}, {0}, {1}, {2}};
+  Tree tree(0, child_nodes, leaf_samples, {0, 1, 0, 0, 0}, {0.5, nan, 0, 0, 0}, {},
+            {false, false, true, true, true}, PredictionValues());
+
+  std::vector<double> data_vec = {
+    0.2, 0.2, 0.9, nan, 0.5, // X1
+    1.0, nan, 1.0, 1.0, nan  // X2
+  };
+  Data data(data_vec, 5, 2);
+
+  std::vector<size_t> leaf_nodes = tree.find_leaf_nodes(data, std::vector<bool>(5, true));
+  std::vector<size_t> expected_leaf_nodes = {4, 3, 2, 2, 3};
+  REQUIRE(leaf_nodes == expected_leaf_nodes);
+
+  // Missing values follow `send_missing_left` for ordinary splits.
+  Tree nan_left_tree(0, child_nodes, leaf_samples, {0, 1, 0, 0, 0}, {0.5, nan, 0, 0, 0}, {},
+                     {true, false, true, true, true}, PredictionValues());
+  REQUIRE(nan_left_tree.find_leaf_nodes(data, std::vector<size_t>{3})[3] == 4);
+}
+
+TEST_CASE("leaf lookup follows the pruned tree", "[tree, unit]") {
+  // Same tree as in the pruning test, pruned to the root 1 with leaves 6 and 7.
+  std::vector<std::vector<size_t>> child_nodes =
+      {{1, 3, 0, 5, 7, 0, 0, 0, 9, 0, 0}, {2, 4, 0, 6, 8, 0, 0, 0, 10, 0, 0}};
+  std::vector<std::vector<size_t>> leaf_samples = {
+      {{}, {}, {}, {}, {}, {}, {42, 43}, {44}, {}, {}, {}}};
+  std::vector<size_t> split_vars(11, 0);
+  std::vector<double> split_values = {0, 0.5, 0, 0.2, 0.8, 0, 0, 0, 0.9, 0, 0};
+  Tree tree(0, child_nodes, leaf_samples, split_vars, split_values, {}, std::vector<bool>(11, true),
+            PredictionValues());
+  tree.honesty_prune_leaves();
+
+  std::vector<double> data_vec = {0.1, 0.4, 0.6, 1.0};
+  Data data(data_vec, 4, 1);
+  std::vector<size_t> leaf_nodes = tree.find_leaf_nodes(data, std::vector<bool>(4, true));
+  std::vector<size_t> expected_leaf_nodes = {6, 6, 7, 7};
+  REQUIRE(leaf_nodes == expected_leaf_nodes);
+}
+
+TEST_CASE("leaf lookup matches a walk over the node vectors in trained trees", "[tree]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+  // Make some covariates missing so that trees learn where to send them.
+  for (size_t row = 0; row < data.get_num_rows(); row += 7) {
+    set_data(data_vec, row, row % 10, NAN);
+  }
+
+  Forest forest = regression_trainer().train(data, ForestTestUtilities::default_options());
+  std::vector<bool> all_samples(data.get_num_rows(), true);
+  for (const std::unique_ptr<Tree>& tree : forest.get_trees()) {
+    std::vector<size_t> leaf_nodes = tree->find_leaf_nodes(data, all_samples);
+    for (size_t sample = 0; sample < data.get_num_rows(); sample++) {
+      size_t node = tree->get_root_node();
+      while (!tree->is_leaf(node)) {
+        double value = data.get(sample, tree->get_split_vars()[node]);
+        double split_value = tree->get_split_values()[node];
+        bool go_left = value <= split_value
+            || (std::isnan(value) && (tree->get_send_missing_left()[node] || std::isnan(split_value)));
+        node = tree->get_child_nodes()[go_left ? 0 : 1][node];
+      }
+      REQUIRE(leaf_nodes[sample] == node);
+    }
+  }
+}
+
+TEST_CASE("out-of-bag validity excludes exactly the samples each tree drew", "[tree]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+
+  ForestOptions options = ForestTestUtilities::default_options();
+  Forest forest = regression_trainer().train(data, options);
+  size_t num_samples = data.get_num_rows();
+  size_t num_trees = forest.get_trees().size();
+
+  TreeTraverser tree_traverser(options.get_num_threads());
+  REQUIRE(tree_traverser.get_valid_trees_by_sample(forest, data, false).empty());
+
+  std::vector<std::vector<bool>> trees_by_sample = tree_traverser.get_valid_trees_by_sample(forest, data, true);
+  REQUIRE(trees_by_sample.size() == num_samples);
+  for (size_t tree_index = 0; tree_index < num_trees; ++tree_index) {
+    const std::vector<size_t>& drawn_samples = forest.get_trees()[tree_index]->get_drawn_samples();
+    REQUIRE(std::is_sorted(drawn_samples.begin(), drawn_samples.end()));
+    for (size_t sample = 0; sample < num_samples; ++sample) {
+      bool drawn = std::find(drawn_samples.begin(), drawn_samples.end(), sample) != drawn_samples.end();
+      REQUIRE(trees_by_sample[sample][tree_index] == !drawn);
+    }
+  }
+
+  size_t start = 37;
+  size_t block_size = 100;
+  std::vector<std::vector<bool>> block_trees_by_sample = tree_traverser.get_valid_trees_by_sample(
+      forest, true, start, block_size);
+  REQUIRE(block_trees_by_sample.size() == block_size);
+  for (size_t i = 0; i < block_size; ++i) {
+    REQUIRE(block_trees_by_sample[i] == trees_by_sample[start + i]);
+  }
+}
@@ -0,0 +1,200 @@
+/*-------------------------------------------------------------------------------
+  Copyright (c) 2024 GRF Contributors.
+
+  This file is part of generalized random forest (grf).
+
+  grf is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  grf is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with grf. If not, see <http://www.gnu.org/licenses/>.
+ #-------------------------------------------------------------------------------*/
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "commons/Data.h"
+#include "commons/utility.h"
+#include "prediction/RegressionPredictionStrategy.h"
+#include "relabeling/NoopRelabelingStrategy.h"
+#include "sampling/RandomSampler.h"
+#include "splitting/factory/RegressionSplittingRuleFactory.h"
+#include "tree/TreeTrainer.h"
+
+#include "catch.hpp"
+
+using namespace grf;
+
+TreeTrainer regression_tree_trainer() {
+  return TreeTrainer(std::unique_ptr<RelabelingStrategy>(new NoopRelabelingStrategy()),
+                     std::unique_ptr<SplittingRuleFactory>(new RegressionSplittingRuleFactory()),
+                     std::unique_ptr<OptimizedPredictionStrategy>(new RegressionPredictionStrategy()));
+}
+
+std::unique_ptr<Tree> train_tree(const TreeTrainer& trainer,
+                                 const Data& data,
+                                 size_t seed,
+                                 TreeTrainingWorkspace* workspace) {
+  TreeOptions options(3, 5, true, 0.5, true, 0.05, 0);
+  RandomSampler sampler(static_cast<uint>(seed), SamplingOptions());
+  std::vector<size_t> clusters;
+  sampler.sample_clusters(data.get_num_rows(), 0.5, clusters);
+  if (workspace == nullptr) {
+    return trainer.train(data, sampler, clusters, options);
+  }
+  return trainer.train(data, sampler, clusters, options, *workspace);
+}
+
+std::vector<std::unique_ptr<Tree>> train_trees(const TreeTrainer& trainer,
+                                               const Data& data,
+                                               size_t num_trees,
+                                               bool share_workspace) {
+  TreeTrainingWorkspace workspace;
+  std::vector<std::unique_ptr<Tree>> trees;
+  for (size_t i = 0; i < num_trees; i++) {
+    trees.push_back(train_tree(trainer, data, i, share_workspace ? &workspace : nullptr));
+  }
+  return trees;
+}
+
+// The number of workspace buffers allocated or grown since `buffers` was taken.
+size_t count_allocations(const TreeTrainingWorkspace& workspace,
+                         const std::vector<const void*>& buffers) {
+  std::vector<const void*> new_buffers = workspace.get_buffers();
+  size_t num_allocations = 0;
+  for (size_t i = 0; i < new_buffers.size(); i++) {
+    if (i >= buffers.size() || new_buffers[i] != buffers[i]) {
+      num_allocations++;
+    }
+  }
+  return num_allocations;
+}
+
+TEST_CASE("trees trained with a shared workspace are the same", "[tree]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+  TreeTrainer trainer = regression_tree_trainer();
+
+  SECTION("with sorted sample index") {}
+  SECTION("with node histograms") {
+    data.set_max_bins(32);
+  }
+
+  std::vector<std::unique_ptr<Tree>> trees = train_trees(trainer, data, 10, false);
+  std::vector<std::unique_ptr<Tree>> shared_trees = train_trees(trainer, data, 10, true);
+
+  for (size_t i = 0; i < trees.size(); i++) {
+    REQUIRE(trees[i]->get_child_nodes() == shared_trees[i]->get_child_nodes());
+    REQUIRE(trees[i]->get_split_vars() == shared_trees[i]->get_split_vars());
+    REQUIRE(trees[i]->get_split_values() == shared_trees[i]->get_split_values());
+    REQUIRE(trees[i]->get_leaf_samples().get_samples_by_node() == shared_trees[i]->get_leaf_samples().get_samples_by_node());
+  }
+}
+
+TEST_CASE("every tree reuses the buffers of a shared workspace", "[tree]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+  TreeTrainer trainer = regression_tree_trainer();
+
+  SECTION("with sorted sample index") {}
+  SECTION("with node histograms") {
+    data.set_max_bins(32);
+  }
+
+  TreeTrainingWorkspace workspace;
+  train_tree(trainer, data, 0, &workspace);
+  const SplittingRule* splitting_rule = workspace.get_splitting_rule();
+  const ResponsesBySample* responses_by_sample = workspace.get_responses_by_sample();
+  const SortedSampleIndex* sorted_sample_index = workspace.get_sorted_sample_index();
+  const NodeHistograms* node_histograms = workspace.get_node_histograms();
+  const size_t* node_samples = workspace.get_nodes()[0].begin();
+
+  REQUIRE(splitting_rule != nullptr);
+  REQUIRE(responses_by_sample != nullptr);
+
+  for (size_t i = 1; i < 20; i++) {
+    train_tree(trainer, data, i, &workspace);
+    REQUIRE(workspace.get_splitting_rule() == splitting_rule);
+    REQUIRE(workspace.get_responses_by_sample() == responses_by_sample);
+    REQUIRE(workspace.get_sorted_sample_index() == sorted_sample_index);
+    REQUIRE(workspace.get_node_histograms() == node_histograms);
+    REQUIRE(workspace.get_nodes()[0].begin() == node_samples);
+  }
+}
+
+TEST_CASE("trees trained with a shared workspace allocate fewer buffers than the first", "[tree]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+  TreeTrainer trainer = regression_tree_trainer();
+
+  SECTION("with sorted sample index") {}
+  SECTION("with node histograms") {
+    data.set_max_bins(32);
+  }
+
+  TreeTrainingWorkspace workspace;
+  std::vector<const void*> buffers = workspace.get_buffers();
+  train_tree(trainer, data, 0, &workspace);
+  size_t first_tree_allocations = count_allocations(workspace, buffers);
+
+  // Later trees only allocate a buffer if they need more room than the trees before them,
+  // so all of them together allocate fewer buffers than the first one.
+  size_t num_allocations = 0;
+  for (size_t i = 1; i < 20; i++) {
+    buffers = workspace.get_buffers();
+    train_tree(trainer, data, i, &workspace);
+    num_allocations += count_allocations(workspace, buffers);
+  }
+  REQUIRE(first_tree_allocations > 0);
+  REQUIRE(num_allocations < first_tree_allocations);
+}
+
+TEST_CASE("benchmark tree training with a shared workspace", "[.benchmark]") {
+  auto data_vec = load_data("test/forest/resources/gaussian_data.csv");
+  Data data(data_vec);
+  data.set_outcome_index(10);
+  TreeTrainer trainer = regression_tree_trainer();
+
+  size_t num_trees = 500;
+  for (size_t max_bins : {0, 32}) {
+    data.set_max_bins(max_bins);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::unique_ptr<Tree>> trees = train_trees(trainer, data, num_trees, false);
+    auto middle = std::chrono::steady_clock::now();
+    std::vector<std::unique_ptr<Tree>> shared_trees = train_trees(trainer, data, num_trees, true);
+    auto end = std::chrono::steady_clock::now();
+
+    REQUIRE(trees.back()->get_split_vars() == shared_trees.back()->get_split_vars());
+    double fresh_ms = std::chrono::duration<double, std::milli>(middle - start).count();
+    double shared_ms = std::chrono::duration<double, std::milli>(end - middle).count();
+
+    TreeTrainingWorkspace fresh_workspace;
+    std::vector<const void*> buffers = fresh_workspace.get_buffers();
+    train_tree(trainer, data, 0, &fresh_workspace);
+    size_t fresh_allocations = count_allocations(fresh_workspace, buffers);
+
+    TreeTrainingWorkspace shared_workspace;
+    size_t shared_allocations = 0;
+    for (size_t i = 0; i < num_trees; i++) {
+      buffers = shared_workspace.get_buffers();
+      train_tree(trainer, data, i, &shared_workspace);
+      shared_allocations += count_allocations(shared_workspace, buffers);
+    }
+
+    WARN("max_bins " << max_bins << ", " << num_trees << " trees: " << fresh_ms
+         << " ms with a workspace per tree, " << shared_ms << " ms with a shared workspace, "
+         << fresh_allocations << " and " << static_cast<double>(shared_allocations) / num_trees
+         << " workspace buffer allocations per tree");
+  }
+}
@@ -30,6 +30,12 @@ ForestOptions ForestTestUtilities::default_honest_options() {
 
 ForestOptions ForestTestUtilities::default_options(bool honesty,
                                                    size_t ci_group_size) {
+  return default_options(honesty, ci_group_size, 0);
+}
+
+ForestOptions ForestTestUtilities::default_options(bool honesty,
+                                                   size_t ci_group_size,
+                                                   uint max_bins) {
   double honesty_fraction = 0.5;
   bool prune = true;
   uint num_trees = 50;
@@ -46,5 +52,5 @@ ForestOptions ForestTestUtilities::default_options(bool honesty,
 
   return ForestOptions(num_trees,
           ci_group_size, sample_fraction, mtry, min_node_size, honesty, honesty_fraction,
-      prune, alpha, imbalance_penalty, num_threads, seed, legacy_seed, empty_clusters, samples_per_cluster);
+      prune, alpha, imbalance_penalty, num_threads, seed, legacy_seed, empty_clusters, samples_per_cluster, max_bins);
 }
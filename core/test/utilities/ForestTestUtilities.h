@@ -30,6 +30,8 @@ public:
   static ForestOptions default_honest_options();
 
   static ForestOptions default_options(bool honesty, size_t ci_group_size);
+
+  static ForestOptions default_options(bool honesty, size_t ci_group_size, uint max_bins);
 };
 
 #endif //GRF_FORESTTESTUTILITIES_H
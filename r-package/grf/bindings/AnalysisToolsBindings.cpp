@@ -22,6 +22,7 @@
 
 #include "Eigen/Sparse"
 #include "analysis/SplitFrequencyComputer.h"
+#include "commons/ThreadPool.h"
 #include "commons/globals.h"
 #include "forest/Forest.h"
 #include "prediction/collector/SampleWeightComputer.h"
@@ -59,10 +60,12 @@ Eigen::SparseMatrix<double> compute_sample_weights(const Rcpp::List& forest_obje
   Data train_data = RcppUtilities::convert_data(train_matrix);
   Data data = RcppUtilities::convert_data(test_matrix);
   Forest forest = RcppUtilities::deserialize_forest(forest_object);
+  data.set_single_precision(forest.is_single_precision());
   num_threads = ForestOptions::validate_num_threads(num_threads);
 
   TreeTraverser tree_traverser(num_threads);
   SampleWeightComputer weight_computer;
+  SampleWeightComputer::WeightAccumulator accumulator;
 
   std::vector<std::vector<size_t>> leaf_nodes_by_tree = tree_traverser.get_leaf_nodes(forest, data, oob_prediction);
   std::vector<std::vector<bool>> trees_by_sample = tree_traverser.get_valid_trees_by_sample(forest, data, oob_prediction);
@@ -77,8 +80,8 @@ Eigen::SparseMatrix<double> compute_sample_weights(const Rcpp::List& forest_obje
   Eigen::SparseMatrix<double> result(num_samples, num_neighbors);
 
   for (size_t sample = 0; sample < num_samples; sample++) {
-    std::unordered_map<size_t, double> weights = weight_computer.compute_weights(
-        sample, forest, leaf_nodes_by_tree, trees_by_sample);
+    std::vector<std::pair<size_t, double>> weights = weight_computer.compute_weights(
+        sample, forest, leaf_nodes_by_tree, trees_by_sample, accumulator);
     for (auto it = weights.begin(); it != weights.end(); it++) {
       size_t neighbor = it->first;
       double weight = it->second;
@@ -119,3 +122,8 @@ Rcpp::List merge(const Rcpp::List& forest_objects) {
   Forest big_forest = Forest::merge(forests);
   return RcppUtilities::serialize_forest(big_forest);
 }
+
+// [[Rcpp::export]]
+void thread_pool_shutdown() {
+  ThreadPool::get_instance().shutdown();
+}
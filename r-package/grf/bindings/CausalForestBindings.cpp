@@ -48,9 +48,11 @@ Rcpp::List causal_train(const Rcpp::NumericMatrix& train_matrix,
                         std::vector<size_t> clusters,
                         unsigned int samples_per_cluster,
                         bool compute_oob_predictions,
+                        unsigned int max_bins,
                         unsigned int num_threads,
                         unsigned int seed,
-                        bool legacy_seed) {
+                        bool legacy_seed,
+                        bool single_precision) {
   ForestTrainer trainer = instrumental_trainer(reduced_form_weight, stabilize_splits);
 
   Data data = RcppUtilities::convert_data(train_matrix);
@@ -61,8 +63,9 @@ Rcpp::List causal_train(const Rcpp::NumericMatrix& train_matrix,
     data.set_weight_index(sample_weight_index);
   }
 
+  data.set_single_precision(single_precision);
   ForestOptions options(num_trees, ci_group_size, sample_fraction, mtry, min_node_size, honesty,
-    honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, legacy_seed, clusters, samples_per_cluster);
+    honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, legacy_seed, clusters, samples_per_cluster, max_bins);
   Forest forest = trainer.train(data, options);
 
   std::vector<Prediction> predictions;
@@ -90,6 +93,7 @@ Rcpp::List causal_predict(const Rcpp::List& forest_object,
   Data data = RcppUtilities::convert_data(test_matrix);
 
   Forest forest = RcppUtilities::deserialize_forest(forest_object);
+  data.set_single_precision(forest.is_single_precision());
 
   ForestPredictor predictor = instrumental_predictor(num_threads);
   std::vector<Prediction> predictions = predictor.predict(forest, train_data, data, estimate_variance);
@@ -111,6 +115,7 @@ Rcpp::List causal_predict_oob(const Rcpp::List& forest_object,
   data.set_instrument_index(treatment_index);
 
   Forest forest = RcppUtilities::deserialize_forest(forest_object);
+  data.set_single_precision(forest.is_single_precision());
 
   ForestPredictor predictor = instrumental_predictor(num_threads);
   std::vector<Prediction> predictions = predictor.predict_oob(forest, data, estimate_variance);
@@ -129,7 +134,8 @@ Rcpp::List ll_causal_predict(const Rcpp::List& forest_object,
                              bool ll_weight_penalty,
                              std::vector<size_t> linear_correction_variables,
                              unsigned int num_threads,
-                             bool estimate_variance) {
+                             bool estimate_variance,
+                             bool precompute_moments) {
   Data train_data = RcppUtilities::convert_data(train_matrix);
   train_data.set_outcome_index(outcome_index);
   train_data.set_treatment_index(treatment_index);
@@ -137,10 +143,19 @@ Rcpp::List ll_causal_predict(const Rcpp::List& forest_object,
   Data data = RcppUtilities::convert_data(test_matrix);
 
   Forest deserialized_forest = RcppUtilities::deserialize_forest(forest_object);
+  data.set_single_precision(deserialized_forest.is_single_precision());
 
-  ForestPredictor predictor = ll_causal_predictor(num_threads, ll_lambda, ll_weight_penalty,
-                                                  linear_correction_variables);
-  std::vector<Prediction> predictions = predictor.predict(deserialized_forest, train_data, data, estimate_variance);
+  std::vector<Prediction> predictions;
+  if (precompute_moments) {
+    precompute_ll_causal_moments(deserialized_forest, train_data, linear_correction_variables, num_threads);
+    ForestPredictor predictor = optimized_ll_causal_predictor(num_threads, ll_lambda, ll_weight_penalty,
+                                                              linear_correction_variables);
+    predictions = predictor.predict(deserialized_forest, train_data, data, estimate_variance);
+  } else {
+    ForestPredictor predictor = ll_causal_predictor(num_threads, ll_lambda, ll_weight_penalty,
+                                                    linear_correction_variables);
+    predictions = predictor.predict(deserialized_forest, train_data, data, estimate_variance);
+  }
   Rcpp::List result = RcppUtilities::create_prediction_object(predictions);
 
   return result;
@@ -155,7 +170,8 @@ Rcpp::List ll_causal_predict_oob(const Rcpp::List& forest_object,
                                  bool ll_weight_penalty,
                                  std::vector<size_t> linear_correction_variables,
                                  unsigned int num_threads,
-                                 bool estimate_variance) {
+                                 bool estimate_variance,
+                                 bool precompute_moments) {
   Data data = RcppUtilities::convert_data(train_matrix);
 
   data.set_outcome_index(outcome_index);
@@ -163,10 +179,19 @@ Rcpp::List ll_causal_predict_oob(const Rcpp::List& forest_object,
   data.set_instrument_index(treatment_index);
 
   Forest deserialized_forest = RcppUtilities::deserialize_forest(forest_object);
+  data.set_single_precision(deserialized_forest.is_single_precision());
 
-  ForestPredictor predictor = ll_causal_predictor(num_threads, ll_lambda, ll_weight_penalty,
-                                                  linear_correction_variables);
-  std::vector<Prediction> predictions = predictor.predict_oob(deserialized_forest, data, estimate_variance);
+  std::vector<Prediction> predictions;
+  if (precompute_moments) {
+    precompute_ll_causal_moments(deserialized_forest, data, linear_correction_variables, num_threads);
+    ForestPredictor predictor = optimized_ll_causal_predictor(num_threads, ll_lambda, ll_weight_penalty,
+                                                              linear_correction_variables);
+    predictions = predictor.predict_oob(deserialized_forest, data, estimate_variance);
+  } else {
+    ForestPredictor predictor = ll_causal_predictor(num_threads, ll_lambda, ll_weight_penalty,
+                                                    linear_correction_variables);
+    predictions = predictor.predict_oob(deserialized_forest, data, estimate_variance);
+  }
   Rcpp::List result = RcppUtilities::create_prediction_object(predictions);
 
   return result;
@@ -21,6 +21,7 @@
 #include <vector>
 
 #include "commons/globals.h"
+#include "forest/CausalSurvivalNuisance.h"
 #include "forest/ForestPredictors.h"
 #include "forest/ForestTrainers.h"
 #include "RcppUtilities.h"
@@ -49,9 +50,11 @@ Rcpp::List causal_survival_train(const Rcpp::NumericMatrix& train_matrix,
                                  const std::vector<size_t>& clusters,
                                  unsigned int samples_per_cluster,
                                  bool compute_oob_predictions,
+                                 unsigned int max_bins,
                                  unsigned int num_threads,
                                  unsigned int seed,
-                                 bool legacy_seed) {
+                                 bool legacy_seed,
+                                 bool single_precision) {
   ForestTrainer trainer = causal_survival_trainer(stabilize_splits);
 
   Data data = RcppUtilities::convert_data(train_matrix);
@@ -64,8 +67,9 @@ Rcpp::List causal_survival_train(const Rcpp::NumericMatrix& train_matrix,
     data.set_weight_index(sample_weight_index);
   }
 
+  data.set_single_precision(single_precision);
   ForestOptions options(num_trees, ci_group_size, sample_fraction, mtry, min_node_size, honesty,
-      honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, legacy_seed, clusters, samples_per_cluster);
+      honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, legacy_seed, clusters, samples_per_cluster, max_bins);
   Forest forest = trainer.train(data, options);
 
   std::vector<Prediction> predictions;
@@ -87,6 +91,7 @@ Rcpp::List causal_survival_predict(const Rcpp::List& forest_object,
   Data data = RcppUtilities::convert_data(test_matrix);
 
   Forest forest = RcppUtilities::deserialize_forest(forest_object);
+  data.set_single_precision(forest.is_single_precision());
 
   ForestPredictor predictor = causal_survival_predictor(num_threads);
   std::vector<Prediction> predictions = predictor.predict(forest, train_data, data, estimate_variance);
@@ -103,6 +108,7 @@ Rcpp::List causal_survival_predict_oob(const Rcpp::List& forest_object,
   Data data = RcppUtilities::convert_data(train_matrix);
 
   Forest forest = RcppUtilities::deserialize_forest(forest_object);
+  data.set_single_precision(forest.is_single_precision());
 
   ForestPredictor predictor = causal_survival_predictor(num_threads);
   std::vector<Prediction> predictions = predictor.predict_oob(forest, data, estimate_variance);
@@ -110,3 +116,87 @@ Rcpp::List causal_survival_predict_oob(const Rcpp::List& forest_object,
 
   return result;
 }
+
+// [[Rcpp::export]]
+std::vector<double> causal_survival_expected_outcomes_oob(const Rcpp::List& forest_object,
+                                                          const Rcpp::NumericMatrix& train_matrix,
+                                                          size_t outcome_index,
+                                                          size_t censor_index,
+                                                          size_t sample_weight_index,
+                                                          bool use_sample_weights,
+                                                          const std::vector<double>& failure_times,
+                                                          int prediction_type,
+                                                          const std::vector<double>& grid,
+                                                          int target,
+                                                          double horizon,
+                                                          unsigned int num_threads) {
+  Data data = RcppUtilities::convert_data(train_matrix);
+  data.set_outcome_index(outcome_index);
+  data.set_censor_index(censor_index);
+  if (use_sample_weights) {
+    data.set_weight_index(sample_weight_index);
+  }
+
+  Forest forest = RcppUtilities::deserialize_forest(forest_object);
+  data.set_single_precision(forest.is_single_precision());
+  CausalSurvivalScores scores(grid, target, horizon);
+
+  return grf::causal_survival_expected_outcomes_oob(forest, data, failure_times, prediction_type, scores,
+                                                    num_threads);
+}
+
+// [[Rcpp::export]]
+Rcpp::List causal_survival_numerators_oob(const Rcpp::List& survival_forest_object,
+                                          const Rcpp::NumericMatrix& survival_train_matrix,
+                                          const std::vector<double>& survival_failure_times,
+                                          const Rcpp::List& censor_forest_object,
+                                          const Rcpp::NumericMatrix& censor_train_matrix,
+                                          const std::vector<double>& censor_failure_times,
+                                          size_t outcome_index,
+                                          size_t censor_index,
+                                          size_t sample_weight_index,
+                                          bool use_sample_weights,
+                                          int prediction_type,
+                                          const std::vector<double>& grid,
+                                          int target,
+                                          double horizon,
+                                          const std::vector<double>& Y_hat,
+                                          const std::vector<double>& W_centered,
+                                          const std::vector<double>& censor,
+                                          const std::vector<double>& f_Y,
+                                          const std::vector<size_t>& Y_index,
+                                          unsigned int num_threads) {
+  Data survival_data = RcppUtilities::convert_data(survival_train_matrix);
+  Data censor_data = RcppUtilities::convert_data(censor_train_matrix);
+  for (Data* data : {&survival_data, &censor_data}) {
+    data->set_outcome_index(outcome_index);
+    data->set_censor_index(censor_index);
+    if (use_sample_weights) {
+      data->set_weight_index(sample_weight_index);
+    }
+  }
+
+  Forest survival_forest = RcppUtilities::deserialize_forest(survival_forest_object);
+  Forest censor_forest = RcppUtilities::deserialize_forest(censor_forest_object);
+  survival_data.set_single_precision(survival_forest.is_single_precision());
+  censor_data.set_single_precision(censor_forest.is_single_precision());
+  CausalSurvivalScores scores(grid, target, horizon);
+
+  // The event time indices are 1-based in R.
+  std::vector<size_t> Y_index_zero_based(Y_index.size());
+  for (size_t sample = 0; sample < Y_index.size(); ++sample) {
+    Y_index_zero_based[sample] = Y_index[sample] - 1;
+  }
+
+  std::vector<double> numerators;
+  std::vector<double> C_Y_hat;
+  grf::causal_survival_numerators_oob(survival_forest, survival_data, survival_failure_times,
+                                      censor_forest, censor_data, censor_failure_times,
+                                      prediction_type, scores, Y_hat, W_centered, censor, f_Y,
+                                      Y_index_zero_based, num_threads, numerators, C_Y_hat);
+
+  Rcpp::List result;
+  result.push_back(numerators, "numerator");
+  result.push_back(C_Y_hat, "C.Y.hat");
+  return result;
+}
@@ -48,9 +48,11 @@ Rcpp::List multi_causal_train(const Rcpp::NumericMatrix& train_matrix,
                               std::vector<size_t> clusters,
                               unsigned int samples_per_cluster,
                               bool compute_oob_predictions,
+                              unsigned int max_bins,
                               unsigned int num_threads,
                               unsigned int seed,
-                              bool legacy_seed) {
+                              bool legacy_seed,
+                              bool single_precision) {
   size_t num_treatments = treatment_index.size();
   size_t num_outcomes = outcome_index.size();
   ForestTrainer trainer = multi_causal_trainer(num_treatments, num_outcomes, stabilize_splits, gradient_weights);
@@ -62,8 +64,9 @@ Rcpp::List multi_causal_train(const Rcpp::NumericMatrix& train_matrix,
     data.set_weight_index(sample_weight_index);
   }
 
+  data.set_single_precision(single_precision);
   ForestOptions options(num_trees, ci_group_size, sample_fraction, mtry, min_node_size, honesty,
-      honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, legacy_seed, clusters, samples_per_cluster);
+      honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, legacy_seed, clusters, samples_per_cluster, max_bins);
   Forest forest = trainer.train(data, options);
 
   std::vector<Prediction> predictions;
@@ -87,6 +90,7 @@ Rcpp::List multi_causal_predict(const Rcpp::List& forest_object,
   Data data = RcppUtilities::convert_data(test_matrix);
 
   Forest forest = RcppUtilities::deserialize_forest(forest_object);
+  data.set_single_precision(forest.is_single_precision());
 
   ForestPredictor predictor = multi_causal_predictor(num_threads, num_treatments, num_outcomes);
   std::vector<Prediction> predictions = predictor.predict(forest, train_data, data, estimate_variance);
@@ -105,6 +109,7 @@ Rcpp::List multi_causal_predict_oob(const Rcpp::List& forest_object,
   Data data = RcppUtilities::convert_data(train_matrix);
 
   Forest forest = RcppUtilities::deserialize_forest(forest_object);
+  data.set_single_precision(forest.is_single_precision());
 
   ForestPredictor predictor = multi_causal_predictor(num_threads, num_treatments, num_outcomes);
   std::vector<Prediction> predictions = predictor.predict_oob(forest, data, estimate_variance);
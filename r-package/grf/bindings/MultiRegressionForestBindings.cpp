@@ -44,9 +44,11 @@ Rcpp::List multi_regression_train(const Rcpp::NumericMatrix& train_matrix,
                                   std::vector<size_t>& clusters,
                                   unsigned int samples_per_cluster,
                                   bool compute_oob_predictions,
+                                  unsigned int max_bins,
                                   unsigned int num_threads,
                                   unsigned int seed,
-                                  bool legacy_seed) {
+                                  bool legacy_seed,
+                                  bool single_precision) {
   Data data = RcppUtilities::convert_data(train_matrix);
   data.set_outcome_index(outcome_index);
   if (use_sample_weights) {
@@ -54,8 +56,9 @@ Rcpp::List multi_regression_train(const Rcpp::NumericMatrix& train_matrix,
   }
 
   size_t ci_group_size = 1;
+  data.set_single_precision(single_precision);
   ForestOptions options(num_trees, ci_group_size, sample_fraction, mtry, min_node_size, honesty,
-      honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, legacy_seed, clusters, samples_per_cluster);
+      honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, legacy_seed, clusters, samples_per_cluster, max_bins);
   ForestTrainer trainer = multi_regression_trainer(data.get_num_outcomes());
   Forest forest = trainer.train(data, options);
 
@@ -78,6 +81,7 @@ Rcpp::List multi_regression_predict(const Rcpp::List& forest_object,
 
   Data data = RcppUtilities::convert_data(test_matrix);
   Forest forest = RcppUtilities::deserialize_forest(forest_object);
+  data.set_single_precision(forest.is_single_precision());
   bool estimate_variance = false;
   ForestPredictor predictor = multi_regression_predictor(num_threads, num_outcomes);
   std::vector<Prediction> predictions = predictor.predict(forest, train_data, data, estimate_variance);
@@ -93,6 +97,7 @@ Rcpp::List multi_regression_predict_oob(const Rcpp::List& forest_object,
   Data data = RcppUtilities::convert_data(train_matrix);
 
   Forest forest = RcppUtilities::deserialize_forest(forest_object);
+  data.set_single_precision(forest.is_single_precision());
   bool estimate_variance = false;
   ForestPredictor predictor = multi_regression_predictor(num_threads, num_outcomes);
   std::vector<Prediction> predictions = predictor.predict_oob(forest, data, estimate_variance);
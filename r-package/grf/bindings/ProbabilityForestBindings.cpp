@@ -46,9 +46,11 @@ Rcpp::List probability_train(const Rcpp::NumericMatrix& train_matrix,
                              const std::vector<size_t>& clusters,
                              unsigned int samples_per_cluster,
                              bool compute_oob_predictions,
+                             unsigned int max_bins,
                              int num_threads,
                              unsigned int seed,
-                             bool legacy_seed) {
+                             bool legacy_seed,
+                             bool single_precision) {
   ForestTrainer trainer = probability_trainer(num_classes);
 
   Data data = RcppUtilities::convert_data(train_matrix);
@@ -57,8 +59,9 @@ Rcpp::List probability_train(const Rcpp::NumericMatrix& train_matrix,
     data.set_weight_index(sample_weight_index);
   }
 
+  data.set_single_precision(single_precision);
   ForestOptions options(num_trees, ci_group_size, sample_fraction, mtry, min_node_size, honesty,
-      honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, legacy_seed, clusters, samples_per_cluster);
+      honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, legacy_seed, clusters, samples_per_cluster, max_bins);
   Forest forest = trainer.train(data, options);
 
   std::vector<Prediction> predictions;
@@ -83,6 +86,7 @@ Rcpp::List probability_predict(const Rcpp::List& forest_object,
   train_data.set_outcome_index(outcome_index);
 
   Forest forest = RcppUtilities::deserialize_forest(forest_object);
+  data.set_single_precision(forest.is_single_precision());
 
   ForestPredictor predictor = probability_predictor(num_threads, num_classes);
   std::vector<Prediction> predictions = predictor.predict(forest, train_data, data, estimate_variance);
@@ -101,6 +105,7 @@ Rcpp::List probability_predict_oob(const Rcpp::List& forest_object,
   data.set_outcome_index(outcome_index);
 
   Forest forest = RcppUtilities::deserialize_forest(forest_object);
+  data.set_single_precision(forest.is_single_precision());
 
   ForestPredictor predictor = probability_predictor(num_threads, num_classes);
   std::vector<Prediction> predictions = predictor.predict_oob(forest, data, estimate_variance);
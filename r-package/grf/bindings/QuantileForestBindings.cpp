@@ -27,6 +27,17 @@
 
 using namespace grf;
 
+// Forests trained with `fast_predict` store the sorted outcomes of each leaf and select
+// the quantiles from them. Other forests predict from the training data.
+ForestPredictor quantile_forest_predictor(const Forest& forest,
+                                          unsigned int num_threads,
+                                          const std::vector<double>& quantiles) {
+  if (forest.has_sparse_prediction_values()) {
+    return optimized_quantile_predictor(num_threads, quantiles);
+  }
+  return quantile_predictor(num_threads, quantiles);
+}
+
 // [[Rcpp::export]]
 Rcpp::List quantile_train(std::vector<double> quantiles,
                           bool regression_splitting,
@@ -45,23 +56,27 @@ Rcpp::List quantile_train(std::vector<double> quantiles,
                           std::vector<size_t> clusters,
                           unsigned int samples_per_cluster,
                           bool compute_oob_predictions,
+                          bool fast_predict,
+                          unsigned int max_bins,
                           int num_threads,
                           unsigned int seed,
-                          bool legacy_seed) {
+                          bool legacy_seed,
+                          bool single_precision) {
   ForestTrainer trainer = regression_splitting
       ? regression_trainer()
-      : quantile_trainer(quantiles);
+      : fast_predict ? optimized_quantile_trainer(quantiles) : quantile_trainer(quantiles);
 
   Data data = RcppUtilities::convert_data(train_matrix);
   data.set_outcome_index(outcome_index);
 
+  data.set_single_precision(single_precision);
   ForestOptions options(num_trees, ci_group_size, sample_fraction, mtry, min_node_size, honesty,
-      honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, legacy_seed, clusters, samples_per_cluster);
+      honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, legacy_seed, clusters, samples_per_cluster, max_bins);
   Forest forest = trainer.train(data, options);
 
   std::vector<Prediction> predictions;
   if (compute_oob_predictions) {
-    ForestPredictor predictor = quantile_predictor(num_threads, quantiles);
+    ForestPredictor predictor = quantile_forest_predictor(forest, num_threads, quantiles);
     predictions = predictor.predict_oob(forest, data, false);
   }
 
@@ -80,8 +95,9 @@ Rcpp::NumericMatrix quantile_predict(const Rcpp::List& forest_object,
   train_data.set_outcome_index(outcome_index);
 
   Forest forest = RcppUtilities::deserialize_forest(forest_object);
+  data.set_single_precision(forest.is_single_precision());
 
-  ForestPredictor predictor = quantile_predictor(num_threads, quantiles);
+  ForestPredictor predictor = quantile_forest_predictor(forest, num_threads, quantiles);
   std::vector<Prediction> predictions = predictor.predict(forest, train_data, data, false);
   Rcpp::NumericMatrix result = RcppUtilities::create_prediction_matrix(predictions);
 
@@ -98,8 +114,9 @@ Rcpp::NumericMatrix quantile_predict_oob(const Rcpp::List& forest_object,
   data.set_outcome_index(outcome_index);
 
   Forest forest = RcppUtilities::deserialize_forest(forest_object);
+  data.set_single_precision(forest.is_single_precision());
 
-  ForestPredictor predictor = quantile_predictor(num_threads, quantiles);
+  ForestPredictor predictor = quantile_forest_predictor(forest, num_threads, quantiles);
   std::vector<Prediction> predictions = predictor.predict_oob(forest, data, false);
   Rcpp::NumericMatrix result = RcppUtilities::create_prediction_matrix(predictions);
 
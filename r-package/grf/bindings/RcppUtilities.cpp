@@ -18,6 +18,7 @@
  #-------------------------------------------------------------------------------*/
 
 #include <Rcpp.h>
+#include <algorithm>
 
 #include "commons/Data.h"
 #include "forest/ForestOptions.h"
@@ -37,6 +38,9 @@ Rcpp::List RcppUtilities::create_forest_object(Forest& forest,
 Forest RcppUtilities::deserialize_forest(const Rcpp::List& forest_object) {
   size_t ci_group_size = forest_object["_ci_group_size"];
   size_t num_variables = forest_object["_num_variables"];
+  // Forests saved before the precision was recorded were trained in double precision.
+  bool single_precision = forest_object.containsElementNamed("_single_precision")
+      && Rcpp::as<bool>(forest_object["_single_precision"]);
 
   size_t num_trees = forest_object["_num_trees"];
   std::vector<std::unique_ptr<Tree>> trees;
@@ -52,20 +56,32 @@ Forest RcppUtilities::deserialize_forest(const Rcpp::List& forest_object) {
 
   Rcpp::List prediction_values = forest_object["_pv_values"];
   size_t num_types = forest_object["_pv_num_types"];
+  // Only forests trained with a sparse prediction strategy have sparse prediction values.
+  bool has_sparse_values = forest_object.containsElementNamed("_spv_values");
+  Rcpp::List sparse_prediction_values;
+  size_t entry_length = 0;
+  if (has_sparse_values) {
+    sparse_prediction_values = forest_object["_spv_values"];
+    entry_length = forest_object["_spv_entry_length"];
+  }
 
   for (size_t t = 0; t < num_trees; t++) {
     trees.emplace_back(new Tree(
                          root_nodes.at(t),
                          child_nodes.at(t),
-                         leaf_samples.at(t),
+                         Rcpp::as<std::vector<std::vector<size_t>>>(leaf_samples.at(t)),
                          split_vars.at(t),
                          split_values.at(t),
                          drawn_samples.at(t),
                          send_missing_left.at(t),
                          PredictionValues(prediction_values.at(t), num_types)));
+    if (has_sparse_values) {
+      trees.back()->set_sparse_prediction_values(SparsePredictionValues(
+        Rcpp::as<std::vector<std::vector<double>>>(sparse_prediction_values.at(t)), entry_length));
+    }
   }
 
-  return Forest(trees, num_variables, ci_group_size);
+  return Forest(trees, num_variables, ci_group_size, single_precision);
 }
 
 Rcpp::List RcppUtilities::serialize_forest(Forest& forest) {
@@ -73,6 +89,7 @@ Rcpp::List RcppUtilities::serialize_forest(Forest& forest) {
 
   result.push_back(forest.get_ci_group_size(), "_ci_group_size");
   result.push_back(forest.get_num_variables(), "_num_variables");
+  result.push_back(forest.is_single_precision(), "_single_precision");
 
   size_t num_trees = forest.get_trees().size();
   result.push_back(num_trees, "_num_trees");
@@ -86,13 +103,15 @@ Rcpp::List RcppUtilities::serialize_forest(Forest& forest) {
   Rcpp::List send_missing_left(num_trees);
   Rcpp::List prediction_values(num_trees);
   size_t num_types = 0;
+  Rcpp::List sparse_prediction_values(num_trees);
+  size_t entry_length = 0;
 
   for (size_t t = 0; t < num_trees; t++) {
     // Destructively iterate over the forest by moving the unique_ptr to each tree.
     std::unique_ptr<Tree> tree = std::move(forest.get_trees_().at(t));
     root_nodes[t] = tree->get_root_node();
     child_nodes[t] = tree->get_child_nodes();
-    leaf_samples[t] = tree->get_leaf_samples();
+    leaf_samples[t] = tree->get_leaf_samples().get_samples_by_node();
     split_vars[t] = tree->get_split_vars();
     split_values[t] = tree->get_split_values();
     drawn_samples[t] = tree->get_drawn_samples();
@@ -100,6 +119,10 @@ Rcpp::List RcppUtilities::serialize_forest(Forest& forest) {
 
     prediction_values[t] = tree->get_prediction_values().get_all_values();
     num_types = tree->get_prediction_values().get_num_types();
+
+    const SparsePredictionValues& tree_sparse_values = tree->get_sparse_prediction_values();
+    sparse_prediction_values[t] = tree_sparse_values.get_all_values();
+    entry_length = std::max(entry_length, tree_sparse_values.get_entry_length());
   }
 
   result.push_back(root_nodes, "_root_nodes");
@@ -111,6 +134,10 @@ Rcpp::List RcppUtilities::serialize_forest(Forest& forest) {
   result.push_back(send_missing_left, "_send_missing_left");
   result.push_back(prediction_values, "_pv_values");
   result.push_back(num_types, "_pv_num_types");
+  if (entry_length > 0) {
+    result.push_back(sparse_prediction_values, "_spv_values");
+    result.push_back(entry_length, "_spv_entry_length");
+  }
   return result;
 };
 
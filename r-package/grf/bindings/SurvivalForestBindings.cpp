@@ -27,6 +27,18 @@
 
 using namespace grf;
 
+// Forests trained with `fast_predict` store the event counts of each leaf and predict from them,
+// with the same estimates up to rounding. Other forests predict from the training data.
+ForestPredictor survival_forest_predictor(const Forest& forest,
+                                          unsigned int num_threads,
+                                          size_t num_failures,
+                                          int prediction_type) {
+  if (forest.has_sparse_prediction_values()) {
+    return optimized_survival_predictor(num_threads, num_failures, prediction_type);
+  }
+  return survival_predictor(num_threads, num_failures, prediction_type);
+}
+
 // [[Rcpp::export]]
 Rcpp::List survival_train(const Rcpp::NumericMatrix& train_matrix,
                           size_t outcome_index,
@@ -47,10 +59,15 @@ Rcpp::List survival_train(const Rcpp::NumericMatrix& train_matrix,
                           bool compute_oob_predictions,
                           int prediction_type,
                           bool fast_logrank,
+                          bool fast_predict,
+                          unsigned int max_bins,
                           unsigned int num_threads,
                           unsigned int seed,
-                          bool legacy_seed) {
-  ForestTrainer trainer = survival_trainer(fast_logrank);
+                          bool legacy_seed,
+                          bool single_precision) {
+  ForestTrainer trainer = fast_predict
+      ? optimized_survival_trainer(fast_logrank, num_failures)
+      : survival_trainer(fast_logrank);
 
   Data data = RcppUtilities::convert_data(train_matrix);
   data.set_outcome_index(outcome_index);
@@ -61,13 +78,14 @@ Rcpp::List survival_train(const Rcpp::NumericMatrix& train_matrix,
 
   size_t ci_group_size = 1;
   size_t imbalance_penalty = 0;
+  data.set_single_precision(single_precision);
   ForestOptions options(num_trees, ci_group_size, sample_fraction, mtry, min_node_size, honesty,
-      honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, legacy_seed, clusters, samples_per_cluster);
+      honesty_fraction, honesty_prune_leaves, alpha, imbalance_penalty, num_threads, seed, legacy_seed, clusters, samples_per_cluster, max_bins);
   Forest forest = trainer.train(data, options);
 
   std::vector<Prediction> predictions;
   if (compute_oob_predictions) {
-    ForestPredictor predictor = survival_predictor(num_threads, num_failures, prediction_type);
+    ForestPredictor predictor = survival_forest_predictor(forest, num_threads, num_failures, prediction_type);
     predictions = predictor.predict_oob(forest, data, false);
   }
 
@@ -94,9 +112,10 @@ Rcpp::List survival_predict(const Rcpp::List& forest_object,
 
   Data data = RcppUtilities::convert_data(test_matrix);
   Forest forest = RcppUtilities::deserialize_forest(forest_object);
+  data.set_single_precision(forest.is_single_precision());
 
   bool estimate_variance = false;
-  ForestPredictor predictor = survival_predictor(num_threads, num_failures, prediction_type);
+  ForestPredictor predictor = survival_forest_predictor(forest, num_threads, num_failures, prediction_type);
   std::vector<Prediction> predictions = predictor.predict(forest, train_data, data, estimate_variance);
 
   return RcppUtilities::create_prediction_object(predictions);
@@ -120,9 +139,10 @@ Rcpp::List survival_predict_oob(const Rcpp::List& forest_object,
   }
 
   Forest forest = RcppUtilities::deserialize_forest(forest_object);
+  data.set_single_precision(forest.is_single_precision());
 
   bool estimate_variance = false;
-  ForestPredictor predictor = survival_predictor(num_threads, num_failures, prediction_type);
+  ForestPredictor predictor = survival_forest_predictor(forest, num_threads, num_failures, prediction_type);
   std::vector<Prediction> predictions = predictor.predict_oob(forest, data, estimate_variance);
 
   Rcpp::List result = RcppUtilities::create_prediction_object(predictions);